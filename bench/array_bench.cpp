@@ -0,0 +1,167 @@
+#include "Gimbal.h"
+#include "GimbalArray.h"
+#include "GimbalLog.h"
+#include "PWMControllerSim.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Per-frame cost of GimbalArray versus one Gimbal per head
+ *
+ * For 2 to 64 axes, moves every axis to a new random angle each frame and
+ * times a full frame: one GimbalArray::update() (single batched controller
+ * call) against N/2 independent Gimbal::setTipAngle() calls on the same
+ * PWMControllerSim backend.
+ *
+ * Usage: array_bench [--frames N] [--latency-ns N] [--json PATH]
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t AXIS_COUNTS[] = {2, 4, 8, 16, 32, 64};
+constexpr size_t PATTERN_SIZE = 1024;
+
+struct Row {
+    size_t axes;
+    double array_ns;      // Per frame
+    double gimbals_ns;    // Per frame
+};
+
+void discardLog(const LogRecord&, void*) {}
+
+std::vector<float> makePattern(size_t axes) {
+    std::vector<float> angles(PATTERN_SIZE * axes);
+    uint32_t lcg = 12345;
+    for (auto& angle : angles) {
+        lcg = lcg * 1664525u + 1013904223u;
+        angle = static_cast<float>(lcg >> 8) / 16777216.0f * 180.0f - 90.0f;
+    }
+    return angles;
+}
+
+double timeArray(size_t axes, uint64_t frames, uint32_t latency_ns, const std::vector<float>& angles) {
+    auto pwm = std::make_shared<PWMControllerSim>();
+    GimbalArray array(pwm);
+    for (size_t head = 0; head < axes / 2; ++head) {
+        array.addHead(static_cast<uint32_t>(2 * head), static_cast<uint32_t>(2 * head + 1));
+    }
+    array.setDeadzone(0.0f);
+    if (!array.init()) {
+        return 0.0;
+    }
+    pwm->setWriteLatency(latency_ns);
+
+    for (uint64_t frame = 0; frame < PATTERN_SIZE; ++frame) {
+        array.setTargets(0, &angles[frame * axes], axes);
+        array.update();
+    }
+
+    auto t0 = Clock::now();
+    for (uint64_t frame = 0; frame < frames; ++frame) {
+        array.setTargets(0, &angles[(frame % PATTERN_SIZE) * axes], axes);
+        array.update();
+    }
+    auto t1 = Clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(frames);
+}
+
+double timeGimbals(size_t axes, uint64_t frames, uint32_t latency_ns, const std::vector<float>& angles) {
+    auto pwm = std::make_shared<PWMControllerSim>();
+    std::vector<std::unique_ptr<Gimbal>> gimbals;
+    for (size_t head = 0; head < axes / 2; ++head) {
+        gimbals.emplace_back(new Gimbal(pwm, static_cast<uint32_t>(2 * head), static_cast<uint32_t>(2 * head + 1)));
+        gimbals.back()->setDeadzone(0.0f);
+        if (!gimbals.back()->init()) {
+            return 0.0;
+        }
+    }
+    pwm->setWriteLatency(latency_ns);
+
+    for (uint64_t frame = 0; frame < PATTERN_SIZE; ++frame) {
+        const float* row = &angles[frame * axes];
+        for (size_t head = 0; head < gimbals.size(); ++head) {
+            gimbals[head]->setTipAngle(row[2 * head], row[2 * head + 1]);
+        }
+    }
+
+    auto t0 = Clock::now();
+    for (uint64_t frame = 0; frame < frames; ++frame) {
+        const float* row = &angles[(frame % PATTERN_SIZE) * axes];
+        for (size_t head = 0; head < gimbals.size(); ++head) {
+            gimbals[head]->setTipAngle(row[2 * head], row[2 * head + 1]);
+        }
+    }
+    auto t1 = Clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(frames);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t frames = 200000;
+    uint32_t latency_ns = 0;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--frames") == 0 && value) {
+            frames = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--latency-ns") == 0 && value) {
+            latency_ns = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--frames N] [--latency-ns N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (frames == 0) {
+        return 2;
+    }
+
+    GimbalLog::setSink(discardLog);
+
+    std::vector<Row> rows;
+    for (size_t axes : AXIS_COUNTS) {
+        std::vector<float> angles = makePattern(axes);
+        Row row;
+        row.axes = axes;
+        row.array_ns = timeArray(axes, frames, latency_ns, angles);
+        row.gimbals_ns = timeGimbals(axes, frames, latency_ns, angles);
+        rows.push_back(row);
+    }
+
+    std::fprintf(stderr, "=== array_bench (%llu frames, %u ns injected latency) ===\n",
+                 static_cast<unsigned long long>(frames), latency_ns);
+    std::fprintf(stderr, "%6s %16s %16s %14s\n", "axes", "array ns/frame", "gimbals ns/frame", "array ns/axis");
+    for (const Row& row : rows) {
+        std::fprintf(stderr, "%6zu %16.1f %16.1f %14.2f\n", row.axes, row.array_ns, row.gimbals_ns,
+                     row.array_ns / static_cast<double>(row.axes));
+    }
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"array_bench\",\n  \"frames\": %llu,\n  \"injected_latency_ns\": %u,\n  \"results\": [\n",
+                 static_cast<unsigned long long>(frames), latency_ns);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        std::fprintf(out, "    {\"axes\": %zu, \"array_ns_per_frame\": %.1f, \"gimbals_ns_per_frame\": %.1f}%s\n",
+                     rows[i].axes, rows[i].array_ns, rows[i].gimbals_ns, i + 1 < rows.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
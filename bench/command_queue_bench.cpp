@@ -0,0 +1,253 @@
+#include "CommandQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief CommandQueue semantics and contention
+ *
+ * 1. Rules, on one thread: the newest timestamp wins a drain, older and
+ *    over-age commands are dropped as stale, advance() drops what it
+ *    covers, a full queue evicts its oldest entry, and recordApplied()
+ *    fills in the latency statistics.
+ * 2. Contention: --producers threads submit --commands setpoints each,
+ *    stamped from one shared counter, while a consumer takes the latest
+ *    at --rate Hz, so the queue overflows and producers evict while the
+ *    consumer pops. Taken timestamps must only grow, every command must
+ *    arrive untorn, the last one taken must be the newest submitted, and
+ *    submitted = applied + superseded + stale.
+ *
+ * Usage: command_queue_bench [--producers N] [--commands N] [--rate HZ] [--json PATH]
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool check(const char* what, bool ok) {
+    std::fprintf(stderr, "%-40s %s\n", what, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+bool accounted(const CommandQueueStats& stats) {
+    return stats.submitted == stats.applied + stats.superseded + stats.stale;
+}
+
+/// Take the latest command and apply it at once, as the control loop does
+bool takeAndApply(CommandQueue& queue, uint64_t now_ns, GimbalCommand& command) {
+    if (!queue.takeLatest(now_ns, command)) {
+        return false;
+    }
+    queue.recordApplied(command, CommandQueue::now());
+    return true;
+}
+
+bool checkRules() {
+    bool ok = true;
+    GimbalCommand command{};
+
+    CommandQueue queue;
+    queue.submit(1.0f, 0.0f, 100);
+    queue.submit(3.0f, 0.0f, 300);
+    queue.submit(2.0f, 0.0f, 200);
+    ok &= check("newest timestamp wins a drain",
+                takeAndApply(queue, 0, command) && command.timestamp_ns == 300 && command.pan_angle == 3.0f &&
+                    queue.getStats().superseded == 2);
+    queue.submit(4.0f, 0.0f, 250);
+    ok &= check("older than the last taken is stale", !takeAndApply(queue, 0, command) && queue.getStats().stale == 1);
+    queue.advance(500);
+    queue.submit(5.0f, 0.0f, 400);
+    queue.submit(6.0f, 0.0f, 600);
+    ok &= check("advance() drops what it covers",
+                takeAndApply(queue, 0, command) && command.timestamp_ns == 600 && queue.getStats().stale == 2);
+    ok &= check("counters add up", accounted(queue.getStats()));
+
+    const uint64_t max_age_ns = 1000000;
+    CommandQueue aged(max_age_ns);
+    const uint64_t now = CommandQueue::now();
+    aged.submit(1.0f, 0.0f, now - 2 * max_age_ns);
+    ok &= check("over-age command is stale", !takeAndApply(aged, now, command) && aged.getStats().stale == 1);
+    aged.submit(2.0f, 0.0f, now - max_age_ns / 2);
+    ok &= check("command within the age limit is taken", takeAndApply(aged, now, command) && command.pan_angle == 2.0f);
+
+    CommandQueue full;
+    const uint64_t overflow = 8;
+    for (uint64_t i = 1; i <= CommandQueue::CAPACITY + overflow; ++i) {
+        full.submit(static_cast<float>(i), 0.0f, i);
+    }
+    CommandQueueStats stats = full.getStats();
+    ok &= check("full queue evicts the oldest", stats.superseded == overflow);
+    ok &= check("newest survives the eviction",
+                takeAndApply(full, 0, command) && command.timestamp_ns == CommandQueue::CAPACITY + overflow &&
+                    !full.takeLatest(0, command));
+    ok &= check("counters add up after eviction", accounted(full.getStats()));
+
+    CommandQueue timed;
+    GimbalCommand applied{};
+    applied.enqueue_ns = 1000;
+    applied.timestamp_ns = 500;
+    timed.recordApplied(applied, 3000);
+    applied.enqueue_ns = 2000;
+    applied.timestamp_ns = 1500;
+    timed.recordApplied(applied, 8000);
+    stats = timed.getStats();
+    ok &= check("latency statistics",
+                stats.applied == 2 && stats.last_latency_ns == 6000 && stats.max_latency_ns == 6000 &&
+                    stats.mean_latency_ns == 4000.0 && stats.last_age_ns == 6500);
+    timed.resetStats();
+    stats = timed.getStats();
+    ok &= check("resetStats() clears them", stats.applied == 0 && stats.max_latency_ns == 0);
+    return ok;
+}
+
+struct ContentionResult {
+    uint64_t taken;
+    uint64_t regressions;
+    uint64_t torn;
+    uint64_t last_taken;
+    double submit_ns;
+    CommandQueueStats stats;
+};
+
+ContentionResult runContention(uint32_t producers, uint64_t commands, double rate) {
+    CommandQueue queue;
+    ContentionResult result{};
+    std::atomic<uint64_t> ticket{0};
+    std::atomic<uint32_t> running{producers};
+    std::atomic<uint64_t> submit_ns{0};
+
+    // The pan angle repeats the timestamp's low bits, so a torn cell shows
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            auto t0 = Clock::now();
+            for (uint64_t i = 0; i < commands; ++i) {
+                uint64_t stamp = ticket.fetch_add(1, std::memory_order_relaxed) + 1;
+                queue.submit(static_cast<float>(stamp & 0xFFFF), static_cast<float>(p), stamp);
+            }
+            auto t1 = Clock::now();
+            submit_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration<double, std::nano>(t1 - t0).count()),
+                                std::memory_order_relaxed);
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    auto next = Clock::now();
+    GimbalCommand command{};
+    for (;;) {
+        bool done = running.load(std::memory_order_acquire) == 0;
+        // After the producers finish, one last drain takes what is left
+        if (takeAndApply(queue, 0, command)) {
+            ++result.taken;
+            if (command.timestamp_ns <= result.last_taken) {
+                ++result.regressions;
+            }
+            if (command.pan_angle != static_cast<float>(command.timestamp_ns & 0xFFFF) ||
+                command.tilt_angle >= static_cast<float>(producers)) {
+                ++result.torn;
+            }
+            result.last_taken = command.timestamp_ns;
+        }
+        if (done) {
+            break;
+        }
+        next += tick;
+        std::this_thread::sleep_until(next);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    result.submit_ns = static_cast<double>(submit_ns.load()) / static_cast<double>(producers * commands);
+    result.stats = queue.getStats();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t producers = 4;
+    uint64_t commands = 200000;
+    double rate = 1000.0;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--producers") == 0 && value) {
+            producers = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argv[i], "--commands") == 0 && value) {
+            commands = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--rate") == 0 && value) {
+            rate = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--producers N] [--commands N] [--rate HZ] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    // Fewer producers than slots: the newest command cannot be evicted by the stragglers
+    if (producers == 0 || producers >= CommandQueue::CAPACITY || commands == 0 || rate <= 0.0) {
+        return 2;
+    }
+
+    std::fprintf(stderr, "=== command_queue_bench (%zu slots) ===\n", CommandQueue::CAPACITY);
+    bool ok = checkRules();
+
+    ContentionResult contention = runContention(producers, commands, rate);
+    const CommandQueueStats& stats = contention.stats;
+    const uint64_t total = static_cast<uint64_t>(producers) * commands;
+    ok &= check("every submit counted", stats.submitted == total);
+    ok &= check("taken timestamps only grow", contention.regressions == 0);
+    ok &= check("no torn command", contention.torn == 0);
+    ok &= check("newest submitted is the last taken", contention.last_taken == total);
+    ok &= check("submitted = applied + superseded + stale", accounted(stats) && stats.applied == contention.taken);
+    ok &= check("latency statistics consistent",
+                stats.max_latency_ns >= stats.last_latency_ns &&
+                    stats.mean_latency_ns <= static_cast<double>(stats.max_latency_ns));
+
+    std::fprintf(stderr, "%u producers x %llu commands, consumer at %.0f Hz\n", producers,
+                 static_cast<unsigned long long>(commands), rate);
+    std::fprintf(stderr, "submit:  %.1f ns (contended)\n", contention.submit_ns);
+    std::fprintf(stderr, "applied: %llu, superseded: %llu, stale: %llu\n",
+                 static_cast<unsigned long long>(stats.applied), static_cast<unsigned long long>(stats.superseded),
+                 static_cast<unsigned long long>(stats.stale));
+    std::fprintf(stderr, "latency: mean %.1f us, max %.1f us\n", stats.mean_latency_ns / 1e3,
+                 static_cast<double>(stats.max_latency_ns) / 1e3);
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"command_queue_bench\",\n"
+                 "  \"producers\": %u,\n"
+                 "  \"commands_per_producer\": %llu,\n"
+                 "  \"rate_hz\": %.0f,\n"
+                 "  \"submit_ns\": %.3f,\n"
+                 "  \"applied\": %llu,\n"
+                 "  \"superseded\": %llu,\n"
+                 "  \"stale\": %llu,\n"
+                 "  \"mean_latency_ns\": %.1f,\n"
+                 "  \"max_latency_ns\": %llu,\n"
+                 "  \"checks_passed\": %s\n"
+                 "}\n",
+                 producers, static_cast<unsigned long long>(commands), rate, contention.submit_ns,
+                 static_cast<unsigned long long>(stats.applied), static_cast<unsigned long long>(stats.superseded),
+                 static_cast<unsigned long long>(stats.stale), stats.mean_latency_ns,
+                 static_cast<unsigned long long>(stats.max_latency_ns), ok ? "true" : "false");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include "DualCoreGimbal.h"
+#include "Gimbal.h"
+#include "GimbalLog.h"
+#include "InterCoreRing.h"
+#include "PWMControllerSim.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief Host run of the Pico dual-core runtime (InterCoreRing + DualCoreGimbal)
+ *
+ * 1. Ring transfer: a producer and a consumer thread move N commands
+ *    through an InterCoreRing of GIMBAL_DUAL_CORE_RING_CAPACITY slots; every
+ *    command is checked for loss, reordering and tearing.
+ * 2. Runtime: DualCoreGimbal drives a PWMControllerSim gimbal at --rate Hz
+ *    on its own thread while the main thread produces targets five times
+ *    faster, as core0 would; reports the loop's counters.
+ *
+ * Usage: dual_core_bench [--items N] [--rate HZ] [--duration S] [--json PATH]
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Ring = InterCoreRing<CoreCommand, GIMBAL_DUAL_CORE_RING_CAPACITY>;
+
+/// Failed attempts before a thread sleeps instead of spinning
+constexpr uint32_t SPINS_BEFORE_SLEEP = 1000;
+
+/// Wait for the other side; cores spin, but threads may share one CPU
+void backoff(uint32_t& spins) {
+    if (++spins < SPINS_BEFORE_SLEEP) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        spins = 0;
+    }
+}
+
+struct RingResult {
+    double ns_per_pair;    // push + pop on one thread
+    double ns_per_item;    // across two threads
+    uint64_t errors;
+    uint64_t full;
+};
+
+RingResult runRing(uint64_t items) {
+    Ring ring;
+    RingResult result{};
+
+    // Uncontended cost: fill the ring, then drain it
+    CoreCommand scratch{};
+    uint64_t pairs = 0;
+    auto s0 = Clock::now();
+    while (pairs < items) {
+        for (size_t i = 0; i < Ring::capacity(); ++i) {
+            scratch.sequence = static_cast<uint32_t>(i);
+            ring.push(scratch);
+        }
+        for (size_t i = 0; i < Ring::capacity(); ++i) {
+            ring.pop(scratch);
+            asm volatile("" : : "r"(scratch.sequence) : "memory");
+        }
+        pairs += Ring::capacity();
+    }
+    auto s1 = Clock::now();
+    result.ns_per_pair = std::chrono::duration<double, std::nano>(s1 - s0).count() / static_cast<double>(pairs);
+
+    uint64_t errors = 0;
+    std::thread consumer([&ring, items, &errors]() {
+        uint32_t expected = 1;
+        uint32_t spins = 0;
+        CoreCommand command;
+        for (uint64_t received = 0; received < items;) {
+            if (!ring.pop(command)) {
+                backoff(spins);
+                continue;
+            }
+            spins = 0;
+            // Every field derives from the sequence: a torn or stale slot shows up here
+            if (command.sequence != expected || command.pan_angle != static_cast<float>(expected & 0xFFFF) ||
+                command.tilt_angle != -static_cast<float>(expected & 0xFFFF) ||
+                command.issued_us != ~expected) {
+                ++errors;
+            }
+            expected = command.sequence + 1;
+            ++received;
+        }
+    });
+
+    auto t0 = Clock::now();
+    uint32_t spins = 0;
+    for (uint64_t i = 1; i <= items; ++i) {
+        CoreCommand command;
+        command.sequence = static_cast<uint32_t>(i);
+        command.pan_angle = static_cast<float>(i & 0xFFFF);
+        command.tilt_angle = -static_cast<float>(i & 0xFFFF);
+        command.issued_us = ~command.sequence;
+        while (!ring.push(command)) {
+            ++result.full;
+            backoff(spins);
+        }
+        spins = 0;
+    }
+    consumer.join();
+    auto t1 = Clock::now();
+
+    result.ns_per_item = std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(items);
+    result.errors = errors;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t items = 1000000;
+    uint32_t rate_hz = 1000;
+    double duration_s = 2.0;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--items") == 0 && value) {
+            items = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--rate") == 0 && value) {
+            rate_hz = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argv[i], "--duration") == 0 && value) {
+            duration_s = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--items N] [--rate HZ] [--duration S] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (items == 0 || rate_hz == 0 || duration_s <= 0.0) {
+        return 2;
+    }
+
+    RingResult ring = runRing(items);
+
+    GimbalLog::startDrainThread();
+    Gimbal gimbal(std::make_shared<PWMControllerSim>(), 17, 27);
+    if (!gimbal.init()) {
+        std::fprintf(stderr, "Gimbal initialization failed\n");
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+    gimbal.setDeadzone(0.0f);
+
+    DualCoreGimbal runtime(gimbal, rate_hz);
+    if (!runtime.start()) {
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+    const auto producer_period = std::chrono::microseconds(1000000 / (5 * rate_hz));
+    uint32_t rejected = 0;
+    auto start = Clock::now();
+    auto next = start;
+    for (uint32_t tick = 0; Clock::now() - start < std::chrono::duration<double>(duration_s); ++tick) {
+        float t = static_cast<float>(tick) * 0.001f;
+        if (!runtime.setTarget(60.0f * std::sin(t), 20.0f * std::cos(t))) {
+            ++rejected;
+        }
+        next += producer_period;
+        std::this_thread::sleep_until(next);
+    }
+    runtime.stop();
+    DualCoreStats stats = runtime.getStats();
+    gimbal.shutdown();
+    GimbalLog::stopDrainThread();
+
+    std::fprintf(stderr, "=== dual_core_bench ===\n");
+    std::fprintf(stderr, "ring:     %.2f ns per push+pop (one thread)\n", ring.ns_per_pair);
+    std::fprintf(stderr, "          %llu items across threads, %.2f ns/item, %llu full spins, %llu errors\n",
+                 static_cast<unsigned long long>(items), ring.ns_per_item,
+                 static_cast<unsigned long long>(ring.full), static_cast<unsigned long long>(ring.errors));
+    std::fprintf(stderr, "runtime:  %u Hz for %.1f s, %u frames, %u commands (%u superseded, %u rejected)\n",
+                 rate_hz, duration_s, stats.frames, stats.commands, stats.superseded, stats.ring_full);
+    std::fprintf(stderr, "          updates %u, failures %u, missed frames %u\n",
+                 stats.updates, stats.failures, stats.missed_frames);
+    std::fprintf(stderr, "          max late %u us, max setTarget->write %u us\n",
+                 stats.max_late_us, stats.max_latency_us);
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"dual_core_bench\",\n"
+                 "  \"ring\": {\"ns_per_pair\": %.3f, \"items\": %llu, \"ns_per_item\": %.3f, \"full_spins\": %llu, \"errors\": %llu},\n"
+                 "  \"runtime\": {\"rate_hz\": %u, \"duration_s\": %.3f, \"frames\": %u, \"commands\": %u,"
+                 " \"superseded\": %u, \"ring_full\": %u, \"updates\": %u, \"failures\": %u,"
+                 " \"missed_frames\": %u, \"max_late_us\": %u, \"max_latency_us\": %u}\n"
+                 "}\n",
+                 ring.ns_per_pair, static_cast<unsigned long long>(items), ring.ns_per_item,
+                 static_cast<unsigned long long>(ring.full), static_cast<unsigned long long>(ring.errors),
+                 rate_hz, duration_s, stats.frames, stats.commands, stats.superseded, stats.ring_full,
+                 stats.updates, stats.failures, stats.missed_frames, stats.max_late_us, stats.max_latency_us);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return (ring.errors == 0 && rejected == stats.ring_full) ? 0 : 1;
+}
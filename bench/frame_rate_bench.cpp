@@ -0,0 +1,237 @@
+#include "BasicGimbal.h"
+#include "Gimbal.h"
+#include "GimbalBackends.h"
+#include "PWMControllerSim.h"
+#include "ServoProfile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Actuation delay of a command versus the servo frame rate
+ *
+ * A new pulse width only reaches a servo at the start of its next PWM
+ * frame, so a command arriving at a random time waits up to one period
+ * before the servo sees it. For each frame rate this bench drives a
+ * DIGITAL-profile Gimbal over PWMControllerSim and reports:
+ *
+ * - the frame wait of commands arriving at random times (mean, p99, max)
+ * - the host cost of one setTipAngle() at that rate
+ * - whether every write carried the axis' period
+ *
+ * It also checks the guards: an analog servo at 333 Hz, a rate above
+ * GIMBAL_PWM_MAX_FREQUENCY, a pulse range longer than the period (set
+ * before init() or reloaded after it) and different rates on one RP2040
+ * slice are rejected; mixed rates on separate slices are accepted.
+ *
+ * Usage: frame_rate_bench [--commands N] [--json PATH]
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t PAN_PIN = 17;
+constexpr uint32_t TILT_PIN = 27;
+constexpr uint32_t RATES[] = {50, 100, 200, GIMBAL_PWM_MAX_FREQUENCY};
+constexpr size_t RATE_COUNT = sizeof(RATES) / sizeof(RATES[0]);
+
+struct Row {
+    uint32_t rate_hz;
+    uint32_t period_us;
+    double mean_wait_ms;
+    double p99_wait_ms;
+    double max_wait_ms;
+    double ns_per_command;
+    bool periods_ok;
+};
+
+/// xorshift64: fast and reproducible
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+Row measure(uint32_t rate_hz, uint64_t commands) {
+    Row row{};
+    row.rate_hz = rate_hz;
+    row.period_us = 1000000 / rate_hz;
+
+    // Frame wait: frames start at multiples of the period, commands at
+    // uniformly random nanoseconds
+    const uint64_t period_ns = static_cast<uint64_t>(row.period_us) * 1000;
+    std::vector<uint32_t> waits(commands);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    double total = 0.0;
+    for (uint64_t i = 0; i < commands; ++i) {
+        uint64_t arrival_ns = nextRandom(state) % (period_ns * 1000);
+        waits[i] = static_cast<uint32_t>(period_ns - arrival_ns % period_ns);
+        total += waits[i];
+    }
+    std::vector<uint32_t> sorted = waits;
+    std::sort(sorted.begin(), sorted.end());
+    row.mean_wait_ms = total / static_cast<double>(commands) / 1e6;
+    row.p99_wait_ms = sorted[static_cast<size_t>(static_cast<double>(commands - 1) * 0.99)] / 1e6;
+    row.max_wait_ms = sorted.back() / 1e6;
+
+    // The real command path at this rate
+    auto pwm = std::make_shared<PWMControllerSim>(16);
+    Gimbal gimbal(pwm, PAN_PIN, TILT_PIN);
+    gimbal.setDeadzone(0.0f);
+    if (!gimbal.setFrameRate(rate_hz, rate_hz, ServoModel::DIGITAL, ServoModel::DIGITAL) || !gimbal.init()) {
+        return row;
+    }
+    std::vector<float> angles(1024);
+    for (size_t i = 0; i < angles.size(); ++i) {
+        angles[i] = static_cast<float>(nextRandom(state) % 17001) / 100.0f - 85.0f;
+    }
+    uint64_t failures = 0;
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < commands; ++i) {
+        failures += gimbal.setTipAngle(angles[i % angles.size()], angles[(i + 7) % angles.size()]) ? 0 : 1;
+    }
+    auto t1 = Clock::now();
+    row.ns_per_command = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) /
+                         static_cast<double>(commands);
+
+    row.periods_ok = failures == 0 && pwm->getRecordCount() > 0;
+    for (size_t i = 0; i < pwm->getRecordCount(); ++i) {
+        const SimCallRecord& record = pwm->getRecord(i);
+        if (record.type == SimCallType::SetPulseWidth && record.period_us != row.period_us) {
+            row.periods_ok = false;
+        }
+    }
+    gimbal.shutdown();
+    return row;
+}
+
+/// Each guard must refuse what it is meant to refuse and nothing else
+bool checkGuards() {
+    bool ok = true;
+    auto pwm = std::make_shared<PWMControllerSim>(16);
+
+    Gimbal analog(pwm, PAN_PIN, TILT_PIN);
+    ok &= !analog.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY, GIMBAL_PWM_MAX_FREQUENCY, ServoModel::MG90S,
+                               ServoModel::MG90S);
+    ok &= analog.getFrameRate() == Gimbal::PWM_FREQUENCY;
+    ok &= !analog.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY + 1, GIMBAL_PWM_MAX_FREQUENCY, ServoModel::DIGITAL,
+                               ServoModel::DIGITAL);
+
+    // Digital pan, analog tilt
+    ok &= static_cast<bool>(analog.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY, Gimbal::PWM_FREQUENCY,
+                                                ServoModel::DIGITAL, ServoModel::MG90S));
+    ok &= analog.getFrameRate() == GIMBAL_PWM_MAX_FREQUENCY;
+    ok &= static_cast<bool>(analog.init());
+    // Rates are fixed once the pins are claimed
+    ok &= !analog.setFrameRate(Gimbal::PWM_FREQUENCY, Gimbal::PWM_FREQUENCY, ServoModel::DIGITAL,
+                               ServoModel::DIGITAL);
+    analog.shutdown();
+
+    // A 3100 µs end stop does not fit a 333 Hz (3003 µs) frame, but fits 200 Hz
+    GimbalCalibration wide;
+    const CalibrationPoint long_points[] = {{-90.0f, 500.0f}, {0.0f, 1800.0f}, {90.0f, 3100.0f}};
+    wide.pan.setPoints(long_points, 3);
+    Gimbal stretched(pwm, PAN_PIN, TILT_PIN);
+    ok &= static_cast<bool>(stretched.setCalibration(wide));
+    ok &= !stretched.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY, GIMBAL_PWM_MAX_FREQUENCY, ServoModel::DIGITAL,
+                                  ServoModel::DIGITAL);
+    ok &= static_cast<bool>(stretched.setFrameRate(200, 200, ServoModel::DIGITAL, ServoModel::DIGITAL));
+
+    // ...nor can it be reloaded onto an axis already running at 333 Hz
+    Gimbal fast(pwm, PAN_PIN, TILT_PIN);
+    ok &= static_cast<bool>(fast.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY, GIMBAL_PWM_MAX_FREQUENCY,
+                                              ServoModel::DIGITAL, ServoModel::DIGITAL));
+    ok &= static_cast<bool>(fast.init());
+    GimbalStatus reload = fast.setCalibration(wide);
+    ok &= reload.error() == GimbalError::InvalidArgument && reload.pin() == PAN_PIN;
+    ok &= fast.getCalibration().pan.getPoint(fast.getCalibration().pan.getPointCount() - 1).pulse_us < 3003.0f;
+    ok &= static_cast<bool>(fast.setTipAngle(90.0f, 90.0f));
+    fast.shutdown();
+
+    // Backends: pulses must end inside the frame, frames no faster than the maximum
+    ok &= static_cast<bool>(pwm->initPin(5, GIMBAL_PWM_MAX_FREQUENCY));
+    ok &= !pwm->initPin(6, GIMBAL_PWM_MAX_FREQUENCY + 1);
+    ok &= !pwm->setPulseWidth(5, 3003, 3003);
+    ok &= static_cast<bool>(pwm->setPulseWidth(5, 2000, 3003));
+
+    // RP2040: GPIO 16/17 share slice 0, GPIO 16/18 do not
+    BasicGimbal<PicoServoBackend<16, 17>, MG90SStaticCalibration> shared_slice;
+    ok &= static_cast<bool>(shared_slice.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY, Gimbal::PWM_FREQUENCY));
+    ok &= !shared_slice.init();
+    BasicGimbal<PicoServoBackend<16, 18>, MG90SStaticCalibration> split_slices;
+    ok &= static_cast<bool>(split_slices.setFrameRate(GIMBAL_PWM_MAX_FREQUENCY, Gimbal::PWM_FREQUENCY));
+    ok &= static_cast<bool>(split_slices.init());
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t commands = 200000;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--commands") == 0 && value) {
+            commands = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--commands N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (commands == 0) {
+        return 2;
+    }
+
+    Row rows[RATE_COUNT];
+    bool periods_ok = true;
+    for (size_t i = 0; i < RATE_COUNT; ++i) {
+        rows[i] = measure(RATES[i], commands);
+        periods_ok &= rows[i].periods_ok;
+    }
+    bool guards_ok = checkGuards();
+    const double speedup = rows[0].mean_wait_ms / rows[RATE_COUNT - 1].mean_wait_ms;
+
+    std::fprintf(stderr, "=== frame_rate_bench (%llu commands per rate) ===\n", static_cast<unsigned long long>(commands));
+    std::fprintf(stderr, "%8s %10s %14s %13s %13s %12s\n", "rate Hz", "period us", "mean wait ms", "p99 wait ms",
+                 "max wait ms", "ns/command");
+    for (const Row& row : rows) {
+        std::fprintf(stderr, "%8u %10u %14.3f %13.3f %13.3f %12.1f\n", row.rate_hz, row.period_us, row.mean_wait_ms,
+                     row.p99_wait_ms, row.max_wait_ms, row.ns_per_command);
+    }
+    std::fprintf(stderr, "frame wait %u Hz vs %u Hz: %.2fx shorter\n", rows[RATE_COUNT - 1].rate_hz, rows[0].rate_hz,
+                 speedup);
+    std::fprintf(stderr, "periods %s, guards %s\n", periods_ok ? "ok" : "FAILED", guards_ok ? "ok" : "FAILED");
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"frame_rate_bench\",\n  \"commands\": %llu,\n  \"wait_speedup\": %.3f,\n"
+                      "  \"results\": [\n",
+                 static_cast<unsigned long long>(commands), speedup);
+    for (size_t i = 0; i < RATE_COUNT; ++i) {
+        std::fprintf(out,
+                     "    {\"rate_hz\": %u, \"period_us\": %u, \"mean_wait_ms\": %.4f, \"p99_wait_ms\": %.4f, "
+                     "\"max_wait_ms\": %.4f, \"ns_per_command\": %.2f}%s\n",
+                     rows[i].rate_hz, rows[i].period_us, rows[i].mean_wait_ms, rows[i].p99_wait_ms,
+                     rows[i].max_wait_ms, rows[i].ns_per_command, i + 1 < RATE_COUNT ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return (periods_ok && guards_ok) ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+#include "Gimbal.h"
+#include "GimbalLog.h"
+#include "PWMControllerSim.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Command latency / throughput benchmark for Gimbal::setTipAngle
+ *
+ * Drives a Gimbal backed by PWMControllerSim and times every setTipAngle
+ * call. A human-readable summary goes to stderr and a JSON report to stdout
+ * (or to the file given with --json) so runs can be compared in CI.
+ *
+ * Usage: gimbal_bench [--iterations N] [--warmup N] [--latency-ns N]
+ *                     [--failure-rate P] [--pattern random|track] [--json PATH]
+ *                     [--trace PATH]
+ *
+ * "random" jumps across the full range on every command; "track" follows a
+ * slow sweep sampled at a high rate, like a tracker running faster than the
+ * servo can resolve, where most commands quantize to unchanged pulses.
+ *
+ * --trace dumps the gimbal's telemetry ring (the last commands of the run)
+ * as Chrome trace JSON. The cost of appending one telemetry record is
+ * reported separately.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    uint64_t iterations = 2000000;
+    uint64_t warmup = 10000;
+    uint32_t latency_ns = 0;
+    double failure_rate = 0.0;
+    bool track_pattern = false;
+    const char* json_path = nullptr;
+    const char* trace_path = nullptr;
+};
+
+struct Percentiles {
+    double mean;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t p999;
+    uint32_t max;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--iterations N] [--warmup N] [--latency-ns N] "
+                 "[--failure-rate P] [--pattern random|track] [--json PATH] [--trace PATH]\n",
+                 program);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--iterations") == 0 && value) {
+            options.iterations = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--warmup") == 0 && value) {
+            options.warmup = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--latency-ns") == 0 && value) {
+            options.latency_ns = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(arg, "--failure-rate") == 0 && value) {
+            options.failure_rate = std::strtod(value, nullptr);
+        } else if (std::strcmp(arg, "--pattern") == 0 && value) {
+            if (std::strcmp(value, "track") == 0) {
+                options.track_pattern = true;
+            } else if (std::strcmp(value, "random") != 0) {
+                return false;
+            }
+        } else if (std::strcmp(arg, "--json") == 0 && value) {
+            options.json_path = value;
+        } else if (std::strcmp(arg, "--trace") == 0 && value) {
+            options.trace_path = value;
+        } else {
+            return false;
+        }
+        ++i;
+    }
+    return options.iterations > 0;
+}
+
+Percentiles computePercentiles(std::vector<uint32_t>& samples) {
+    Percentiles result{};
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (uint32_t s : samples) {
+        sum += s;
+    }
+    size_t n = samples.size();
+    auto at = [&](double q) { return samples[std::min(n - 1, static_cast<size_t>(q * (n - 1)))]; };
+    result.mean = sum / static_cast<double>(n);
+    result.p50 = at(0.50);
+    result.p90 = at(0.90);
+    result.p99 = at(0.99);
+    result.p999 = at(0.999);
+    result.max = samples[n - 1];
+    return result;
+}
+
+uint32_t measureTimerOverhead() {
+    std::vector<uint32_t> samples(10000);
+    for (auto& s : samples) {
+        auto t0 = Clock::now();
+        auto t1 = Clock::now();
+        s = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+/// Mean cost of TelemetryRing::record (the ring outlives the call: 32 KiB)
+double measureTelemetryRecord(uint64_t iterations) {
+    static TelemetryRing ring;
+    TelemetryRecord record{};
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        record.timestamp_ns = i;
+        record.pan_pulse_us = static_cast<uint32_t>(i);
+        ring.record(record);
+    }
+    auto t1 = Clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations);
+}
+
+void discardLog(const LogRecord&, void*) {}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    GimbalLog::setSink(discardLog);
+
+    auto pwm = std::make_shared<PWMControllerSim>();
+    Gimbal gimbal(pwm, 17, 27);
+    if (!gimbal.init()) {
+        std::fprintf(stderr, "Failed to initialize gimbal\n");
+        return 1;
+    }
+    pwm->setWriteLatency(options.latency_ns);
+    pwm->setFailureRate(options.failure_rate);
+
+    // Pre-generate the command pattern so generation is not timed
+    constexpr size_t PATTERN_SIZE = 4096;
+    std::vector<float> pan(PATTERN_SIZE);
+    std::vector<float> tilt(PATTERN_SIZE);
+    uint32_t lcg = 12345;
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        if (options.track_pattern) {
+            // One full sweep over the pattern: ~0.04 degrees per command
+            float phase = static_cast<float>(i) / static_cast<float>(PATTERN_SIZE);
+            pan[i] = 80.0f * std::sin(6.2831853f * phase);
+            tilt[i] = 40.0f * std::cos(6.2831853f * phase);
+            continue;
+        }
+        lcg = lcg * 1664525u + 1013904223u;
+        pan[i] = static_cast<float>(lcg >> 8) / 16777216.0f * 180.0f - 90.0f;
+        lcg = lcg * 1664525u + 1013904223u;
+        tilt[i] = static_cast<float>(lcg >> 8) / 16777216.0f * 180.0f - 90.0f;
+    }
+
+    for (uint64_t i = 0; i < options.warmup; ++i) {
+        gimbal.setTipAngle(pan[i % PATTERN_SIZE], tilt[i % PATTERN_SIZE]);
+    }
+
+    std::vector<uint32_t> latencies(options.iterations);
+    uint64_t failures = 0;
+    uint64_t calls_before = pwm->getTotalCalls();
+    gimbal.resetWriteStats();
+
+    auto run_start = Clock::now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+        size_t k = i % PATTERN_SIZE;
+        auto t0 = Clock::now();
+        GimbalStatus status = gimbal.setTipAngle(pan[k], tilt[k]);
+        auto t1 = Clock::now();
+        latencies[i] = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        failures += status ? 0 : 1;
+    }
+    auto run_end = Clock::now();
+
+    uint64_t controller_calls = pwm->getTotalCalls() - calls_before;
+    GimbalWriteStats writes = gimbal.getWriteStats();
+    double elapsed_s = std::chrono::duration<double>(run_end - run_start).count();
+    double commands_per_second = static_cast<double>(options.iterations) / elapsed_s;
+    uint32_t timer_overhead_ns = measureTimerOverhead();
+    double record_ns = measureTelemetryRecord(options.iterations);
+    Percentiles p = computePercentiles(latencies);
+
+    if (options.trace_path && !gimbal.getTelemetryRing().writeChromeTrace(options.trace_path, "gimbal_bench")) {
+        std::fprintf(stderr, "Cannot write %s\n", options.trace_path);
+    }
+    gimbal.shutdown();
+
+    std::fprintf(stderr, "=== gimbal_bench (%s) ===\n", pwm->getPlatformName());
+    std::fprintf(stderr, "iterations:        %llu (%s pattern)\n",
+                 static_cast<unsigned long long>(options.iterations),
+                 options.track_pattern ? "track" : "random");
+    std::fprintf(stderr, "injected latency:  %u ns\n", options.latency_ns);
+    std::fprintf(stderr, "latency p50/p99/p999/max: %u / %u / %u / %u ns (mean %.1f)\n",
+                 p.p50, p.p99, p.p999, p.max, p.mean);
+    std::fprintf(stderr, "timer overhead:    %u ns\n", timer_overhead_ns);
+    std::fprintf(stderr, "telemetry record:  %.2f ns\n", record_ns);
+    std::fprintf(stderr, "throughput:        %.0f commands/s\n", commands_per_second);
+    std::fprintf(stderr, "controller calls:  %llu (failures: %llu)\n",
+                 static_cast<unsigned long long>(controller_calls),
+                 static_cast<unsigned long long>(failures));
+    std::fprintf(stderr, "writes issued/suppressed: %llu / %llu\n",
+                 static_cast<unsigned long long>(writes.issued),
+                 static_cast<unsigned long long>(writes.suppressed));
+
+    FILE* out = stdout;
+    if (options.json_path) {
+        out = std::fopen(options.json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", options.json_path);
+            return 1;
+        }
+    }
+
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"gimbal_bench\",\n"
+                 "  \"platform\": \"%s\",\n"
+                 "  \"iterations\": %llu,\n"
+                 "  \"pattern\": \"%s\",\n"
+                 "  \"injected_latency_ns\": %u,\n"
+                 "  \"failure_rate\": %g,\n"
+                 "  \"latency_ns\": {\"mean\": %.1f, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"p999\": %u, \"max\": %u},\n"
+                 "  \"timer_overhead_ns\": %u,\n"
+                 "  \"telemetry_record_ns\": %.3f,\n"
+                 "  \"elapsed_s\": %.6f,\n"
+                 "  \"commands_per_second\": %.1f,\n"
+                 "  \"controller_calls\": %llu,\n"
+                 "  \"failures\": %llu,\n"
+                 "  \"writes_issued\": %llu,\n"
+                 "  \"writes_suppressed\": %llu\n"
+                 "}\n",
+                 pwm->getPlatformName(),
+                 static_cast<unsigned long long>(options.iterations),
+                 options.track_pattern ? "track" : "random",
+                 options.latency_ns,
+                 options.failure_rate,
+                 p.mean, p.p50, p.p90, p.p99, p.p999, p.max,
+                 timer_overhead_ns,
+                 record_ns,
+                 elapsed_s,
+                 commands_per_second,
+                 static_cast<unsigned long long>(controller_calls),
+                 static_cast<unsigned long long>(failures),
+                 static_cast<unsigned long long>(writes.issued),
+                 static_cast<unsigned long long>(writes.suppressed));
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
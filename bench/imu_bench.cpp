@@ -0,0 +1,311 @@
+#include "AttitudeFilter.h"
+#include "GimbalLog.h"
+#include "ImuSource.h"
+#include "Stabilizer.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/**
+ * @brief IMU stabilization on a synthetic vibrating mount
+ *
+ * Generates --seconds of 1 kHz IMU data for a mount that sways (roll 12°,
+ * pitch 8°, heading 20° at 0.2-1.1 Hz) and vibrates (23 Hz and 31 Hz,
+ * plus 2 m/s² of vertical shake), with gyro bias and sensor noise.
+ *
+ * 1. Fusion cost: AttitudeFilter::update() per sample, and the share of
+ *    one core a 1 kHz IMU takes.
+ * 2. Replay: the samples go through a GIMU file and ImuReplaySource into
+ *    a Stabilizer stepped at 50 Hz frames holding a world-frame target.
+ *    Each command takes effect --latency-ms after its frame and is held
+ *    for one frame; the pointing error against the true mount attitude is
+ *    sampled every millisecond of that hold. Compares commanding the
+ *    target as-is (no stabilization) with the Stabilizer without and with
+ *    attitude lead.
+ *
+ * Usage: imu_bench [--seconds S] [--latency-ms N] [--write PATH] [--json PATH]
+ *        (--write keeps the replay file, e.g. for gimbal_stabilize)
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG = PI / 180.0;
+constexpr double GRAVITY = 9.80665;
+constexpr uint64_t NS_PER_MS = 1000000;
+constexpr uint64_t SAMPLE_NS = NS_PER_MS;        // 1 kHz IMU
+constexpr uint64_t FRAME_NS = 20 * NS_PER_MS;    // 50 Hz PWM frames
+constexpr uint64_t START_NS = 1000000000;
+
+constexpr float TARGET_PAN = 30.0f;
+constexpr float TARGET_TILT = 10.0f;
+
+struct Quat {
+    double w, x, y, z;
+};
+
+Quat multiply(const Quat& a, const Quat& b) {
+    return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+}
+
+Quat conjugate(const Quat& q) {
+    return {q.w, -q.x, -q.y, -q.z};
+}
+
+/// v' = q v q*
+void rotate(const Quat& q, const double v[3], double out[3]) {
+    Quat p = multiply(multiply(q, {0.0, v[0], v[1], v[2]}), conjugate(q));
+    out[0] = p.x;
+    out[1] = p.y;
+    out[2] = p.z;
+}
+
+/// True mount attitude (body -> world, Z-Y-X) at time t seconds
+Quat mountAttitude(double t) {
+    const double roll = 12.0 * DEG * std::sin(2.0 * PI * 0.7 * t) + 0.8 * DEG * std::sin(2.0 * PI * 23.0 * t);
+    const double pitch = 8.0 * DEG * std::sin(2.0 * PI * 1.1 * t + 0.5) + 0.6 * DEG * std::sin(2.0 * PI * 31.0 * t);
+    const double yaw = 20.0 * DEG * std::sin(2.0 * PI * 0.2 * t);
+    Quat qz{std::cos(0.5 * yaw), 0.0, 0.0, std::sin(0.5 * yaw)};
+    Quat qy{std::cos(0.5 * pitch), 0.0, std::sin(0.5 * pitch), 0.0};
+    Quat qx{std::cos(0.5 * roll), std::sin(0.5 * roll), 0.0, 0.0};
+    return multiply(qz, multiply(qy, qx));
+}
+
+std::vector<ImuSample> makeSamples(double seconds) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> gyro_noise(0.0, 0.004);
+    std::normal_distribution<double> accel_noise(0.0, 0.25);
+    const double gyro_bias[3] = {0.012, -0.009, 0.0005};
+
+    const size_t count = static_cast<size_t>(seconds * 1e9 / static_cast<double>(SAMPLE_NS));
+    std::vector<ImuSample> samples(count);
+    const double h = 1e-6;
+    for (size_t i = 0; i < count; ++i) {
+        const double t = static_cast<double>(i * SAMPLE_NS) * 1e-9;
+        Quat q = mountAttitude(t);
+        // Body rate from the attitude derivative: 2 * vec(q* ⊗ dq/dt)
+        Quat dq = multiply(conjugate(q), mountAttitude(t + h));
+        const double rate[3] = {2.0 * dq.x / h, 2.0 * dq.y / h, 2.0 * dq.z / h};
+        // Specific force: gravity reaction plus vertical shake, in the body frame
+        const double shake = 2.0 * std::sin(2.0 * PI * 23.0 * t);
+        const double world_force[3] = {0.0, 0.0, GRAVITY + shake};
+        double body_force[3];
+        rotate(conjugate(q), world_force, body_force);
+
+        ImuSample& sample = samples[i];
+        sample.timestamp_ns = START_NS + i * SAMPLE_NS;
+        for (int axis = 0; axis < 3; ++axis) {
+            sample.gyro[axis] = static_cast<float>(rate[axis] + gyro_bias[axis] + gyro_noise(rng));
+            sample.accel[axis] = static_cast<float>(body_force[axis] + accel_noise(rng));
+        }
+    }
+    return samples;
+}
+
+/// Angle between where the camera points and the world target, degrees
+double pointingError(double t, float pan_angle, float tilt_angle) {
+    const double pan = pan_angle * DEG;
+    const double tilt = tilt_angle * DEG;
+    const double camera[3] = {std::cos(tilt) * std::cos(pan), std::cos(tilt) * std::sin(pan), std::sin(tilt)};
+    double world[3];
+    rotate(mountAttitude(t), camera, world);
+    const double target_pan = TARGET_PAN * DEG;
+    const double target_tilt = TARGET_TILT * DEG;
+    const double target[3] = {std::cos(target_tilt) * std::cos(target_pan),
+                              std::cos(target_tilt) * std::sin(target_pan), std::sin(target_tilt)};
+    double dot = world[0] * target[0] + world[1] * target[1] + world[2] * target[2];
+    dot = dot > 1.0 ? 1.0 : (dot < -1.0 ? -1.0 : dot);
+    return std::acos(dot) / DEG;
+}
+
+struct Row {
+    const char* method;
+    double rms_deg;
+    double max_deg;
+    uint64_t saturated;
+};
+
+/**
+ * @brief Replay the file through one configuration of the frame loop
+ * @param stabilize false = command the world target as servo angles
+ */
+Row runReplay(const char* method, ImuReplaySource& replay, bool stabilize, uint64_t lead_ns, uint64_t latency_ns,
+              double& attitude_rms_deg) {
+    StabilizerConfig config;
+    config.lead_ns = lead_ns;
+    Stabilizer stabilizer(nullptr, config);
+    replay.start(START_NS);
+
+    ImuSample buffer[64];
+    double sum_sq = 0.0;
+    double worst = 0.0;
+    double attitude_sq = 0.0;
+    uint64_t points = 0;
+    uint64_t frames = 0;
+    const uint64_t end_ns = START_NS + replay.getDuration() - FRAME_NS - latency_ns;
+    for (uint64_t frame_ns = START_NS + FRAME_NS; frame_ns < end_ns; frame_ns += FRAME_NS) {
+        size_t count;
+        while ((count = replay.readUntil(buffer, 64, frame_ns)) > 0) {
+            stabilizer.update(buffer, count);
+        }
+
+        float pan_angle = TARGET_PAN;
+        float tilt_angle = TARGET_TILT;
+        if (stabilize) {
+            stabilizer.toServoAngles(TARGET_PAN, TARGET_TILT, frame_ns, pan_angle, tilt_angle);
+        }
+
+        // Skip the first second while the filter settles
+        if (frame_ns < START_NS + 1000 * NS_PER_MS) {
+            continue;
+        }
+        for (uint64_t t = frame_ns + latency_ns; t < frame_ns + latency_ns + FRAME_NS; t += NS_PER_MS) {
+            double error = pointingError(static_cast<double>(t - START_NS) * 1e-9, pan_angle, tilt_angle);
+            sum_sq += error * error;
+            worst = error > worst ? error : worst;
+            ++points;
+        }
+
+        // Attitude estimate against the truth at the frame
+        const Quaternion& estimate = stabilizer.getFilter().getAttitude();
+        Quat truth = mountAttitude(static_cast<double>(stabilizer.getStats().last_sample_ns - START_NS) * 1e-9);
+        double dot = std::fabs(estimate.w * truth.w + estimate.x * truth.x + estimate.y * truth.y +
+                               estimate.z * truth.z);
+        dot = dot > 1.0 ? 1.0 : dot;
+        double angle = 2.0 * std::acos(dot) / DEG;
+        attitude_sq += angle * angle;
+        ++frames;
+    }
+
+    attitude_rms_deg = frames > 0 ? std::sqrt(attitude_sq / static_cast<double>(frames)) : 0.0;
+    Row row;
+    row.method = method;
+    row.rms_deg = points > 0 ? std::sqrt(sum_sq / static_cast<double>(points)) : 0.0;
+    row.max_deg = worst;
+    row.saturated = stabilizer.getStats().saturated;
+    return row;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = 30.0;
+    uint64_t latency_ms = 10;
+    const char* write_path = nullptr;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--seconds") == 0 && value) {
+            seconds = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--latency-ms") == 0 && value) {
+            latency_ms = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--write") == 0 && value) {
+            write_path = value;
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--seconds S] [--latency-ms N] [--write PATH] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (seconds < 3.0) {
+        return 2;
+    }
+    const uint64_t latency_ns = latency_ms * NS_PER_MS;
+
+    std::vector<ImuSample> samples = makeSamples(seconds);
+
+    // Fusion cost over the whole recording, several passes
+    AttitudeFilter filter;
+    const int passes = 20;
+    auto t0 = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        filter.reset();
+        for (const ImuSample& sample : samples) {
+            filter.update(sample);
+        }
+        asm volatile("" : : "r"(&filter) : "memory");
+    }
+    auto t1 = Clock::now();
+    const double ns_per_sample = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                                 (static_cast<double>(samples.size()) * passes);
+    const double core_share = ns_per_sample / static_cast<double>(SAMPLE_NS);
+
+    // Replay through a file, as recorded flight data would be
+    const char* path = write_path ? write_path : "imu_bench.gimu";
+    if (!ImuReplaySource::write(path, samples.data(), samples.size())) {
+        GimbalLog::drain();
+        return 1;
+    }
+    ImuReplaySource replay;
+    if (!replay.open(path)) {
+        GimbalLog::drain();
+        return 1;
+    }
+
+    double attitude_rms = 0.0;
+    double unused = 0.0;
+    const uint64_t lead_ns = latency_ns + FRAME_NS / 2;
+    Row rows[3] = {
+        runReplay("none", replay, false, 0, latency_ns, unused),
+        runReplay("stabilized", replay, true, 0, latency_ns, unused),
+        runReplay("stabilized+lead", replay, true, lead_ns, latency_ns, attitude_rms),
+    };
+    replay.close();
+    if (!write_path) {
+        std::remove(path);
+    }
+    GimbalLog::drain();
+
+    std::fprintf(stderr, "=== imu_bench ===\n");
+    std::fprintf(stderr, "fusion:   %.1f ns per sample, %.4f%% of one core at 1 kHz\n", ns_per_sample,
+                 core_share * 100.0);
+    std::fprintf(stderr, "replay:   %zu samples (%.1f s), target pan %.0f tilt %.0f, latency %llu ms\n",
+                 samples.size(), seconds, static_cast<double>(TARGET_PAN), static_cast<double>(TARGET_TILT),
+                 static_cast<unsigned long long>(latency_ms));
+    std::fprintf(stderr, "          attitude estimate RMS error %.3f deg\n", attitude_rms);
+    std::fprintf(stderr, "%-18s %10s %10s %10s\n", "method", "rms_deg", "max_deg", "saturated");
+    for (const Row& row : rows) {
+        std::fprintf(stderr, "%-18s %10.3f %10.3f %10llu\n", row.method, row.rms_deg, row.max_deg,
+                     static_cast<unsigned long long>(row.saturated));
+    }
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"imu_bench\",\n"
+                 "  \"fusion\": {\"ns_per_sample\": %.3f, \"core_share_1khz\": %.6f},\n"
+                 "  \"replay\": {\"samples\": %zu, \"seconds\": %.3f, \"latency_ms\": %llu,"
+                 " \"attitude_rms_deg\": %.4f},\n"
+                 "  \"results\": [\n",
+                 ns_per_sample, core_share, samples.size(), seconds, static_cast<unsigned long long>(latency_ms),
+                 attitude_rms);
+    for (size_t i = 0; i < 3; ++i) {
+        std::fprintf(out, "    {\"method\": \"%s\", \"rms_deg\": %.4f, \"max_deg\": %.4f, \"saturated\": %llu}%s\n",
+                     rows[i].method, rows[i].rms_deg, rows[i].max_deg,
+                     static_cast<unsigned long long>(rows[i].saturated), i + 1 < 3 ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    // Stabilizing must beat commanding the target blind
+    return rows[1].rms_deg < rows[0].rms_deg ? 0 : 1;
+}
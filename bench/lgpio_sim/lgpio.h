@@ -0,0 +1,41 @@
+#ifndef LGPIO_SIM_H
+#define LGPIO_SIM_H
+
+/**
+ * @file lgpio.h
+ * @brief Minimal in-process stand-in for the lgpio API used by PWMControllerRPi5
+ *
+ * Lets PWMControllerRPi5 be built and benchmarked on any host: calls are
+ * validated and recorded in memory, nothing touches hardware. Only the
+ * functions the backend uses are provided; error codes are the shim's own.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LG_BAD_HANDLE -5          ///< Unknown gpiochip handle
+#define LG_BAD_GPIO -7            ///< GPIO number out of range
+#define LG_GPIO_NOT_ALLOCATED -62 ///< GPIO not claimed
+
+int lgGpiochipOpen(int gpioDev);
+int lgGpiochipClose(int handle);
+int lgGpioClaimOutput(int handle, int lFlags, int gpio, int level);
+int lgGpioFree(int handle, int gpio);
+int lgTxPwm(int handle, int gpio, float pwmFrequency, float pwmDutyCycle, int pwmOffset, int pwmCycles);
+const char* lguErrorText(int error);
+
+/// Calls to lgTxPwm that reached the (simulated) line
+unsigned long long lgSimTxPwmCalls(void);
+
+/// Last duty cycle written to a GPIO (percent, -1 if never written)
+float lgSimDuty(int gpio);
+
+/// Last frequency written to a GPIO (Hz, -1 if never written)
+float lgSimFrequency(int gpio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LGPIO_SIM_H
@@ -0,0 +1,100 @@
+#include "lgpio.h"
+
+namespace {
+
+constexpr int SIM_HANDLE = 0;
+constexpr int SIM_GPIOS = 54;
+
+bool chip_open = false;
+bool claimed[SIM_GPIOS] = {};
+float duty[SIM_GPIOS] = {};
+float frequency[SIM_GPIOS] = {};
+unsigned long long tx_pwm_calls = 0;
+
+bool validGpio(int gpio) {
+    return gpio >= 0 && gpio < SIM_GPIOS;
+}
+
+} // namespace
+
+extern "C" {
+
+int lgGpiochipOpen(int gpioDev) {
+    if (gpioDev != 0) {
+        return LG_BAD_HANDLE;
+    }
+    chip_open = true;
+    for (int gpio = 0; gpio < SIM_GPIOS; ++gpio) {
+        claimed[gpio] = false;
+        duty[gpio] = -1.0f;
+        frequency[gpio] = -1.0f;
+    }
+    return SIM_HANDLE;
+}
+
+int lgGpiochipClose(int handle) {
+    if (handle != SIM_HANDLE || !chip_open) {
+        return LG_BAD_HANDLE;
+    }
+    chip_open = false;
+    return 0;
+}
+
+int lgGpioClaimOutput(int handle, int, int gpio, int) {
+    if (handle != SIM_HANDLE || !chip_open) {
+        return LG_BAD_HANDLE;
+    }
+    if (!validGpio(gpio)) {
+        return LG_BAD_GPIO;
+    }
+    claimed[gpio] = true;
+    return 0;
+}
+
+int lgGpioFree(int handle, int gpio) {
+    if (handle != SIM_HANDLE || !chip_open) {
+        return LG_BAD_HANDLE;
+    }
+    if (!validGpio(gpio) || !claimed[gpio]) {
+        return LG_GPIO_NOT_ALLOCATED;
+    }
+    claimed[gpio] = false;
+    return 0;
+}
+
+int lgTxPwm(int handle, int gpio, float pwmFrequency, float pwmDutyCycle, int, int) {
+    if (handle != SIM_HANDLE || !chip_open) {
+        return LG_BAD_HANDLE;
+    }
+    if (!validGpio(gpio) || !claimed[gpio]) {
+        return LG_GPIO_NOT_ALLOCATED;
+    }
+    duty[gpio] = pwmDutyCycle;
+    frequency[gpio] = pwmFrequency;
+    ++tx_pwm_calls;
+    return 0;
+}
+
+const char* lguErrorText(int error) {
+    switch (error) {
+    case 0: return "no error";
+    case LG_BAD_HANDLE: return "unknown handle";
+    case LG_BAD_GPIO: return "GPIO outside 0-53";
+    case LG_GPIO_NOT_ALLOCATED: return "GPIO not allocated";
+    default: return "unknown error";
+    }
+}
+
+unsigned long long lgSimTxPwmCalls(void) {
+    return tx_pwm_calls;
+}
+
+float lgSimDuty(int gpio) {
+    return validGpio(gpio) ? duty[gpio] : -1.0f;
+}
+
+float lgSimFrequency(int gpio) {
+    return validGpio(gpio) ? frequency[gpio] : -1.0f;
+}
+
+} // extern "C"
@@ -0,0 +1,257 @@
+#include "LookAt.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief LookAt batch conversions and target selection per camera frame
+ *
+ * A 1280x720, 70 degree camera sits on a gimbal with realistic offsets
+ * (tilt axis 5 cm above the pan axis, camera 4 cm above and 2 cm beside
+ * the tilt axis, base pitched down 10 degrees on a vehicle). For N
+ * candidate detections per frame it times:
+ *
+ * - pixels:  LookAt::pixelsToAngles() (vectorized approximation)
+ * - points:  LookAt::pointsToAngles() for 3D points 2-50 m away
+ * - select:  LookAt::selectTarget() over the point results
+ * - scalar:  pointToAngles() per candidate (std::atan2, one at a time)
+ *
+ * and checks the results: batch versus scalar within
+ * LookAt::MAX_APPROX_ERROR_DEG, the solved angles put each point on the
+ * optical axis (forward kinematics in double), and the selected target
+ * is the cheapest reachable one.
+ *
+ * Usage: look_at_bench [--candidates N] [--frames N] [--json PATH]
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double PI = 3.14159265358979323846;
+
+/// xorshift64: fast and reproducible
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+float uniform(uint64_t& state, float low, float high) {
+    return low + (high - low) * static_cast<float>(nextRandom(state) >> 40) / static_cast<float>(1ull << 24);
+}
+
+LookAtConfig benchConfig() {
+    LookAtConfig config;
+    config.camera = CameraIntrinsics::fromFieldOfView(1280, 720, 70.0f);
+    GimbalKinematics& k = config.kinematics;
+    k.mount_position[0] = 0.5f;
+    k.mount_position[2] = 1.2f;
+    k.mount_pitch = -10.0f;
+    k.mount_yaw = 5.0f;
+    k.tilt_offset[2] = 0.05f;
+    k.camera_offset[0] = 0.03f;
+    k.camera_offset[1] = 0.02f;
+    k.camera_offset[2] = 0.04f;
+    k.pan_trim = 1.5f;
+    k.tilt_trim = -0.8f;
+    return config;
+}
+
+/**
+ * @brief Distance of a point from the optical axis at the given servo
+ *        angles, as an angle seen from the camera (degrees)
+ */
+double axisErrorDeg(const GimbalKinematics& k, double pan, double tilt, const double point[3]) {
+    const double d2r = PI / 180.0;
+    const double yaw = k.mount_yaw * d2r, pitch = k.mount_pitch * d2r, roll = k.mount_roll * d2r;
+    const double cy = std::cos(yaw), sy = std::sin(yaw), cp = std::cos(pitch), sp = std::sin(pitch);
+    const double cr = std::cos(roll), sr = std::sin(roll);
+    const double r[9] = {cy * cp, -sy * cr - cy * sp * sr, sy * sr - cy * sp * cr,
+                         sy * cp, cy * cr - sy * sp * sr,  -cy * sr - sy * sp * cr,
+                         sp,      cp * sr,                 cp * cr};
+    const double a = (pan - k.pan_trim) * d2r;
+    const double b = (tilt - k.tilt_trim) * d2r;
+    const double ca = std::cos(a), sa = std::sin(a), cb = std::cos(b), sb = std::sin(b);
+
+    // Optical centre and axis in the base frame: pan about z, tilt (up) about -y
+    const double cam[3] = {k.camera_offset[0] * cb - k.camera_offset[2] * sb + k.tilt_offset[0],
+                           k.camera_offset[1] + k.tilt_offset[1],
+                           k.camera_offset[0] * sb + k.camera_offset[2] * cb + k.tilt_offset[2]};
+    const double axis_t[3] = {cb, 0.0, sb};
+    double origin[3] = {ca * cam[0] - sa * cam[1], sa * cam[0] + ca * cam[1], cam[2]};
+    double axis[3] = {ca * axis_t[0], sa * axis_t[0], axis_t[2]};
+
+    // Into the reference frame
+    double o[3], d[3];
+    for (int i = 0; i < 3; ++i) {
+        o[i] = r[i * 3] * origin[0] + r[i * 3 + 1] * origin[1] + r[i * 3 + 2] * origin[2] + k.mount_position[i];
+        d[i] = r[i * 3] * axis[0] + r[i * 3 + 1] * axis[1] + r[i * 3 + 2] * axis[2];
+    }
+    const double v[3] = {point[0] - o[0], point[1] - o[1], point[2] - o[2]};
+    const double along = v[0] * d[0] + v[1] * d[1] + v[2] * d[2];
+    const double range = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    return std::acos(std::fmin(1.0, along / range)) / d2r;
+}
+
+template <typename F>
+double nsPerCandidate(F&& body, size_t candidates, uint32_t frames) {
+    auto t0 = Clock::now();
+    for (uint32_t f = 0; f < frames; ++f) {
+        body();
+    }
+    auto t1 = Clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) /
+           (static_cast<double>(frames) * static_cast<double>(candidates));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t candidates = 256;
+    uint32_t frames = 20000;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--candidates") == 0 && value) {
+            candidates = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--frames") == 0 && value) {
+            frames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--candidates N] [--frames N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (candidates == 0 || frames == 0) {
+        return 2;
+    }
+
+    const LookAtConfig config = benchConfig();
+    const LookAt look_at(config);
+    const float pan_now = 12.0f;
+    const float tilt_now = -4.0f;
+
+    // Candidates: detections anywhere in the frame, points around the vehicle
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    std::vector<float> u(candidates), v(candidates), x(candidates), y(candidates), z(candidates);
+    for (size_t i = 0; i < candidates; ++i) {
+        u[i] = uniform(state, 0.0f, 1280.0f);
+        v[i] = uniform(state, 0.0f, 720.0f);
+        const float range = uniform(state, 2.0f, 50.0f);
+        const float bearing = uniform(state, -120.0f, 120.0f) * static_cast<float>(PI / 180.0);
+        const float elevation = uniform(state, -30.0f, 40.0f) * static_cast<float>(PI / 180.0);
+        x[i] = range * std::cos(elevation) * std::cos(bearing);
+        y[i] = range * std::cos(elevation) * std::sin(bearing);
+        z[i] = range * std::sin(elevation) + 1.2f;
+    }
+    std::vector<float> pan(candidates), tilt(candidates), pan_px(candidates), tilt_px(candidates);
+    std::vector<float> costs(candidates);
+
+    // Accuracy
+    look_at.pixelsToAngles(u.data(), v.data(), candidates, pan_now, tilt_now, pan_px.data(), tilt_px.data());
+    look_at.pointsToAngles(x.data(), y.data(), z.data(), candidates, pan.data(), tilt.data());
+    double pixel_error = 0.0;
+    double point_error = 0.0;
+    double axis_error = 0.0;
+    size_t reachable = 0;
+    for (size_t i = 0; i < candidates; ++i) {
+        float exact_pan, exact_tilt;
+        if (look_at.pixelToAngles(u[i], v[i], pan_now, tilt_now, exact_pan, exact_tilt)) {
+            pixel_error = std::fmax(pixel_error, std::fabs(exact_pan - pan_px[i]));
+            pixel_error = std::fmax(pixel_error, std::fabs(exact_tilt - tilt_px[i]));
+        }
+        if (look_at.pointToAngles(x[i], y[i], z[i], exact_pan, exact_tilt)) {
+            ++reachable;
+            point_error = std::fmax(point_error, std::fabs(exact_pan - pan[i]));
+            point_error = std::fmax(point_error, std::fabs(exact_tilt - tilt[i]));
+            const double point[3] = {x[i], y[i], z[i]};
+            axis_error = std::fmax(axis_error, axisErrorDeg(config.kinematics, exact_pan, exact_tilt, point));
+        }
+    }
+
+    // The selection must agree with a plain search over the exact results
+    size_t chosen = look_at.selectTarget(pan.data(), tilt.data(), nullptr, candidates, pan_now, tilt_now, costs.data());
+    size_t expected = LookAt::NO_TARGET;
+    double expected_cost = INFINITY;
+    for (size_t i = 0; i < candidates; ++i) {
+        float exact_pan, exact_tilt;
+        if (look_at.pointToAngles(x[i], y[i], z[i], exact_pan, exact_tilt)) {
+            double cost = std::fmax(std::fabs(exact_pan - pan_now) / config.pan_speed_dps,
+                                    std::fabs(exact_tilt - tilt_now) / config.tilt_speed_dps);
+            if (cost < expected_cost) {
+                expected_cost = cost;
+                expected = i;
+            }
+        }
+    }
+    // Near-ties may flip within the approximation error
+    const bool select_ok = chosen == expected ||
+                           (chosen != LookAt::NO_TARGET && expected != LookAt::NO_TARGET &&
+                            std::fabs(costs[chosen] - expected_cost) <=
+                                2.0 * LookAt::MAX_APPROX_ERROR_DEG / config.pan_speed_dps);
+
+    // Speed
+    volatile float sink = 0.0f;
+    const double pixels_ns = nsPerCandidate([&]() {
+        look_at.pixelsToAngles(u.data(), v.data(), candidates, pan_now, tilt_now, pan_px.data(), tilt_px.data());
+        sink = sink + pan_px[0];
+    }, candidates, frames);
+    const double points_ns = nsPerCandidate([&]() {
+        look_at.pointsToAngles(x.data(), y.data(), z.data(), candidates, pan.data(), tilt.data());
+        sink = sink + pan[0];
+    }, candidates, frames);
+    const double select_ns = nsPerCandidate([&]() {
+        sink = sink + static_cast<float>(
+                          look_at.selectTarget(pan.data(), tilt.data(), nullptr, candidates, pan_now, tilt_now));
+    }, candidates, frames);
+    const double scalar_ns = nsPerCandidate([&]() {
+        for (size_t i = 0; i < candidates; ++i) {
+            look_at.pointToAngles(x[i], y[i], z[i], pan[i], tilt[i]);
+        }
+        sink = sink + pan[0];
+    }, candidates, frames);
+    const double frame_us = (points_ns + select_ns) * static_cast<double>(candidates) / 1e3;
+
+    const bool accuracy_ok = pixel_error <= LookAt::MAX_APPROX_ERROR_DEG &&
+                             point_error <= LookAt::MAX_APPROX_ERROR_DEG && axis_error < 0.01;
+
+    std::fprintf(stderr, "=== look_at_bench (%zu candidates, %u frames) ===\n", candidates, frames);
+    std::fprintf(stderr, "%-8s %14s\n", "kernel", "ns/candidate");
+    std::fprintf(stderr, "%-8s %14.2f\n", "pixels", pixels_ns);
+    std::fprintf(stderr, "%-8s %14.2f\n", "points", points_ns);
+    std::fprintf(stderr, "%-8s %14.2f\n", "select", select_ns);
+    std::fprintf(stderr, "%-8s %14.2f\n", "scalar", scalar_ns);
+    std::fprintf(stderr, "points + select: %.2f us per frame, %.1fx faster than scalar points\n", frame_us,
+                 scalar_ns / points_ns);
+    std::fprintf(stderr, "max error vs std::atan2: pixels %.5f deg, points %.5f deg (bound %.3f); "
+                 "off optical axis %.6f deg\n", pixel_error, point_error, LookAt::MAX_APPROX_ERROR_DEG, axis_error);
+    std::fprintf(stderr, "%zu/%zu points reachable, selected %zu: accuracy %s, selection %s\n", reachable, candidates,
+                 chosen, accuracy_ok ? "ok" : "FAILED", select_ok ? "ok" : "FAILED");
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n  \"benchmark\": \"look_at_bench\",\n  \"candidates\": %zu,\n  \"frames\": %u,\n"
+                 "  \"ns_per_candidate\": {\"pixels\": %.3f, \"points\": %.3f, \"select\": %.3f, \"scalar\": %.3f},\n"
+                 "  \"frame_us\": %.3f,\n  \"max_error_deg\": {\"pixels\": %.6f, \"points\": %.6f, \"axis\": %.6f},\n"
+                 "  \"reachable\": %zu\n}\n",
+                 candidates, frames, pixels_ns, points_ns, select_ns, scalar_ns, frame_us, pixel_error, point_error,
+                 axis_error, reachable);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return (accuracy_ok && select_ok) ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+#include "TargetPredictor.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Tracking accuracy of TargetPredictor on replayed target tracks
+ *
+ * Replays a target track through a model of the tracking pipeline: a camera
+ * samples the target (with noise) every --camera-us, each measurement
+ * becomes available --vision-ms after capture, the control loop commands
+ * the servos once per 20 ms PWM frame, and the servo follows its command as
+ * a first-order lag with time constant --tau-ms. The error is the distance
+ * between the servo and the true target, sampled every millisecond.
+ *
+ * Compares commanding the latest measurement directly against the
+ * alpha-beta and Kalman predictors leading to the actuation time, and
+ * times update() + predict().
+ *
+ * Built-in tracks are synthetic; --replay FILE reads a recorded track of
+ * "timestamp_ns pan tilt" lines instead.
+ *
+ * Usage: predictor_bench [--replay FILE] [--vision-ms N] [--tau-ms N]
+ *                        [--camera-us N] [--noise DEG] [--json PATH]
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t NS_PER_MS = 1000000;
+constexpr uint64_t FRAME_NS = 20 * NS_PER_MS;
+constexpr uint64_t SIM_STEP_NS = NS_PER_MS;
+
+struct TrackPoint {
+    uint64_t t_ns;
+    float pan;
+    float tilt;
+};
+
+struct Track {
+    const char* name;
+    std::vector<TrackPoint> points;   // Ground truth, uniform SIM_STEP_NS spacing
+};
+
+struct PipelineModel {
+    uint64_t vision_ns;
+    uint64_t camera_ns;
+    float tau_s;
+    float noise_deg;
+};
+
+struct Row {
+    const char* track;
+    const char* method;
+    double rms_deg;
+    double max_deg;
+};
+
+/// Deterministic Gaussian noise (Box-Muller on an LCG)
+class Noise {
+public:
+    explicit Noise(uint32_t seed) : state_(seed) {}
+
+    float next(float sigma) {
+        float u1 = uniform();
+        float u2 = uniform();
+        return sigma * std::sqrt(-2.0f * std::log(u1)) * std::cos(6.2831853f * u2);
+    }
+
+private:
+    uint32_t state_;
+
+    float uniform() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return (static_cast<float>(state_ >> 8) + 1.0f) / 16777217.0f;
+    }
+};
+
+Track makeSine() {
+    Track track{"sine_0.5hz", {}};
+    for (uint64_t t = 0; t <= 20000 * NS_PER_MS; t += SIM_STEP_NS) {
+        float s = static_cast<float>(t) * 1e-9f;
+        track.points.push_back({t, 40.0f * std::sin(3.14159265f * s), 20.0f * std::sin(1.8f * s)});
+    }
+    return track;
+}
+
+Track makeSweep() {
+    // 60 deg/s sweeps with instant reversals
+    Track track{"sweep_60dps", {}};
+    for (uint64_t t = 0; t <= 20000 * NS_PER_MS; t += SIM_STEP_NS) {
+        float s = static_cast<float>(t) * 1e-9f;
+        float phase = std::fmod(s, 2.0f);
+        float pan = phase < 1.0f ? -30.0f + 60.0f * phase : 30.0f - 60.0f * (phase - 1.0f);
+        track.points.push_back({t, pan, 0.5f * pan});
+    }
+    return track;
+}
+
+Track makeManeuver() {
+    // Piecewise-constant random acceleration, bounded to the gimbal range
+    Track track{"maneuver", {}};
+    Noise noise(7);
+    float pan = 0.0f, tilt = 0.0f, pan_v = 0.0f, tilt_v = 0.0f, pan_a = 0.0f, tilt_a = 0.0f;
+    const float dt = static_cast<float>(SIM_STEP_NS) * 1e-9f;
+    for (uint64_t t = 0; t <= 20000 * NS_PER_MS; t += SIM_STEP_NS) {
+        if (t % (250 * NS_PER_MS) == 0) {
+            pan_a = noise.next(150.0f) - 2.0f * pan - 1.0f * pan_v;
+            tilt_a = noise.next(100.0f) - 2.0f * tilt - 1.0f * tilt_v;
+        }
+        pan_v += pan_a * dt;
+        tilt_v += tilt_a * dt;
+        pan += pan_v * dt;
+        tilt += tilt_v * dt;
+        track.points.push_back({t, pan, tilt});
+    }
+    return track;
+}
+
+bool loadTrack(const char* path, Track& track) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    std::vector<TrackPoint> raw;
+    unsigned long long t;
+    float pan, tilt;
+    while (std::fscanf(file, "%llu %f %f", &t, &pan, &tilt) == 3) {
+        raw.push_back({static_cast<uint64_t>(t), pan, tilt});
+    }
+    std::fclose(file);
+    if (raw.size() < 2) {
+        return false;
+    }
+
+    // Resample to the simulation step by linear interpolation
+    track.name = "replay";
+    size_t j = 0;
+    for (uint64_t t_ns = raw.front().t_ns; t_ns <= raw.back().t_ns; t_ns += SIM_STEP_NS) {
+        while (j + 2 < raw.size() && raw[j + 1].t_ns <= t_ns) {
+            ++j;
+        }
+        const TrackPoint& a = raw[j];
+        const TrackPoint& b = raw[j + 1];
+        float f = b.t_ns > a.t_ns ? static_cast<float>(t_ns - a.t_ns) / static_cast<float>(b.t_ns - a.t_ns) : 0.0f;
+        f = f > 1.0f ? 1.0f : f;
+        track.points.push_back({t_ns - raw.front().t_ns, a.pan + (b.pan - a.pan) * f, a.tilt + (b.tilt - a.tilt) * f});
+    }
+    return true;
+}
+
+/// Run one track through the pipeline; predictor == nullptr commands raw measurements
+Row simulate(const Track& track, const PipelineModel& model, TargetPredictor* predictor, const char* method) {
+    Noise noise(42);
+    std::vector<TrackPoint> measurements;
+    for (const TrackPoint& p : track.points) {
+        if (p.t_ns % model.camera_ns < SIM_STEP_NS) {
+            measurements.push_back({p.t_ns, p.pan + noise.next(model.noise_deg), p.tilt + noise.next(model.noise_deg)});
+        }
+    }
+
+    const float alpha = model.tau_s > 0.0f ? 1.0f - std::exp(-1e-3f / model.tau_s) : 1.0f;
+    float servo_pan = track.points.front().pan;
+    float servo_tilt = track.points.front().tilt;
+    float command_pan = servo_pan;
+    float command_tilt = servo_tilt;
+    size_t next_measurement = 0;
+    bool have_measurement = false;
+    TrackPoint latest{0, 0.0f, 0.0f};
+
+    double sum_sq = 0.0;
+    double max_err = 0.0;
+    size_t samples = 0;
+    const uint64_t warmup_ns = 1000 * NS_PER_MS;
+
+    for (const TrackPoint& truth : track.points) {
+        const uint64_t t = truth.t_ns;
+        // Measurements whose processing finished by now
+        while (next_measurement < measurements.size() &&
+               measurements[next_measurement].t_ns + model.vision_ns <= t) {
+            latest = measurements[next_measurement++];
+            have_measurement = true;
+            if (predictor) {
+                predictor->update(latest.pan, latest.tilt, latest.t_ns);
+            }
+        }
+
+        if (t % FRAME_NS == 0 && have_measurement) {
+            if (predictor) {
+                predictor->predict(t, command_pan, command_tilt);
+            } else {
+                command_pan = latest.pan;
+                command_tilt = latest.tilt;
+            }
+        }
+
+        servo_pan += (command_pan - servo_pan) * alpha;
+        servo_tilt += (command_tilt - servo_tilt) * alpha;
+
+        if (t >= warmup_ns) {
+            double dp = servo_pan - truth.pan;
+            double dt = servo_tilt - truth.tilt;
+            double err = std::sqrt(dp * dp + dt * dt);
+            sum_sq += err * err;
+            max_err = err > max_err ? err : max_err;
+            ++samples;
+        }
+    }
+
+    Row row;
+    row.track = track.name;
+    row.method = method;
+    row.rms_deg = samples > 0 ? std::sqrt(sum_sq / static_cast<double>(samples)) : 0.0;
+    row.max_deg = max_err;
+    return row;
+}
+
+double timeUpdatePredict(PredictorModel model_type) {
+    PredictorConfig config;
+    config.model = model_type;
+    TargetPredictor predictor(config);
+    const uint64_t iterations = 2000000;
+    float pan = 0.0f, tilt = 0.0f, sink = 0.0f;
+
+    auto t0 = Clock::now();
+    for (uint64_t i = 1; i <= iterations; ++i) {
+        float x = static_cast<float>(i & 1023) * 0.01f;
+        predictor.update(x, -x, i * 250000);
+        predictor.predict(i * 250000 + 60000000, pan, tilt);
+        sink += pan;
+    }
+    auto t1 = Clock::now();
+    if (sink == 12345.0f) {
+        std::printf(" ");
+    }
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    PipelineModel model{40 * NS_PER_MS, 33 * NS_PER_MS, 0.05f, 0.2f};
+    const char* replay_path = nullptr;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--replay") == 0 && value) {
+            replay_path = value;
+        } else if (std::strcmp(argv[i], "--vision-ms") == 0 && value) {
+            model.vision_ns = std::strtoull(value, nullptr, 10) * NS_PER_MS;
+        } else if (std::strcmp(argv[i], "--tau-ms") == 0 && value) {
+            model.tau_s = std::strtof(value, nullptr) * 1e-3f;
+        } else if (std::strcmp(argv[i], "--camera-us") == 0 && value) {
+            model.camera_ns = std::strtoull(value, nullptr, 10) * 1000;
+        } else if (std::strcmp(argv[i], "--noise") == 0 && value) {
+            model.noise_deg = std::strtof(value, nullptr);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr,
+                         "Usage: %s [--replay FILE] [--vision-ms N] [--tau-ms N] [--camera-us N] [--noise DEG] [--json PATH]\n",
+                         argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (model.camera_ns < SIM_STEP_NS) {
+        std::fprintf(stderr, "--camera-us must be at least 1000\n");
+        return 2;
+    }
+
+    std::vector<Track> tracks;
+    if (replay_path) {
+        Track track;
+        if (!loadTrack(replay_path, track)) {
+            std::fprintf(stderr, "Cannot read track %s\n", replay_path);
+            return 1;
+        }
+        tracks.push_back(track);
+    } else {
+        tracks.push_back(makeSine());
+        tracks.push_back(makeSweep());
+        tracks.push_back(makeManeuver());
+    }
+
+    // Lead by the servo lag; the measurement delay is covered by the timestamps
+    PredictorConfig alpha_beta;
+    alpha_beta.model = PredictorModel::AlphaBeta;
+    alpha_beta.servo_time_constant_s = model.tau_s;
+    PredictorConfig kalman;
+    kalman.model = PredictorModel::Kalman;
+    kalman.measurement_noise = model.noise_deg * model.noise_deg;
+    kalman.servo_time_constant_s = model.tau_s;
+
+    std::vector<Row> rows;
+    for (const Track& track : tracks) {
+        TargetPredictor ab(alpha_beta);
+        TargetPredictor kf(kalman);
+        rows.push_back(simulate(track, model, nullptr, "raw"));
+        rows.push_back(simulate(track, model, &ab, "alpha_beta"));
+        rows.push_back(simulate(track, model, &kf, "kalman"));
+    }
+    double ab_ns = timeUpdatePredict(PredictorModel::AlphaBeta);
+    double kf_ns = timeUpdatePredict(PredictorModel::Kalman);
+
+    std::fprintf(stderr, "=== predictor_bench (vision %.0f ms, camera %.1f ms, servo tau %.0f ms, noise %.2f deg) ===\n",
+                 static_cast<double>(model.vision_ns) / 1e6, static_cast<double>(model.camera_ns) / 1e6,
+                 static_cast<double>(model.tau_s) * 1e3, static_cast<double>(model.noise_deg));
+    std::fprintf(stderr, "%-12s %-11s %10s %10s\n", "track", "method", "rms deg", "max deg");
+    for (const Row& row : rows) {
+        std::fprintf(stderr, "%-12s %-11s %10.3f %10.3f\n", row.track, row.method, row.rms_deg, row.max_deg);
+    }
+    std::fprintf(stderr, "update+predict: alpha_beta %.1f ns, kalman %.1f ns\n", ab_ns, kf_ns);
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"predictor_bench\",\n  \"vision_ms\": %.1f,\n  \"servo_tau_ms\": %.1f,\n",
+                 static_cast<double>(model.vision_ns) / 1e6, static_cast<double>(model.tau_s) * 1e3);
+    std::fprintf(out, "  \"update_predict_ns\": {\"alpha_beta\": %.1f, \"kalman\": %.1f},\n  \"results\": [\n", ab_ns, kf_ns);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        std::fprintf(out, "    {\"track\": \"%s\", \"method\": \"%s\", \"rms_deg\": %.4f, \"max_deg\": %.4f}%s\n",
+                     rows[i].track, rows[i].method, rows[i].rms_deg, rows[i].max_deg, i + 1 < rows.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
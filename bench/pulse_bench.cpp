@@ -0,0 +1,247 @@
+#include "GimbalConfig.h"
+#include "PWMControllerPico.h"
+#include "PicoPWMConfig.h"
+#include "PulseMapping.h"
+#include "ServoCalibration.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PULSE_BENCH_HAVE_TSC 1
+#endif
+
+/**
+ * @brief Float versus fixed-point angle -> PWM level conversion benchmark
+ *
+ * Times the full per-command conversion chain (angle -> pulse width ->
+ * counter level) of both PulseMapping paths and of the ServoCalibration
+ * table lookup Gimbal uses (float and Q16.16 input), one command at a
+ * time, and checks how far the fixed-point result deviates from the float
+ * one. Levels use the RP2040 slice configuration solvePicoPWMConfig()
+ * picks for 50 Hz at 125 MHz, converted with its real ticks per µs as
+ * PWMControllerPico does.
+ *
+ * A sweep of the solver over 50-400 Hz reports the worst period error,
+ * the coarsest tick rate and the cost of a solve, and checks that the
+ * solver reaches GIMBAL_PWM_MIN_FREQUENCY but not the rate below it.
+ *
+ * Usage: pulse_bench [--iterations N] [--json PATH]
+ *
+ * On a host with an FPU the float path is cheap; the figure that matters
+ * for the RP2040 is the float path's soft-float call count (clamp, divide,
+ * multiply, add, convert per stage) against a single float-to-int
+ * conversion on the fixed-point path.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using ServoMapping = PulseMapping<1000, 2000, 90>;
+
+constexpr uint32_t FREQUENCY = 50;
+constexpr size_t PATTERN_SIZE = 4096;
+constexpr uint32_t SWEEP_MIN_HZ = 50;
+constexpr uint32_t SWEEP_MAX_HZ = 400;
+
+struct Result {
+    double ns_per_command;
+    double cycles_per_command;   // 0 when no cycle counter is available
+};
+
+/// Keep a value alive without letting the compiler batch or vectorize commands
+inline void consume(uint32_t value) {
+    asm volatile("" : : "r"(value) : "memory");
+}
+
+/// Pulse width -> counter level with the slice's float tick rate
+inline uint32_t levelFloat(const PicoPWMConfig& config, uint32_t pulse_width_us) {
+    uint32_t counts = static_cast<uint32_t>(static_cast<float>(pulse_width_us) * config.counts_per_us + 0.5f);
+    return counts > config.wrap ? config.wrap : counts;
+}
+
+/// Pulse width -> counter level with the slice's Q20.12 tick rate
+inline uint32_t levelFixed(const PicoPWMConfig& config, uint32_t pulse_width_us) {
+    uint32_t counts = (pulse_width_us * config.counts_per_us_q12 + 2048u) >> 12;
+    return counts > config.wrap ? config.wrap : counts;
+}
+
+inline uint64_t cycles() {
+#ifdef PULSE_BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+template <typename Convert>
+Result run(const std::vector<float>& angles, uint64_t iterations, Convert convert) {
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        consume(convert(angles[i]));
+    }
+
+    auto t0 = Clock::now();
+    uint64_t c0 = cycles();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        consume(convert(angles[i % PATTERN_SIZE]));
+    }
+    uint64_t c1 = cycles();
+    auto t1 = Clock::now();
+
+    Result result;
+    result.ns_per_command = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                            static_cast<double>(iterations);
+    result.cycles_per_command = static_cast<double>(c1 - c0) / static_cast<double>(iterations);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 20000000;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--iterations") == 0 && value) {
+            iterations = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (iterations == 0) {
+        return 2;
+    }
+
+    std::vector<float> angles(PATTERN_SIZE);
+    uint32_t lcg = 12345;
+    for (auto& angle : angles) {
+        lcg = lcg * 1664525u + 1013904223u;
+        angle = static_cast<float>(lcg >> 8) / 16777216.0f * 180.0f - 90.0f;
+    }
+
+    PicoPWMConfig slice{};
+    if (!solvePicoPWMConfig(PWMControllerPico::SIM_SYS_CLOCK_HZ, FREQUENCY, slice)) {
+        std::fprintf(stderr, "No slice configuration for %u Hz\n", static_cast<unsigned>(FREQUENCY));
+        return 1;
+    }
+    auto float_path = [&slice](float angle) -> uint32_t {
+        return levelFloat(slice, ServoMapping::toPulseFloat(angle));
+    };
+    auto fixed_path = [&slice](float angle) -> uint32_t {
+        return levelFixed(slice, ServoMapping::toPulseFixed(angle));
+    };
+
+    // Accuracy over a fine sweep: pulse widths in µs and counter levels
+    uint32_t max_pulse_error = 0;
+    uint32_t max_level_error = 0;
+    for (int step = -90000; step <= 90000; ++step) {
+        float angle = static_cast<float>(step) / 1000.0f;
+        uint32_t a = ServoMapping::toPulseFloat(angle);
+        uint32_t b = ServoMapping::toPulseFixed(angle);
+        uint32_t la = float_path(angle);
+        uint32_t lb = fixed_path(angle);
+        max_pulse_error = std::max(max_pulse_error, a > b ? a - b : b - a);
+        max_level_error = std::max(max_level_error, la > lb ? la - lb : lb - la);
+    }
+
+    const ServoCalibration calibration;
+    auto table_float_path = [&calibration, &slice](float angle) -> uint32_t {
+        return levelFloat(slice, calibration.toPulseWidth(angle));
+    };
+    auto table_fixed_path = [&calibration, &slice](float angle) -> uint32_t {
+        return levelFixed(slice, calibration.toPulseWidthQ16(static_cast<int32_t>(angle * 65536.0f)));
+    };
+
+    Result float_result = run(angles, iterations, float_path);
+    Result fixed_result = run(angles, iterations, fixed_path);
+    Result table_float_result = run(angles, iterations, table_float_path);
+    Result table_fixed_result = run(angles, iterations, table_fixed_path);
+
+    // Solver sweep: every integer rate, the period the slice really produces
+    double max_error_ppm = 0.0;
+    float min_counts_per_us = 0.0f;
+    uint32_t unsolved = 0;
+    auto s0 = Clock::now();
+    for (uint32_t hz = SWEEP_MIN_HZ; hz <= SWEEP_MAX_HZ; ++hz) {
+        PicoPWMConfig config{};
+        if (!solvePicoPWMConfig(PWMControllerPico::SIM_SYS_CLOCK_HZ, hz, config)) {
+            ++unsolved;
+            continue;
+        }
+        double error_ppm = std::fabs(static_cast<double>(config.actual_frequency) / hz - 1.0) * 1e6;
+        max_error_ppm = std::max(max_error_ppm, error_ppm);
+        if (min_counts_per_us == 0.0f || config.counts_per_us < min_counts_per_us) {
+            min_counts_per_us = config.counts_per_us;
+        }
+    }
+    const double solve_us = std::chrono::duration<double, std::micro>(Clock::now() - s0).count() /
+                            static_cast<double>(SWEEP_MAX_HZ - SWEEP_MIN_HZ + 1);
+    PicoPWMConfig edge{};
+    const bool range_ok = solvePicoPWMConfig(PWMControllerPico::SIM_SYS_CLOCK_HZ, GIMBAL_PWM_MIN_FREQUENCY, edge) &&
+                          !solvePicoPWMConfig(PWMControllerPico::SIM_SYS_CLOCK_HZ, GIMBAL_PWM_MIN_FREQUENCY - 1, edge);
+    // The float reading of the error has ~0.1 ppm of rounding on top
+    const bool sweep_ok = unsolved == 0 && max_error_ppm <= PICO_PWM_MAX_PERIOD_ERROR_PPM + 1.0 && range_ok;
+
+    std::fprintf(stderr, "=== pulse_bench ===\n");
+    std::fprintf(stderr, "iterations:   %llu\n", static_cast<unsigned long long>(iterations));
+    std::fprintf(stderr, "float path:   %.2f ns/command (%.1f cycles)\n",
+                 float_result.ns_per_command, float_result.cycles_per_command);
+    std::fprintf(stderr, "fixed path:   %.2f ns/command (%.1f cycles)\n",
+                 fixed_result.ns_per_command, fixed_result.cycles_per_command);
+    std::fprintf(stderr, "table float:  %.2f ns/command (%.1f cycles)\n",
+                 table_float_result.ns_per_command, table_float_result.cycles_per_command);
+    std::fprintf(stderr, "table fixed:  %.2f ns/command (%.1f cycles)\n",
+                 table_fixed_result.ns_per_command, table_fixed_result.cycles_per_command);
+    std::fprintf(stderr, "max deviation: %u us pulse, %u counter levels (%.3f ticks/us at %u Hz)\n",
+                 max_pulse_error, max_level_error, static_cast<double>(slice.counts_per_us),
+                 static_cast<unsigned>(FREQUENCY));
+    std::fprintf(stderr, "solver sweep: %u-%u Hz, %u unsolved, max period error %.1f ppm, min %.3f ticks/us, "
+                         "%.2f us/solve\n",
+                 static_cast<unsigned>(SWEEP_MIN_HZ), static_cast<unsigned>(SWEEP_MAX_HZ),
+                 static_cast<unsigned>(unsolved), max_error_ppm, static_cast<double>(min_counts_per_us), solve_us);
+    std::fprintf(stderr, "solver range: %u Hz %s\n", static_cast<unsigned>(GIMBAL_PWM_MIN_FREQUENCY),
+                 range_ok ? "lowest reachable (ok)" : "does not match the solver (FAILED)");
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"pulse_bench\",\n"
+                 "  \"iterations\": %llu,\n"
+                 "  \"float\": {\"ns_per_command\": %.3f, \"cycles_per_command\": %.2f},\n"
+                 "  \"fixed\": {\"ns_per_command\": %.3f, \"cycles_per_command\": %.2f},\n"
+                 "  \"table_float\": {\"ns_per_command\": %.3f, \"cycles_per_command\": %.2f},\n"
+                 "  \"table_fixed\": {\"ns_per_command\": %.3f, \"cycles_per_command\": %.2f},\n"
+                 "  \"max_pulse_error_us\": %u,\n"
+                 "  \"max_level_error\": %u,\n"
+                 "  \"solver_sweep\": {\"min_hz\": %u, \"max_hz\": %u, \"unsolved\": %u, "
+                 "\"max_period_error_ppm\": %.2f, \"min_counts_per_us\": %.4f, \"us_per_solve\": %.3f}\n"
+                 "}\n",
+                 static_cast<unsigned long long>(iterations),
+                 float_result.ns_per_command, float_result.cycles_per_command,
+                 fixed_result.ns_per_command, fixed_result.cycles_per_command,
+                 table_float_result.ns_per_command, table_float_result.cycles_per_command,
+                 table_fixed_result.ns_per_command, table_fixed_result.cycles_per_command,
+                 max_pulse_error, max_level_error,
+                 static_cast<unsigned>(SWEEP_MIN_HZ), static_cast<unsigned>(SWEEP_MAX_HZ),
+                 static_cast<unsigned>(unsolved), max_error_ppm, static_cast<double>(min_counts_per_us), solve_us);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return sweep_ok ? 0 : 1;
+}
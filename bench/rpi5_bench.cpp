@@ -0,0 +1,222 @@
+#include "PWMControllerRPi5.h"
+#include <lgpio.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * @brief PWMControllerRPi5 per-write cost over the simulated lgpio layer
+ *
+ * Builds the real RPi5 backend against bench/lgpio_sim, an in-memory lgpio
+ * stand-in, so what is timed is the backend's own bookkeeping (pin
+ * validation, duplicate suppression, duty computation) plus one trivial
+ * lgTxPwm call. Eight pins are claimed, as on a board driving several
+ * heads, and writes cycle over them.
+ *
+ * Usage: rpi5_bench [--iterations N] [--json PATH]
+ *
+ * The "tree reference" row replays the same writes through the std::set /
+ * std::map bookkeeping the backend used before, for comparison.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t FREQUENCY = 50;
+constexpr uint32_t PERIOD_US = 20000;
+constexpr uint32_t FAST_PERIOD_US = 3003;   // 333 Hz
+constexpr uint32_t PINS[] = {12, 13, 17, 18, 22, 23, 24, 27};
+constexpr size_t PIN_COUNT = sizeof(PINS) / sizeof(PINS[0]);
+constexpr size_t PATTERN_SIZE = 4096;
+
+/// The previous backend's bookkeeping: a claimed set plus a per-pin map
+class TreeReference {
+public:
+    void initPin(uint32_t pin) {
+        claimed_.insert(pin);
+        state_[pin] = State{FREQUENCY, 0, 0};
+    }
+
+    bool setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+        auto it = state_.find(pin);
+        if (!claimed_.count(pin) || it == state_.end() || period_us == 0) {
+            return false;
+        }
+        State& state = it->second;
+        if (state.pulse_width_us == pulse_width_us && state.period_us == period_us) {
+            return true;
+        }
+        double duty = (static_cast<double>(pulse_width_us) / static_cast<double>(period_us)) * 100.0;
+        if (lgTxPwm(0, static_cast<int>(pin), static_cast<float>(state.frequency), static_cast<float>(duty), 0, 0) < 0) {
+            state.pulse_width_us = 0;
+            return false;
+        }
+        state.pulse_width_us = pulse_width_us;
+        state.period_us = period_us;
+        return true;
+    }
+
+private:
+    struct State {
+        uint32_t frequency;
+        uint32_t pulse_width_us;
+        uint32_t period_us;
+    };
+
+    std::set<uint32_t> claimed_;
+    std::map<uint32_t, State> state_;
+};
+
+template <typename Write>
+double nsPerWrite(uint64_t iterations, Write write) {
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        write(i);
+    }
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        write(i);
+    }
+    auto t1 = Clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 10000000;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--iterations") == 0 && value) {
+            iterations = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (iterations == 0) {
+        return 2;
+    }
+
+    // Pulses that change on every write to a given pin
+    std::vector<uint32_t> pulses(PATTERN_SIZE);
+    uint32_t lcg = 12345;
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        lcg = lcg * 1664525u + 1013904223u;
+        pulses[i] = 1000 + (lcg >> 8) % 1000;
+        if (i >= PIN_COUNT && pulses[i] == pulses[i - PIN_COUNT]) {
+            pulses[i] += 1;
+        }
+    }
+
+    PWMControllerRPi5 pwm;
+    TreeReference reference;
+    for (uint32_t pin : PINS) {
+        if (!pwm.initPin(pin, FREQUENCY)) {
+            std::fprintf(stderr, "Failed to initialize pin %u\n", static_cast<unsigned>(pin));
+            return 1;
+        }
+        reference.initPin(pin);
+    }
+
+    uint64_t failures = 0;
+    uint64_t calls_before = lgSimTxPwmCalls();
+    double flat_ns = nsPerWrite(iterations, [&](uint64_t i) {
+        failures += pwm.setPulseWidth(PINS[i % PIN_COUNT], pulses[i % PATTERN_SIZE], PERIOD_US) ? 0 : 1;
+    });
+    uint64_t tx_calls = lgSimTxPwmCalls() - calls_before;
+
+    double unchanged_ns = nsPerWrite(iterations, [&](uint64_t i) {
+        failures += pwm.setPulseWidth(PINS[i % PIN_COUNT], 1500, PERIOD_US) ? 0 : 1;
+    });
+
+    // Two-axis batch, as Gimbal issues it
+    double batch_ns = nsPerWrite(iterations, [&](uint64_t i) {
+        size_t k = (2 * i) % PATTERN_SIZE;
+        PulseCommand commands[2] = {
+            PulseCommand{PINS[2], pulses[k], PERIOD_US},
+            PulseCommand{PINS[7], pulses[k + 1], PERIOD_US},
+        };
+        failures += pwm.setPulseWidths(commands, 2) ? 0 : 1;
+    }) / 2.0;
+
+    double invalid_ns = nsPerWrite(iterations, [&](uint64_t i) {
+        failures += pwm.setPulseWidth(40 + static_cast<uint32_t>(i % 8), 1500, PERIOD_US) ? 0 : 1;
+    });
+    uint64_t expected_failures = iterations + PATTERN_SIZE;
+
+    double tree_ns = nsPerWrite(iterations, [&](uint64_t i) {
+        failures += reference.setPulseWidth(PINS[i % PIN_COUNT], pulses[i % PATTERN_SIZE], PERIOD_US) ? 0 : 1;
+    });
+
+    // The last value written to a pin must reach the line unchanged
+    bool duty_ok = pwm.setPulseWidth(PINS[0], 1234, PERIOD_US) &&
+                   std::fabs(lgSimDuty(static_cast<int>(PINS[0])) - 6.17f) < 1e-4f;
+    // A shorter period must change the line's frame rate, not only the duty
+    // cycle (digital servos at 333 Hz); one past the frame is rejected
+    bool rate_ok = pwm.setPulseWidth(PINS[1], 1500, FAST_PERIOD_US) &&
+                   std::fabs(lgSimFrequency(static_cast<int>(PINS[1])) - 333.0f) < 0.1f &&
+                   std::fabs(lgSimDuty(static_cast<int>(PINS[1])) - 49.95f) < 1e-2f &&
+                   !pwm.setPulseWidth(PINS[1], FAST_PERIOD_US, FAST_PERIOD_US);
+
+    // A batch with an unclaimed pin still writes the valid commands
+    // (PWMController::setPulseWidths contract) and reports the bad one
+    PulseCommand mixed[3] = {
+        PulseCommand{PINS[3], 1100, PERIOD_US},
+        PulseCommand{40, 1500, PERIOD_US},
+        PulseCommand{PINS[4], 1900, PERIOD_US},
+    };
+    GimbalStatus mixed_status = pwm.setPulseWidths(mixed, 3);
+    bool batch_ok = mixed_status.error() == GimbalError::PinNotInitialized && mixed_status.pin() == 40 &&
+                    std::fabs(lgSimDuty(static_cast<int>(PINS[3])) - 5.5f) < 1e-4f &&
+                    std::fabs(lgSimDuty(static_cast<int>(PINS[4])) - 9.5f) < 1e-4f;
+
+    std::fprintf(stderr, "=== rpi5_bench (simulated lgpio) ===\n");
+    std::fprintf(stderr, "iterations:       %llu over %u pins\n",
+                 static_cast<unsigned long long>(iterations), static_cast<unsigned>(PIN_COUNT));
+    std::fprintf(stderr, "flat write:       %.2f ns/write (%llu lgTxPwm calls)\n",
+                 flat_ns, static_cast<unsigned long long>(tx_calls));
+    std::fprintf(stderr, "unchanged write:  %.2f ns/write\n", unchanged_ns);
+    std::fprintf(stderr, "batched (2 axes): %.2f ns/write\n", batch_ns);
+    std::fprintf(stderr, "unclaimed pin:    %.2f ns/write\n", invalid_ns);
+    std::fprintf(stderr, "tree reference:   %.2f ns/write\n", tree_ns);
+    std::fprintf(stderr, "failures:         %llu (expected %llu), duty check %s, frame rate check %s, "
+                         "batch check %s\n",
+                 static_cast<unsigned long long>(failures), static_cast<unsigned long long>(expected_failures),
+                 duty_ok ? "ok" : "FAILED", rate_ok ? "ok" : "FAILED", batch_ok ? "ok" : "FAILED");
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"rpi5_bench\",\n"
+                 "  \"iterations\": %llu,\n"
+                 "  \"pins\": %u,\n"
+                 "  \"flat_ns_per_write\": %.3f,\n"
+                 "  \"unchanged_ns_per_write\": %.3f,\n"
+                 "  \"batched_ns_per_write\": %.3f,\n"
+                 "  \"unclaimed_ns_per_write\": %.3f,\n"
+                 "  \"tree_reference_ns_per_write\": %.3f\n"
+                 "}\n",
+                 static_cast<unsigned long long>(iterations), static_cast<unsigned>(PIN_COUNT),
+                 flat_ns, unchanged_ns, batch_ns, invalid_ns, tree_ns);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return (failures == expected_failures && duty_ok && rate_ok && batch_ok) ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include "PWMControllerSysfs.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+/**
+ * @brief PWMControllerSysfs against a fake pwmchip tree
+ *
+ * Builds a pwmchip directory under the system temp directory with
+ * pre-exported pwm0..pwm3 channels (plain files standing in for the
+ * kernel's attributes), runs the sysfs backend against it and reads back
+ * what it wrote: period, duty cycle, enable and unexport. Also checks that
+ * a channel cannot be mapped to two pins, and times a duty-cycle update
+ * (one pwrite() to a tmpfs file here; the kernel attribute costs more).
+ *
+ * Usage: sysfs_bench [--iterations N] [--json PATH]
+ */
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t FREQUENCY = 50;
+constexpr uint32_t PERIOD_US = 20000;
+constexpr uint32_t FAST_PERIOD_US = 3003;   // 333 Hz
+constexpr uint32_t CHANNELS = 4;
+
+bool writeText(const fs::path& path, const char* text) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fputs(text, file);
+    return std::fclose(file) == 0;
+}
+
+/// First line of an attribute as a number (pwrite() leaves stale bytes after it)
+long readValue(const fs::path& path) {
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        return -1;
+    }
+    char line[32] = {};
+    bool ok = std::fgets(line, sizeof(line), file) != nullptr;
+    std::fclose(file);
+    return ok ? std::strtol(line, nullptr, 10) : -1;
+}
+
+bool makeChip(const fs::path& chip) {
+    std::error_code error;
+    for (uint32_t channel = 0; channel < CHANNELS; ++channel) {
+        fs::path dir = chip / ("pwm" + std::to_string(channel));
+        if (!fs::create_directories(dir, error) || !writeText(dir / "period", "0\n") ||
+            !writeText(dir / "duty_cycle", "0\n") || !writeText(dir / "enable", "0\n")) {
+            return false;
+        }
+    }
+    return writeText(chip / "export", "") && writeText(chip / "unexport", "");
+}
+
+bool check(const char* what, bool ok) {
+    std::fprintf(stderr, "%-36s %s\n", what, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 1000000;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--iterations") == 0 && value) {
+            iterations = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (iterations == 0) {
+        return 2;
+    }
+
+    std::string pattern = (fs::temp_directory_path() / "sysfs_bench.XXXXXX").string();
+    if (!mkdtemp(&pattern[0])) {
+        std::fprintf(stderr, "Cannot create a temporary directory\n");
+        return 1;
+    }
+    const fs::path root = pattern;
+    const fs::path chip = root / "pwmchip0";
+    if (!makeChip(chip)) {
+        std::fprintf(stderr, "Cannot build the fake pwmchip under %s\n", root.c_str());
+        fs::remove_all(root);
+        return 1;
+    }
+
+    std::fprintf(stderr, "=== sysfs_bench (fake pwmchip in %s) ===\n", root.c_str());
+    bool ok = true;
+    double update_ns = 0.0;
+    {
+        PWMControllerSysfs pwm(chip.string());
+
+        // Default mapping: GPIO 12 -> pwm0, 13 -> pwm1
+        ok &= check("init pin 12, 13", pwm.initPin(12, FREQUENCY) && pwm.initPin(13, FREQUENCY));
+        ok &= check("period 20 ms, duty 0, enabled",
+                    readValue(chip / "pwm0/period") == 20000000 && readValue(chip / "pwm0/duty_cycle") == 0 &&
+                        readValue(chip / "pwm0/enable") == 1);
+        ok &= check("duty 1500 us",
+                    pwm.setPulseWidth(12, 1500, PERIOD_US) && readValue(chip / "pwm0/duty_cycle") == 1500000);
+        ok &= check("333 Hz frame",
+                    pwm.setPulseWidth(13, 1000, FAST_PERIOD_US) && readValue(chip / "pwm1/period") == 3003000 &&
+                        readValue(chip / "pwm1/duty_cycle") == 1000000);
+        ok &= check("pulse past the frame rejected", !pwm.setPulseWidth(13, FAST_PERIOD_US, FAST_PERIOD_US));
+
+        // One channel, one pin
+        ok &= check("channel of pin 12 refused to pin 5", !pwm.mapPin(5, 0));
+        ok &= check("channel of pin 18 refused to pin 5", !pwm.mapPin(5, 2));
+        ok &= check("pin 18 unmapped, channel to pin 5", pwm.unmapPin(18) && pwm.mapPin(5, 2));
+        ok &= check("pin 18 remap refused", !pwm.mapPin(18, 2));
+        ok &= check("unmapped pin 18 not initialized", !pwm.initPin(18, FREQUENCY));
+        ok &= check("active pin 12 not remapped", !pwm.mapPin(12, 3) && !pwm.unmapPin(12));
+
+        // Alternating duty values, so every update is written
+        uint64_t failures = 0;
+        auto t0 = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            failures += pwm.setPulseWidth(12, 1000 + static_cast<uint32_t>(i & 1023), PERIOD_US) ? 0 : 1;
+        }
+        auto t1 = Clock::now();
+        update_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations);
+        ok &= check("duty updates", failures == 0);
+        ok &= check("last duty reaches the file",
+                    readValue(chip / "pwm0/duty_cycle") ==
+                        static_cast<long>(1000 + ((iterations - 1) & 1023)) * 1000);
+
+        ok &= check("shutdown disables and unexports",
+                    pwm.shutdownPin(12) && readValue(chip / "pwm0/enable") == 0 &&
+                        readValue(chip / "unexport") == 0);
+    }
+    // The destructor shuts down the pins still active
+    ok &= check("destructor disables pin 13", readValue(chip / "pwm1/enable") == 0);
+    std::fprintf(stderr, "duty update:                         %.1f ns/write over %llu writes\n", update_ns,
+                 static_cast<unsigned long long>(iterations));
+    fs::remove_all(root);
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out,
+                 "{\n"
+                 "  \"benchmark\": \"sysfs_bench\",\n"
+                 "  \"iterations\": %llu,\n"
+                 "  \"duty_update_ns\": %.3f,\n"
+                 "  \"checks_passed\": %s\n"
+                 "}\n",
+                 static_cast<unsigned long long>(iterations), update_ns, ok ? "true" : "false");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+#include "BasicGimbal.h"
+#include "Gimbal.h"
+#include "GimbalBackends.h"
+#include "PWMControllerPico.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TEMPLATE_BENCH_HAVE_TSC 1
+#endif
+
+/**
+ * @brief Type-erased Gimbal versus compile-time BasicGimbal per-command cost
+ *
+ * Drives the same angle pattern through four builds of the command path,
+ * all ending in the RP2040 PWM backend (simulated compare registers on the
+ * host, so no hardware access is timed):
+ *
+ * - gimbal:  Gimbal over a shared_ptr<PWMControllerPico>: virtual call,
+ *            runtime pins, write and error counters, telemetry record
+ * - dynamic: BasicGimbal<DynamicBackend, ServoCalibration>: the same
+ *            virtual call without Gimbal's bookkeeping
+ * - static:  BasicGimbal<ControllerBackend<PWMControllerPico, 16, 17>,
+ *            ServoCalibration>: controller called non-virtually
+ * - inline:  BasicGimbal<PicoServoBackend<16, 17>, MG90SStaticCalibration>:
+ *            mapping constants and register offsets folded, no call left
+ *
+ * Usage: template_bench [--iterations N] [--json PATH]
+ *
+ * The deadzone is disabled so nearly every command writes both axes.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t PAN_PIN = 16;
+constexpr uint32_t TILT_PIN = 17;
+constexpr size_t PATTERN_SIZE = 4096;
+
+using DynamicGimbal = BasicGimbal<DynamicBackend, ServoCalibration>;
+using StaticBackend = ControllerBackend<PWMControllerPico, PAN_PIN, TILT_PIN>;
+using StaticGimbal = BasicGimbal<StaticBackend, ServoCalibration>;
+using InlineGimbal = BasicGimbal<PicoServoBackend<PAN_PIN, TILT_PIN>, MG90SStaticCalibration>;
+
+struct Result {
+    double ns_per_command;
+    double cycles_per_command;   // 0 when no cycle counter is available
+    uint64_t failures;
+};
+
+/// Keep a result alive without letting the compiler batch commands
+inline void consume(uint32_t value) {
+    asm volatile("" : : "r"(value) : "memory");
+}
+
+inline uint64_t cycles() {
+#ifdef TEMPLATE_BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+template <typename Target>
+Result run(Target& target, const std::vector<float>& pan, const std::vector<float>& tilt, uint64_t iterations) {
+    Result result{};
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        consume(static_cast<uint32_t>(target.setTipAngle(pan[i], tilt[i]).error()));
+    }
+
+    auto t0 = Clock::now();
+    uint64_t c0 = cycles();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        size_t k = i % PATTERN_SIZE;
+        GimbalStatus status = target.setTipAngle(pan[k], tilt[k]);
+        result.failures += status ? 0 : 1;
+        consume(static_cast<uint32_t>(status.error()));
+    }
+    uint64_t c1 = cycles();
+    auto t1 = Clock::now();
+
+    result.ns_per_command = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                            static_cast<double>(iterations);
+    result.cycles_per_command = static_cast<double>(c1 - c0) / static_cast<double>(iterations);
+    return result;
+}
+
+void printResult(const char* name, const Result& result) {
+    std::fprintf(stderr, "%-8s %7.2f ns/command (%6.1f cycles)  failures %llu\n", name,
+                 result.ns_per_command, result.cycles_per_command,
+                 static_cast<unsigned long long>(result.failures));
+}
+
+void printJson(FILE* out, const char* name, const Result& result, bool last) {
+    std::fprintf(out, "  \"%s\": {\"ns_per_command\": %.3f, \"cycles_per_command\": %.2f, \"failures\": %llu}%s\n",
+                 name, result.ns_per_command, result.cycles_per_command,
+                 static_cast<unsigned long long>(result.failures), last ? "" : ",");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 10000000;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--iterations") == 0 && value) {
+            iterations = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (iterations == 0) {
+        return 2;
+    }
+
+    std::vector<float> pan(PATTERN_SIZE);
+    std::vector<float> tilt(PATTERN_SIZE);
+    uint32_t lcg = 12345;
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        lcg = lcg * 1664525u + 1013904223u;
+        pan[i] = static_cast<float>(lcg >> 8) / 16777216.0f * 180.0f - 90.0f;
+        lcg = lcg * 1664525u + 1013904223u;
+        tilt[i] = static_cast<float>(lcg >> 8) / 16777216.0f * 180.0f - 90.0f;
+    }
+
+    const ServoCalibration calibration = ServoCalibration::fromConfig();
+
+    Gimbal gimbal(std::make_shared<PWMControllerPico>(), PAN_PIN, TILT_PIN);
+    DynamicGimbal dynamic(DynamicBackend(std::make_shared<PWMControllerPico>(), PAN_PIN, TILT_PIN),
+                          calibration, calibration);
+    PWMControllerPico static_controller;
+    StaticGimbal static_gimbal(StaticBackend(static_controller), calibration, calibration);
+    InlineGimbal inline_gimbal;
+
+    if (!gimbal.init() || !dynamic.init() || !static_gimbal.init() || !inline_gimbal.init()) {
+        std::fprintf(stderr, "Gimbal initialization failed\n");
+        return 1;
+    }
+    gimbal.setDeadzone(0.0f);
+    dynamic.setDeadzone(0.0f);
+    static_gimbal.setDeadzone(0.0f);
+    inline_gimbal.setDeadzone(0.0f);
+
+    // Same pulses from the table and the folded mapping (within rounding)
+    uint32_t max_pulse_error = 0;
+    for (size_t i = 0; i < PATTERN_SIZE; ++i) {
+        uint32_t a = StaticGimbal::toPulse(calibration, pan[i]);
+        uint32_t b = InlineGimbal::toPulse(MG90SStaticCalibration(), pan[i]);
+        uint32_t error = a > b ? a - b : b - a;
+        max_pulse_error = error > max_pulse_error ? error : max_pulse_error;
+    }
+
+    Result gimbal_result = run(gimbal, pan, tilt, iterations);
+    Result dynamic_result = run(dynamic, pan, tilt, iterations);
+    Result static_result = run(static_gimbal, pan, tilt, iterations);
+    Result inline_result = run(inline_gimbal, pan, tilt, iterations);
+
+    std::fprintf(stderr, "=== template_bench ===\n");
+    std::fprintf(stderr, "iterations: %llu\n", static_cast<unsigned long long>(iterations));
+    printResult("gimbal", gimbal_result);
+    printResult("dynamic", dynamic_result);
+    printResult("static", static_result);
+    printResult("inline", inline_result);
+    std::fprintf(stderr, "table vs folded mapping: max %u us apart\n", max_pulse_error);
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"template_bench\",\n  \"iterations\": %llu,\n",
+                 static_cast<unsigned long long>(iterations));
+    printJson(out, "gimbal", gimbal_result, false);
+    printJson(out, "dynamic", dynamic_result, false);
+    printJson(out, "static", static_result, false);
+    printJson(out, "inline", inline_result, false);
+    std::fprintf(out, "  \"max_pulse_error_us\": %u\n}\n", max_pulse_error);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
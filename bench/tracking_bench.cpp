@@ -0,0 +1,368 @@
+#include "Gimbal.h"
+#include "MotionProfile.h"
+#include "PWMControllerServoSim.h"
+#include "ServoProfile.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+/**
+ * @brief Closed-loop tracking of the control path on simulated servos
+ *
+ * Drives a Gimbal over PWMControllerServoSim, one command per PWM frame,
+ * through five scenarios for every servo model at 50 Hz and for the
+ * DIGITAL profile at GIMBAL_PWM_MAX_FREQUENCY:
+ *
+ * - step:    -30 to +30 degrees
+ * - ramp:    -45 to +45 degrees at 90 degrees/s, then hold
+ * - sine:    20 degrees amplitude at 1 Hz
+ * - walk:    random walk of the target velocity (seeded)
+ * - retgt:   -45 to +45 degrees at 60 degrees/s through a MotionProfile
+ *            retargeted every 20 ms, as a client streaming setpoints
+ *
+ * Tilt follows the same trajectory at half the amplitude. Commands land
+ * mid-frame, the average case for a loop not synchronized to the PWM.
+ * Reported per scenario: settling time (both axes within 2% of their move,
+ * or within the servo's dead band if wider) and overshoot for step and ramp, RMS tracking error of the horns
+ * against the ideal trajectory, and the host rate of setTipAngle() on
+ * this backend.
+ *
+ * Usage: tracking_bench [--seed N] [--json PATH]
+ *
+ * Exit status is nonzero if a step, ramp or retarget run does not settle,
+ * the retargeted profile falls further behind its ramp than RETARGET_MAX_LAG,
+ * or the 333 Hz DIGITAL step does not settle faster than the 50 Hz one.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t PAN_PIN = 17;
+constexpr uint32_t TILT_PIN = 27;
+constexpr uint64_t SAMPLE_NS = 250000;
+constexpr float TILT_SCALE = 0.5f;
+constexpr float SETTLE_BAND = 0.02f;
+
+// Retarget scenario: GimbalController's path for mailbox / UDP clients
+constexpr AxisLimits RETARGET_LIMITS = {200.0f, 1000.0f, 10000.0f};
+constexpr uint64_t RETARGET_NS = 20000000;
+constexpr float RETARGET_SPEED = 60.0f;
+/// Braking distance from the ramp speed plus one retarget interval of travel, doubled
+constexpr float RETARGET_MAX_LAG =
+    2.0f * (0.5f * RETARGET_SPEED *
+                (RETARGET_SPEED / RETARGET_LIMITS.max_acceleration +
+                 RETARGET_LIMITS.max_acceleration / RETARGET_LIMITS.max_jerk) +
+            RETARGET_SPEED * static_cast<float>(RETARGET_NS) * 1e-9f);
+
+enum class Scenario { Step, Ramp, Sine, Walk, Retarget };
+
+const char* const SCENARIO_NAMES[] = {"step", "ramp", "sine", "walk", "retgt"};
+constexpr size_t SCENARIO_COUNT = 5;
+
+struct Config {
+    ServoModel model;
+    uint32_t rate_hz;
+};
+
+const Config CONFIGS[] = {
+    {ServoModel::MG90S, 50},   {ServoModel::SG90, 50},    {ServoModel::HS422, 50},
+    {ServoModel::MG996R, 50},  {ServoModel::DIGITAL, 50}, {ServoModel::DIGITAL, GIMBAL_PWM_MAX_FREQUENCY},
+};
+constexpr size_t CONFIG_COUNT = sizeof(CONFIGS) / sizeof(CONFIGS[0]);
+
+struct Row {
+    const char* model;
+    uint32_t rate_hz;
+    Scenario scenario;
+    bool has_settling;   ///< step, ramp and retarget end on a fixed target
+    bool settled;
+    double settling_ms;
+    double overshoot_pct;
+    double rms_deg;
+    double lag_deg;      ///< Retarget: largest lag of the profile behind the ramp
+    double commands_per_s;
+    uint64_t commands;
+};
+
+/// xorshift64: fast and reproducible
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/// Uniform in [-1, 1)
+float uniform(uint64_t& state) {
+    return static_cast<float>(nextRandom(state) >> 40) / static_cast<float>(1ull << 23) - 1.0f;
+}
+
+/**
+ * @brief Ideal pan trajectory of a scenario
+ *
+ * The random walk is integrated at SAMPLE_NS, so it is only defined for
+ * times on that grid; walk_angle carries its state between calls.
+ */
+struct Trajectory {
+    Scenario scenario;
+    uint64_t rng;
+    float walk_angle;
+    float walk_velocity;
+
+    float start() const {
+        return scenario == Scenario::Step                                   ? -30.0f
+               : scenario == Scenario::Ramp || scenario == Scenario::Retarget ? -45.0f
+                                                                              : 0.0f;
+    }
+
+    float finish() const { return scenario == Scenario::Step ? 30.0f : 45.0f; }
+
+    double duration() const {
+        return scenario == Scenario::Step       ? 1.5
+               : scenario == Scenario::Ramp     ? 2.0
+               : scenario == Scenario::Retarget ? 2.5
+                                                : 5.0;
+    }
+
+    /// Time at which a step or ramp reaches its final value
+    double arrival() const {
+        return scenario == Scenario::Ramp ? 1.0 : scenario == Scenario::Retarget ? 90.0 / RETARGET_SPEED : 0.0;
+    }
+
+    float at(double t) {
+        switch (scenario) {
+        case Scenario::Step:
+            return t < 0.0 ? start() : finish();
+        case Scenario::Ramp:
+            return t < 0.0 ? start() : static_cast<float>(start() + 90.0 * std::min(t, 1.0));
+        case Scenario::Retarget:
+            return t < 0.0 ? start() : static_cast<float>(start() + RETARGET_SPEED * std::min(t, arrival()));
+        case Scenario::Sine:
+            return static_cast<float>(20.0 * std::sin(6.283185307179586 * t));
+        case Scenario::Walk:
+        default:
+            return walk_angle;
+        }
+    }
+
+    void stepWalk(float dt) {
+        // Velocity does a bounded random walk; the angle reflects at +/-60 degrees
+        walk_velocity = std::min(std::max(walk_velocity + 8000.0f * uniform(rng) * dt, -120.0f), 120.0f);
+        walk_angle += walk_velocity * dt;
+        if (std::fabs(walk_angle) > 60.0f) {
+            walk_angle = std::copysign(60.0f, walk_angle);
+            walk_velocity = -walk_velocity;
+        }
+    }
+};
+
+Row run(const Config& config, Scenario scenario, uint64_t seed) {
+    const ServoProfile& profile = getServoProfile(config.model);
+    Row row{};
+    row.model = profile.name;
+    row.rate_hz = config.rate_hz;
+    row.scenario = scenario;
+    row.has_settling = scenario == Scenario::Step || scenario == Scenario::Ramp || scenario == Scenario::Retarget;
+
+    auto sim = std::make_shared<PWMControllerServoSim>();
+    sim->attachServo(PAN_PIN, config.model);
+    sim->attachServo(TILT_PIN, config.model);
+    Gimbal gimbal(sim, PAN_PIN, TILT_PIN);
+    GimbalCalibration calibration;
+    calibration.pan = ServoCalibration::forModel(config.model);
+    calibration.tilt = calibration.pan;
+    gimbal.setCalibration(calibration);
+    if (!gimbal.setFrameRate(config.rate_hz, config.rate_hz, config.model, config.model) || !gimbal.init()) {
+        return row;
+    }
+
+    // Start at rest on the trajectory's initial point
+    Trajectory trajectory{scenario, seed, 0.0f, 0.0f};
+    const float start = trajectory.start();
+    gimbal.setTipAngle(start, start * TILT_SCALE);
+    sim->setServoAngle(PAN_PIN, start);
+    sim->setServoAngle(TILT_PIN, start * TILT_SCALE);
+    const uint64_t period_ns = 1000000000ull / config.rate_hz;
+    sim->advance(2 * period_ns);
+    MotionProfile motion;
+    motion.setLimits(RETARGET_LIMITS, RETARGET_LIMITS);
+    motion.reset(start, start * TILT_SCALE);
+    uint64_t next_retarget = 0;
+
+    const uint64_t t0 = sim->now();
+    const uint64_t duration_ns = static_cast<uint64_t>(trajectory.duration() * 1e9);
+    uint64_t next_command = period_ns / 2;
+    double squared = 0.0;
+    uint64_t samples = 0;
+    double command_ns = 0.0;
+    uint64_t last_outside_ns = 0;
+    double overshoot = 0.0;
+    const float move = trajectory.finish() - start;
+
+    // A servo may stop anywhere within its dead band of the target: the band
+    // is 2% of the axis' move, but no narrower than the dead band
+    const float degrees_per_us = (calibration.pan.getMaxAngle() - calibration.pan.getMinAngle()) /
+                                 (calibration.pan.evaluate(calibration.pan.getMaxAngle()) -
+                                  calibration.pan.evaluate(calibration.pan.getMinAngle()));
+    const float deadband = static_cast<float>(profile.deadband_us) * degrees_per_us;
+    const float pan_band = std::max(SETTLE_BAND * std::fabs(move), deadband);
+    const float tilt_band = std::max(SETTLE_BAND * std::fabs(move) * TILT_SCALE, deadband);
+
+    for (uint64_t t = 0; t <= duration_ns; t += SAMPLE_NS) {
+        sim->advance(t0 + t - sim->now());
+        const double seconds = static_cast<double>(t) * 1e-9;
+        if (scenario == Scenario::Walk && t > 0) {
+            trajectory.stepWalk(static_cast<float>(SAMPLE_NS) * 1e-9f);
+        }
+        const float pan_target = trajectory.at(seconds);
+        float pan_command = pan_target;
+        float tilt_command = pan_target * TILT_SCALE;
+        if (scenario == Scenario::Retarget) {
+            // Each setpoint replans from the profile's current motion
+            if (t >= next_retarget) {
+                motion.setTarget(pan_target, pan_target * TILT_SCALE, t / 1000);
+                next_retarget += RETARGET_NS;
+            }
+            motion.sample(t / 1000, pan_command, tilt_command);
+            row.lag_deg = std::max(row.lag_deg, static_cast<double>(pan_target - pan_command));
+        }
+        if (t >= next_command) {
+            auto c0 = Clock::now();
+            gimbal.setTipAngle(pan_command, tilt_command);
+            command_ns += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - c0).count());
+            ++row.commands;
+            next_command += period_ns;
+        }
+
+        const float pan_error = sim->getServoAngle(PAN_PIN) - pan_target;
+        const float tilt_error = sim->getServoAngle(TILT_PIN) - pan_target * TILT_SCALE;
+        squared += static_cast<double>(pan_error) * pan_error + static_cast<double>(tilt_error) * tilt_error;
+        samples += 2;
+
+        if (row.has_settling) {
+            if (std::fabs(pan_error) > pan_band || std::fabs(tilt_error) > tilt_band) {
+                last_outside_ns = t;
+            }
+            if (seconds >= trajectory.arrival()) {
+                // Travel past the final value, in % of the move
+                overshoot = std::max(overshoot, 100.0 * (sim->getServoAngle(PAN_PIN) - trajectory.finish()) / move);
+            }
+        }
+    }
+
+    row.rms_deg = std::sqrt(squared / static_cast<double>(samples));
+    row.commands_per_s = command_ns > 0.0 ? 1e9 * static_cast<double>(row.commands) / command_ns : 0.0;
+    if (row.has_settling) {
+        // Settled if the horns spent the last 10% of the run inside the band
+        row.settled = last_outside_ns + duration_ns / 10 < duration_ns;
+        row.settling_ms = (static_cast<double>(last_outside_ns) * 1e-9 - trajectory.arrival()) * 1e3;
+        row.settling_ms = std::max(row.settling_ms, 0.0);
+        row.overshoot_pct = overshoot;
+    }
+    gimbal.shutdown();
+    return row;
+}
+
+void printMetric(FILE* out, const char* key, bool valid, double value, const char* suffix) {
+    if (valid) {
+        std::fprintf(out, "\"%s\": %.3f%s", key, value, suffix);
+    } else {
+        std::fprintf(out, "\"%s\": null%s", key, suffix);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--seed") == 0 && value) {
+            seed = std::strtoull(value, nullptr, 0);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--seed N] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (seed == 0) {
+        return 2;
+    }
+
+    Row rows[CONFIG_COUNT * SCENARIO_COUNT];
+    size_t count = 0;
+    bool settled = true;
+    double max_lag = 0.0;
+    auto t0 = Clock::now();
+    for (const Config& config : CONFIGS) {
+        for (size_t s = 0; s < SCENARIO_COUNT; ++s) {
+            Row& row = rows[count++];
+            row = run(config, static_cast<Scenario>(s), seed);
+            settled &= !row.has_settling || row.settled;
+            max_lag = std::max(max_lag, row.lag_deg);
+        }
+    }
+    const bool kept_up = max_lag <= RETARGET_MAX_LAG;
+    const double wall_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    // Step rows of DIGITAL at 50 Hz and at the top rate
+    const Row& digital_slow = rows[(CONFIG_COUNT - 2) * SCENARIO_COUNT];
+    const Row& digital_fast = rows[(CONFIG_COUNT - 1) * SCENARIO_COUNT];
+    const bool faster = digital_fast.settling_ms < digital_slow.settling_ms;
+
+    std::fprintf(stderr, "=== tracking_bench (simulated servos, 1 command per frame) ===\n");
+    std::fprintf(stderr, "%-8s %7s %-5s %10s %12s %9s %12s\n", "servo", "rate Hz", "test", "settle ms", "overshoot %",
+                 "rms deg", "commands/s");
+    for (size_t i = 0; i < count; ++i) {
+        const Row& row = rows[i];
+        char settle[16] = "-";
+        char overshoot[16] = "-";
+        if (row.has_settling) {
+            std::snprintf(settle, sizeof(settle), row.settled ? "%.1f" : "unsettled", row.settling_ms);
+            std::snprintf(overshoot, sizeof(overshoot), "%.1f", row.overshoot_pct);
+        }
+        std::fprintf(stderr, "%-8s %7u %-5s %10s %12s %9.2f %12.0f\n", row.model, row.rate_hz,
+                     SCENARIO_NAMES[static_cast<size_t>(row.scenario)], settle, overshoot, row.rms_deg,
+                     row.commands_per_s);
+    }
+    std::fprintf(stderr, "DIGITAL step settles in %.1f ms at %u Hz vs %.1f ms at %u Hz; %zu runs in %.2f s wall\n",
+                 digital_fast.settling_ms, digital_fast.rate_hz, digital_slow.settling_ms, digital_slow.rate_hz, count,
+                 wall_s);
+    std::fprintf(stderr, "retargeted profile lags its ramp by up to %.2f deg (limit %.2f)\n", max_lag,
+                 static_cast<double>(RETARGET_MAX_LAG));
+    std::fprintf(stderr, "settling %s, retarget %s\n", settled && faster ? "ok" : "FAILED", kept_up ? "ok" : "FAILED");
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"tracking_bench\",\n  \"seed\": %llu,\n  \"retarget_max_lag_deg\": %.3f,\n"
+                      "  \"results\": [\n",
+                 static_cast<unsigned long long>(seed), max_lag);
+    for (size_t i = 0; i < count; ++i) {
+        const Row& row = rows[i];
+        std::fprintf(out, "    {\"servo\": \"%s\", \"rate_hz\": %u, \"scenario\": \"%s\", ", row.model, row.rate_hz,
+                     SCENARIO_NAMES[static_cast<size_t>(row.scenario)]);
+        printMetric(out, "settling_ms", row.has_settling && row.settled, row.settling_ms, ", ");
+        printMetric(out, "overshoot_pct", row.has_settling, row.overshoot_pct, ", ");
+        std::fprintf(out, "\"rms_deg\": %.4f, \"commands\": %llu, \"commands_per_s\": %.0f}%s\n", row.rms_deg,
+                     static_cast<unsigned long long>(row.commands), row.commands_per_s, i + 1 < count ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return (settled && faster && kept_up) ? 0 : 1;
+}
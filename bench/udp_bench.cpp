@@ -0,0 +1,306 @@
+#include "GimbalUdp.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+/**
+ * @brief GimbalUdpServer throughput and filtering over loopback
+ *
+ * A GimbalUdpClient sends setpoints to a GimbalUdpServer on 127.0.0.1
+ * (server on its own thread), in two phases:
+ *
+ * - paced:  --rate datagrams/s for --seconds, in bursts of 16 as a
+ *           ground station batching a camera frame's worth of commands
+ * - burst:  as fast as sendmmsg() goes, for the same number of datagrams
+ *
+ * Every 8th burst also resends two old sequences, which the server must
+ * drop as stale; every 32nd datagram asks for an ack. After both phases
+ * the session's first datagram (GIMBAL_UDP_FLAG_RESET) is replayed and a
+ * second client starts its own session: neither may rewind the
+ * sequence or move the setpoint. Allocations are
+ * counted with a global operator new while traffic flows: the server and
+ * client paths must not allocate per datagram.
+ *
+ * Usage: udp_bench [--rate N] [--seconds S] [--json PATH]
+ *
+ * Exit status is nonzero if the paced phase loses datagrams below the
+ * requested rate, a stale datagram reaches the mailbox, a replayed or
+ * foreign RESET is accepted, the final sequence is not the last one sent,
+ * or anything was allocated.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t BURST = 16;
+constexpr size_t STALE_EVERY = 8;     // bursts
+constexpr uint32_t ACK_EVERY = 32;    // datagrams
+
+std::atomic<uint64_t> allocations{0};
+
+struct Phase {
+    const char* name;
+    uint64_t sent;
+    uint64_t stale_sent;
+    double seconds;
+    uint64_t received;
+    uint64_t stale;
+    uint64_t batches;
+    uint64_t published;
+    uint64_t acks;
+    double rtt_us_mean;
+};
+
+/// Watches the mailbox and counts setpoints that went backwards
+struct MonotonicWatch {
+    std::atomic<bool> run{true};
+    std::atomic<uint64_t> regressions{0};
+};
+
+Phase runPhase(const char* name, GimbalUdpClient& client, GimbalUdpServer& server, uint64_t count, double rate) {
+    Phase phase{};
+    phase.name = name;
+    GimbalUdpStats before = server.getStats();
+
+    GimbalUdpCommand burst[BURST + 2];
+    GimbalUdpAck acks[GIMBAL_UDP_BATCH];
+    double rtt_total_us = 0.0;
+    uint64_t rtt_count = 0;
+    uint64_t bursts = 0;
+
+    const auto start = Clock::now();
+    const double burst_interval_s = rate > 0.0 ? static_cast<double>(BURST) / rate : 0.0;
+    while (phase.sent < count) {
+        size_t n = 0;
+        for (; n < BURST && phase.sent + n < count; ++n) {
+            // The angle encodes the sequence so the watcher can spot regressions
+            uint32_t sequence = client.getNextSequence();
+            const float angles[2] = {static_cast<float>(sequence % 1000000) * 1e-4f, 0.0f};
+            client.prepare(burst[n], angles, 2, sequence % ACK_EVERY == 0 ? GIMBAL_UDP_FLAG_ACK : 0);
+        }
+        size_t total = n;
+        if (++bursts % STALE_EVERY == 0 && n > 4) {
+            // Replay two datagrams of this burst late: out of order and duplicate
+            burst[total++] = burst[1];
+            burst[total++] = burst[0];
+            phase.stale_sent += 2;
+        }
+        int sent = client.sendBatch(burst, total);
+        if (sent > 0) {
+            phase.sent += n;
+        }
+
+        int got = client.receiveAcks(acks, GIMBAL_UDP_BATCH, 0);
+        uint64_t now = GimbalUdpClient::now();
+        for (int i = 0; i < got; ++i) {
+            rtt_total_us += static_cast<double>(now - acks[i].echo_timestamp_ns) / 1e3;
+            ++rtt_count;
+        }
+        phase.acks += got > 0 ? static_cast<uint64_t>(got) : 0;
+
+        if (burst_interval_s > 0.0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(burst_interval_s * bursts)));
+        }
+    }
+    phase.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Let the server drain, then collect the last acks
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int got = client.receiveAcks(acks, GIMBAL_UDP_BATCH, 10);
+    uint64_t now = GimbalUdpClient::now();
+    for (int i = 0; i < got; ++i) {
+        rtt_total_us += static_cast<double>(now - acks[i].echo_timestamp_ns) / 1e3;
+        ++rtt_count;
+    }
+    phase.acks += got > 0 ? static_cast<uint64_t>(got) : 0;
+
+    GimbalUdpStats after = server.getStats();
+    phase.received = after.received - before.received;
+    phase.stale = after.stale - before.stale;
+    phase.batches = after.batches - before.batches;
+    phase.published = after.published - before.published;
+    phase.rtt_us_mean = rtt_count > 0 ? rtt_total_us / static_cast<double>(rtt_count) : 0.0;
+    return phase;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char** argv) {
+    double rate = 20000.0;
+    double seconds = 2.0;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(argv[i], "--rate") == 0 && value) {
+            rate = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && value) {
+            seconds = std::strtod(value, nullptr);
+        } else if (std::strcmp(argv[i], "--json") == 0 && value) {
+            json_path = value;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--rate N] [--seconds S] [--json PATH]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (rate <= 0.0 || seconds <= 0.0) {
+        return 2;
+    }
+    const uint64_t count = static_cast<uint64_t>(rate * seconds);
+
+    SetpointMailbox mailbox;
+    TelemetryMailbox telemetry;
+    GimbalTelemetry state{};
+    state.frames = 1;
+    telemetry.store(state);
+
+    GimbalUdpServer server(mailbox, &telemetry);
+    GimbalUdpConfig config;
+    config.port = 0;
+    config.bind_address = "127.0.0.1";
+    config.receive_buffer_bytes = 4 << 20;
+    GimbalStatus status = server.open(config);
+    GimbalUdpClient client;
+    if (!status || !(status = client.open("127.0.0.1", server.getPort())) || !server.start()) {
+        std::fprintf(stderr, "Cannot set up loopback sockets: %s\n", std::strerror(status.detail()));
+        return 1;
+    }
+
+    // The setpoint (pan = sequence * 1e-4) must never go backwards
+    MonotonicWatch watch;
+    std::thread watcher([&]() {
+        float last = -1.0f;
+        while (watch.run.load(std::memory_order_relaxed)) {
+            Setpoint setpoint;
+            if (mailbox.version() != 0) {
+                mailbox.load(setpoint);
+                if (setpoint.pan_angle < last) {
+                    watch.regressions.fetch_add(1, std::memory_order_relaxed);
+                }
+                last = setpoint.pan_angle;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    // The session's first datagram (RESET), kept for a late replay
+    GimbalUdpCommand first;
+    const float first_angles[2] = {static_cast<float>(client.getNextSequence() % 1000000) * 1e-4f, 0.0f};
+    client.prepare(first, first_angles, 2, GIMBAL_UDP_FLAG_ACK);
+    GimbalUdpAck first_ack{};
+    bool started = client.sendBatch(&first, 1) == 1 && client.receiveAcks(&first_ack, 1, 1000) == 1 &&
+                   first_ack.sequence == first.sequence;
+
+    const uint64_t allocations_before = allocations.load();
+    Phase paced = runPhase("paced", client, server, count, rate);
+    Phase burst = runPhase("burst", client, server, count, 0.0);
+    const uint64_t allocated = allocations.load() - allocations_before;
+
+    // Neither a late copy of the first datagram nor another station's
+    // first datagram may rewind the sequence while this session is live
+    const uint32_t live_sequence = client.getNextSequence() - 1;
+    const uint64_t stale_before = server.getStats().stale;
+    GimbalUdpClient intruder;
+    bool resets_ok = started && static_cast<bool>(intruder.open("127.0.0.1", server.getPort())) &&
+                     client.sendBatch(&first, 1) == 1 && intruder.setTarget(0.0f, 0.0f, GIMBAL_UDP_FLAG_ACK);
+    GimbalUdpAck reset_acks[2]{};
+    resets_ok = resets_ok && client.receiveAcks(&reset_acks[0], 1, 1000) == 1 &&
+                intruder.receiveAcks(&reset_acks[1], 1, 1000) == 1;
+    resets_ok = resets_ok && reset_acks[0].sequence == live_sequence && reset_acks[1].sequence == live_sequence &&
+                server.getStats().stale - stale_before == 2;
+    intruder.close();
+
+    // The watcher reads pan angles that only grow; stop it before the
+    // final datagram steps back to 0
+    watch.run.store(false);
+    watcher.join();
+
+    // A last acknowledged datagram: the server must end on it
+    const uint32_t final_sequence = client.getNextSequence();
+    client.setTarget(0.0f, 0.0f, GIMBAL_UDP_FLAG_ACK);
+    GimbalUdpAck ack{};
+    bool final_ok = false;
+    for (int attempt = 0; attempt < 20 && !final_ok; ++attempt) {
+        final_ok = client.receiveAcks(&ack, 1, 50) == 1 && ack.sequence == final_sequence;
+    }
+
+    server.stop();
+    GimbalUdpStats stats = server.getStats();
+
+    const Phase* phases[] = {&paced, &burst};
+    std::fprintf(stderr, "=== udp_bench (loopback, %llu datagrams per phase) ===\n", static_cast<unsigned long long>(count));
+    std::fprintf(stderr, "%-6s %12s %10s %9s %9s %13s %10s %9s %9s\n", "phase", "datagrams/s", "received", "lost", "stale",
+                 "per recvmmsg", "published", "acks", "rtt us");
+    for (const Phase* phase : phases) {
+        uint64_t arrived = phase->received;
+        uint64_t expected = phase->sent + phase->stale_sent;
+        std::fprintf(stderr, "%-6s %12.0f %10llu %9llu %9llu %13.1f %10llu %9llu %9.1f\n", phase->name,
+                     static_cast<double>(arrived) / phase->seconds, static_cast<unsigned long long>(arrived),
+                     static_cast<unsigned long long>(expected > arrived ? expected - arrived : 0),
+                     static_cast<unsigned long long>(phase->stale),
+                     phase->batches > 0 ? static_cast<double>(arrived) / static_cast<double>(phase->batches) : 0.0,
+                     static_cast<unsigned long long>(phase->published), static_cast<unsigned long long>(phase->acks),
+                     phase->rtt_us_mean);
+    }
+    std::fprintf(stderr, "allocations during traffic: %llu, setpoint regressions: %llu, replayed resets %s, "
+                         "final sequence %s\n",
+                 static_cast<unsigned long long>(allocated),
+                 static_cast<unsigned long long>(watch.regressions.load()), resets_ok ? "ignored" : "FAILED",
+                 final_ok ? "ok" : "FAILED");
+
+    const double paced_rate = static_cast<double>(paced.received) / paced.seconds;
+    const bool paced_ok = paced.received == paced.sent + paced.stale_sent && paced_rate >= 0.95 * rate;
+
+    FILE* out = stdout;
+    if (json_path) {
+        out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open %s\n", json_path);
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"udp_bench\",\n  \"rate\": %.0f,\n  \"datagrams_per_phase\": %llu,\n"
+                      "  \"allocations\": %llu,\n  \"regressions\": %llu,\n  \"invalid\": %llu,\n  \"phases\": [\n",
+                 rate, static_cast<unsigned long long>(count), static_cast<unsigned long long>(allocated),
+                 static_cast<unsigned long long>(watch.regressions.load()), static_cast<unsigned long long>(stats.invalid));
+    for (size_t i = 0; i < 2; ++i) {
+        const Phase& phase = *phases[i];
+        std::fprintf(out,
+                     "    {\"phase\": \"%s\", \"sent\": %llu, \"stale_sent\": %llu, \"received\": %llu, \"stale\": %llu, "
+                     "\"datagrams_per_s\": %.0f, \"batches\": %llu, \"published\": %llu, \"acks\": %llu, "
+                     "\"rtt_us\": %.2f}%s\n",
+                     phase.name, static_cast<unsigned long long>(phase.sent),
+                     static_cast<unsigned long long>(phase.stale_sent), static_cast<unsigned long long>(phase.received),
+                     static_cast<unsigned long long>(phase.stale), static_cast<double>(phase.received) / phase.seconds,
+                     static_cast<unsigned long long>(phase.batches), static_cast<unsigned long long>(phase.published),
+                     static_cast<unsigned long long>(phase.acks), phase.rtt_us_mean, i + 1 < 2 ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return (paced_ok && resets_ok && final_ok && allocated == 0 && watch.regressions.load() == 0 && stats.invalid == 0) ? 0 : 1;
+}
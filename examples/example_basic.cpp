@@ -1,12 +1,21 @@
 #include "Gimbal.h"
+#include "GimbalLog.h"
 #include "PWMControllerRPi5.h"
 #include "PWMControllerPico.h"
+#include "PWMControllerSim.h"
+#include "PWMControllerSysfs.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
 
 #ifdef PICO_BUILD
 #include "pico/stdlib.h"
-inline void delay_ms(int milliseconds) { sleep_ms(milliseconds); }
+// No drain thread on the Pico: flush library log messages while idle
+inline void delay_ms(int milliseconds) {
+    GimbalLog::drain();
+    sleep_ms(milliseconds);
+}
 #else
 #include <thread>
 #include <chrono>
@@ -20,6 +29,9 @@ inline void delay_ms(int milliseconds) {
  * 
  * This example demonstrates:
  * - Platform selection (RPi5 or Pico)
+ * - Runtime backend selection on RPi5: GIMBAL_PWM_BACKEND=lgpio (default) or
+ *   GIMBAL_PWM_BACKEND=sysfs for RP1 hardware PWM on GPIO 12/13
+ *   (chip directory from GIMBAL_PWMCHIP, default /sys/class/pwm/pwmchip0)
  * - Initializing the gimbal with appropriate PWM controller
  * - Setting various pan/tilt angles
  * - Sweeping the camera view
@@ -28,11 +40,16 @@ inline void delay_ms(int milliseconds) {
 
 int main() {
     std::cout << "=== Gimbal Control Example ===" << std::endl;
+
+#ifndef PICO_BUILD
+    // Library log messages are buffered; print them from a background thread
+    GimbalLog::startDrainThread();
+#endif
     
     // GPIO pin configuration
     // Adjust these based on your Raspberry Pi or Pico wiring
-    const uint32_t PAN_PIN = 17;    // GPIO 17 for pan servo
-    const uint32_t TILT_PIN = 27;   // GPIO 27 for tilt servo
+    uint32_t PAN_PIN = 17;    // GPIO 17 for pan servo
+    uint32_t TILT_PIN = 27;   // GPIO 27 for tilt servo
 
     // Create platform-specific PWM controller
     std::shared_ptr<PWMController> pwm_controller;
@@ -40,9 +57,22 @@ int main() {
 #ifdef PICO_BUILD
     std::cout << "Running on Raspberry Pi Pico" << std::endl;
     pwm_controller = std::make_shared<PWMControllerPico>();
+#elif defined(SIM_BUILD)
+    std::cout << "Running in host simulation" << std::endl;
+    pwm_controller = std::make_shared<PWMControllerSim>();
 #else
-    std::cout << "Running on Raspberry Pi 5" << std::endl;
-    pwm_controller = std::make_shared<PWMControllerRPi5>();
+    const char* backend = std::getenv("GIMBAL_PWM_BACKEND");
+    if (backend && std::strcmp(backend, "sysfs") == 0) {
+        const char* chip = std::getenv("GIMBAL_PWMCHIP");
+        std::cout << "Running on Raspberry Pi 5 (hardware PWM)" << std::endl;
+        pwm_controller = std::make_shared<PWMControllerSysfs>(chip ? chip : "/sys/class/pwm/pwmchip0");
+        // Hardware PWM is only routed to GPIO 12/13/18/19
+        PAN_PIN = 12;
+        TILT_PIN = 13;
+    } else {
+        std::cout << "Running on Raspberry Pi 5" << std::endl;
+        pwm_controller = std::make_shared<PWMControllerRPi5>();
+    }
 #endif
 
     // Create gimbal controller instance
@@ -51,6 +81,9 @@ int main() {
     // Initialize gimbal
     if (!gimbal.init()) {
         std::cerr << "Failed to initialize gimbal" << std::endl;
+#ifndef PICO_BUILD
+        GimbalLog::stopDrainThread();
+#endif
         return 1;
     }
 
@@ -107,6 +140,12 @@ int main() {
     std::cout << "\nShutting down gimbal..." << std::endl;
     gimbal.shutdown();
 
+#ifndef PICO_BUILD
+    GimbalLog::stopDrainThread();
+#else
+    GimbalLog::drain();
+#endif
+
     std::cout << "Example completed successfully!" << std::endl;
 
     return 0;
@@ -0,0 +1,107 @@
+#include "DualCoreGimbal.h"
+#include "Gimbal.h"
+#include "GimbalLog.h"
+#include "PWMControllerPico.h"
+#include "PWMControllerSim.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#ifdef PICO_BUILD
+#include "pico/stdlib.h"
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+/**
+ * @brief Dual-core runtime example: gimbal loop on core1, sweep and stdio on core0
+ *
+ * Core0 initializes the gimbal, starts DualCoreGimbal (the frame loop moves
+ * to core1, paced by a hardware alarm) and then only produces targets and
+ * prints statistics over USB stdio; none of that work can delay a PWM
+ * update any more. On the host the loop runs on a thread instead, with the
+ * same ring and frame logic.
+ *
+ * Usage (host): gimbal_dual_core [seconds]   (default 10; the Pico runs forever)
+ */
+
+namespace {
+
+constexpr uint32_t PAN_PIN = 17;
+constexpr uint32_t TILT_PIN = 27;
+
+/// Targets produced per second on core0 (faster than the frame rate on purpose)
+constexpr uint32_t TARGET_RATE_HZ = 200;
+
+void pause_us(uint32_t microseconds) {
+#ifdef PICO_BUILD
+    sleep_us(microseconds);
+#else
+    std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
+#endif
+}
+
+void printStats(const DualCoreStats& stats) {
+    std::printf("frames %lu | commands %lu (superseded %lu, ring full %lu) | failures %lu | "
+                "missed %lu | max late %lu us | max latency %lu us\n",
+                static_cast<unsigned long>(stats.frames), static_cast<unsigned long>(stats.commands),
+                static_cast<unsigned long>(stats.superseded), static_cast<unsigned long>(stats.ring_full),
+                static_cast<unsigned long>(stats.failures), static_cast<unsigned long>(stats.missed_frames),
+                static_cast<unsigned long>(stats.max_late_us), static_cast<unsigned long>(stats.max_latency_us));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+#ifdef PICO_BUILD
+    (void)argc;
+    (void)argv;
+    stdio_init_all();
+    auto pwm_controller = std::make_shared<PWMControllerPico>();
+    const uint32_t seconds = 0;
+#else
+    GimbalLog::startDrainThread();
+    auto pwm_controller = std::make_shared<PWMControllerSim>();
+    const uint32_t seconds = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 10;
+#endif
+
+    Gimbal gimbal(pwm_controller, PAN_PIN, TILT_PIN);
+    if (!gimbal.init()) {
+        std::printf("Failed to initialize gimbal\n");
+        return 1;
+    }
+    // Let slow sweeps through: the sweep moves less than the default deadzone per target
+    gimbal.setDeadzone(0.0f);
+
+    DualCoreGimbal runtime(gimbal);
+    if (!runtime.start()) {
+        std::printf("Failed to start the core1 loop\n");
+        return 1;
+    }
+    std::printf("Gimbal loop running on core1; sweeping from core0\n");
+
+    const uint32_t period_us = 1000000 / TARGET_RATE_HZ;
+    uint32_t tick = 0;
+    while (seconds == 0 || tick < seconds * TARGET_RATE_HZ) {
+        float t = static_cast<float>(tick) / static_cast<float>(TARGET_RATE_HZ);
+        runtime.setTarget(60.0f * std::sin(0.5f * t), 20.0f * std::sin(1.3f * t));
+        if (++tick % TARGET_RATE_HZ == 0) {
+            printStats(runtime.getStats());
+#ifdef PICO_BUILD
+            // Library messages from core0 only; the core1 path does not log
+            GimbalLog::drain();
+#endif
+        }
+        pause_us(period_us);
+    }
+
+    runtime.stop();
+    printStats(runtime.getStats());
+    gimbal.shutdown();
+#ifndef PICO_BUILD
+    GimbalLog::stopDrainThread();
+#endif
+    return 0;
+}
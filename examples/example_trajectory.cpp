@@ -0,0 +1,119 @@
+#include "Gimbal.h"
+#include "GimbalLog.h"
+#include "PWMControllerRPi5.h"
+#include "PWMControllerSim.h"
+#include "TrajectoryFile.h"
+#include "TrajectoryPlayer.h"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Survey sweep played back from a binary trajectory file
+ *
+ * Usage: trajectory_example [FILE] [--loop] [--scale X] [--seek SECONDS]
+ *
+ * Without FILE, writes a raster scan (pan sweeps across ±60°, tilt steps
+ * by 15° between rows) to survey.gtrj and plays that. Ctrl+C stops
+ * playback.
+ */
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void onSignal(int) {
+    stop_requested.store(true);
+}
+
+/// Boustrophedon raster: 4 s per row, 1 s to step to the next row
+std::vector<TrajectoryRecord> makeSurvey() {
+    std::vector<TrajectoryRecord> points;
+    uint64_t t = 0;
+    float tilt = -30.0f;
+    for (int row = 0; row < 5; ++row) {
+        float from = (row % 2 == 0) ? -60.0f : 60.0f;
+        float to = -from;
+        points.push_back({t, from, tilt});
+        t += 4000000;
+        points.push_back({t, to, tilt});
+        if (row < 4) {
+            t += 1000000;
+            tilt += 15.0f;
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool loop = false;
+    float scale = 1.0f;
+    double seek_s = 0.0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--loop") == 0) {
+            loop = true;
+        } else if (std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = std::strtof(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--seek") == 0 && i + 1 < argc) {
+            seek_s = std::strtod(argv[++i], nullptr);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [FILE] [--loop] [--scale X] [--seek SECONDS]" << std::endl;
+            return 2;
+        }
+    }
+
+    GimbalLog::startDrainThread();
+
+    if (!path) {
+        path = "survey.gtrj";
+        std::vector<TrajectoryRecord> survey = makeSurvey();
+        if (!TrajectoryFile::write(path, survey.data(), survey.size())) {
+            GimbalLog::stopDrainThread();
+            return 1;
+        }
+        std::cout << "Wrote survey sweep to " << path << std::endl;
+    }
+
+    TrajectoryFile trajectory;
+    if (!trajectory.open(path)) {
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+
+#ifdef SIM_BUILD
+    auto pwm_controller = std::make_shared<PWMControllerSim>();
+#else
+    auto pwm_controller = std::make_shared<PWMControllerRPi5>();
+#endif
+    Gimbal gimbal(pwm_controller, 17, 27);
+    if (!gimbal.init()) {
+        std::cerr << "Failed to initialize gimbal" << std::endl;
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+
+    TrajectoryPlayer player(trajectory);
+    player.setLoop(loop);
+    uint64_t now = TrajectoryPlayer::now();
+    if (!player.setTimeScale(scale, now)) {
+        std::cerr << "Invalid time scale" << std::endl;
+    }
+    player.seek(static_cast<uint64_t>(seek_s * 1e6), now);
+
+    std::signal(SIGINT, onSignal);
+    std::cout << "Playing " << trajectory.size() << " points ("
+              << static_cast<double>(trajectory.getDuration()) / 1e6 << " s)" << std::endl;
+    bool ok = player.play(gimbal, 0, &stop_requested);
+
+    gimbal.shutdown();
+    GimbalLog::stopDrainThread();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include "Gimbal.h"
+#include "GimbalController.h"
+#include "GimbalLog.h"
+#include "GimbalShm.h"
+#include "GimbalUdp.h"
+#include "PWMControllerRPi5.h"
+#include "PWMControllerSim.h"
+#include "PWMControllerSysfs.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief Gimbal daemon: owns the PWM controller and serves a shm segment
+ *
+ * Usage: gimbal_daemon [--name /gimbal] [--priority N] [--cpu N] [--frame-rate HZ [--digital]]
+ *                      [--udp PORT] [--quiet]
+ *
+ * Creates the POSIX shared-memory segment (GimbalShm) and runs a
+ * GimbalController on its setpoint and telemetry blocks, so any number of
+ * client processes (C++ through GimbalShm, Python through libgimbal_shm.so)
+ * command the gimbal without linking the backend or competing for the
+ * GPIO chip. The PWM backend is chosen as in gimbal_example
+ * (GIMBAL_PWM_BACKEND=lgpio|sysfs on RPi5). --frame-rate drives both
+ * servos (and the loop) faster than 50 Hz; it is checked against the
+ * GIMBAL_CALIBRATION_SERVO profile, or the DIGITAL one with --digital.
+ * --udp also accepts GimbalUdpCommand datagrams from ground stations on
+ * PORT, into the same setpoint mailbox (the newest setpoint wins,
+ * whichever side sent it).
+ * SIGINT/SIGTERM stop it.
+ */
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void onSignal(int) {
+    stop_requested.store(true);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = GIMBAL_SHM_DEFAULT_NAME;
+    bool quiet = false;
+    uint32_t frame_rate = Gimbal::PWM_FREQUENCY;
+    ServoModel servo = ServoModel::GIMBAL_CALIBRATION_SERVO;
+    int udp_port = -1;
+    GimbalControllerConfig config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (std::strcmp(argv[i], "--priority") == 0 && i + 1 < argc) {
+            config.realtime_priority = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            config.cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--frame-rate") == 0 && i + 1 < argc) {
+            frame_rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--digital") == 0) {
+            servo = ServoModel::DIGITAL;
+        } else if (std::strcmp(argv[i], "--udp") == 0 && i + 1 < argc) {
+            udp_port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--name /gimbal] [--priority N] [--cpu N] [--frame-rate HZ [--digital]] [--udp PORT] [--quiet]"
+                      << std::endl;
+            return 2;
+        }
+    }
+
+    GimbalLog::startDrainThread();
+
+    uint32_t pan_pin = 17;
+    uint32_t tilt_pin = 27;
+    std::shared_ptr<PWMController> pwm_controller;
+#ifdef SIM_BUILD
+    pwm_controller = std::make_shared<PWMControllerSim>();
+#else
+    const char* backend = std::getenv("GIMBAL_PWM_BACKEND");
+    if (backend && std::strcmp(backend, "sysfs") == 0) {
+        const char* chip = std::getenv("GIMBAL_PWMCHIP");
+        pwm_controller = std::make_shared<PWMControllerSysfs>(chip ? chip : "/sys/class/pwm/pwmchip0");
+        pan_pin = 12;
+        tilt_pin = 13;
+    } else {
+        pwm_controller = std::make_shared<PWMControllerRPi5>();
+    }
+#endif
+
+    Gimbal gimbal(pwm_controller, pan_pin, tilt_pin);
+    if (!gimbal.setFrameRate(frame_rate, frame_rate, servo, servo)) {
+        std::cerr << getServoProfile(servo).name << " servos cannot run at " << frame_rate << " Hz" << std::endl;
+        GimbalLog::stopDrainThread();
+        return 2;
+    }
+    if (!gimbal.init()) {
+        std::cerr << "Failed to initialize gimbal" << std::endl;
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+
+    GimbalShm shm;
+    GimbalStatus status = shm.create(name);
+    if (!status) {
+        std::cerr << "Cannot create shared memory " << name << ": " << std::strerror(status.detail()) << std::endl;
+        gimbal.shutdown();
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+
+    config.mailbox = shm.setpoints();
+    config.telemetry = shm.telemetry();
+    GimbalController controller(gimbal, config);
+    if (!controller.start()) {
+        gimbal.shutdown();
+        GimbalLog::stopDrainThread();
+        return 1;
+    }
+
+    GimbalUdpServer udp(*shm.setpoints(), shm.telemetry());
+    if (udp_port >= 0) {
+        GimbalUdpConfig udp_config;
+        udp_config.port = static_cast<uint16_t>(udp_port);
+        status = udp.open(udp_config);
+        if (!status || !udp.start()) {
+            std::cerr << "Cannot listen on UDP port " << udp_port << ": " << std::strerror(status.detail()) << std::endl;
+            controller.stop();
+            shm.close();
+            gimbal.shutdown();
+            GimbalLog::stopDrainThread();
+            return 1;
+        }
+        std::cout << "Listening on UDP port " << udp.getPort() << std::endl;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::cout << "Serving " << name << " on " << pwm_controller->getPlatformName() << " at " << gimbal.getFrameRate()
+              << " Hz" << std::endl;
+
+    int ticks = 0;
+    while (!stop_requested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (quiet || ++ticks % 50 != 0) {
+            continue;
+        }
+        GimbalTelemetry telemetry;
+        if (shm.getTelemetry(telemetry)) {
+            GimbalControllerStats stats = controller.getStats();
+            std::cout << "pan " << telemetry.pan_angle << " tilt " << telemetry.tilt_angle
+                      << " | updates " << telemetry.updates << " failures " << telemetry.failures
+                      << " | max jitter " << stats.max_jitter_ns / 1000 << " us" << std::endl;
+        }
+        if (udp.isRunning()) {
+            GimbalUdpStats net = udp.getStats();
+            std::cout << "udp received " << net.received << " stale " << net.stale << " invalid " << net.invalid
+                      << " | published " << net.published << " acks " << net.acks_sent << std::endl;
+        }
+    }
+
+    udp.close();
+    controller.stop();
+    shm.close();
+    gimbal.shutdown();
+    GimbalLog::stopDrainThread();
+    return 0;
+}
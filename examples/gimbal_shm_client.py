@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Command a running gimbal_daemon through libgimbal_shm.so (ctypes).
+
+Sweeps the pan axis and prints the state the daemon reports back.
+Setting a target and reading telemetry are plain memory accesses on the
+shared segment: no socket, pipe or syscall per command.
+"""
+import argparse
+import ctypes
+import math
+import os
+import sys
+import time
+
+
+class Telemetry(ctypes.Structure):
+    # Must match gimbal_shm_telemetry in include/GimbalShmApi.h
+    _fields_ = [
+        ("pan_angle", ctypes.c_float),
+        ("tilt_angle", ctypes.c_float),
+        ("setpoint_timestamp_ns", ctypes.c_uint64),
+        ("applied_ns", ctypes.c_uint64),
+        ("frame_ns", ctypes.c_uint64),
+        ("frames", ctypes.c_uint64),
+        ("updates", ctypes.c_uint64),
+        ("failures", ctypes.c_uint64),
+        ("last_error", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+    ]
+
+
+def load_library(path: str) -> ctypes.CDLL:
+    lib = ctypes.CDLL(path)
+    lib.gimbal_shm_open.argtypes = [ctypes.c_char_p]
+    lib.gimbal_shm_open.restype = ctypes.c_void_p
+    lib.gimbal_shm_close.argtypes = [ctypes.c_void_p]
+    lib.gimbal_shm_close.restype = None
+    lib.gimbal_shm_set_target.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float, ctypes.c_uint64]
+    lib.gimbal_shm_set_target.restype = ctypes.c_int
+    lib.gimbal_shm_read_telemetry.argtypes = [ctypes.c_void_p, ctypes.POINTER(Telemetry)]
+    lib.gimbal_shm_read_telemetry.restype = ctypes.c_int
+    lib.gimbal_shm_now_ns.argtypes = []
+    lib.gimbal_shm_now_ns.restype = ctypes.c_uint64
+    return lib
+
+
+def main():
+    default_lib = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "build", "lib", "libgimbal_shm.so")
+    parser = argparse.ArgumentParser(description="Sweep the gimbal through the daemon's shared memory")
+    parser.add_argument("--lib", default=default_lib, help="Path to libgimbal_shm.so")
+    parser.add_argument("--name", default="/gimbal", help="Shared-memory name (default: /gimbal)")
+    parser.add_argument("--amplitude", type=float, default=45.0, help="Pan sweep amplitude in degrees")
+    parser.add_argument("--rate", type=float, default=100.0, help="Targets published per second")
+    parser.add_argument("--duration", type=float, default=0.0, help="Seconds to run (0 = until Ctrl+C)")
+    args = parser.parse_args()
+
+    lib = load_library(args.lib)
+    shm = lib.gimbal_shm_open(args.name.encode())
+    if not shm:
+        print(f"Cannot open {args.name}: is gimbal_daemon running?")
+        sys.exit(1)
+
+    telemetry = Telemetry()
+    start = time.monotonic()
+    next_report = start
+    try:
+        while args.duration <= 0.0 or time.monotonic() - start < args.duration:
+            t = time.monotonic() - start
+            pan = args.amplitude * math.sin(2.0 * math.pi * 0.25 * t)
+            lib.gimbal_shm_set_target(shm, pan, 0.0, 0)
+
+            if time.monotonic() >= next_report and lib.gimbal_shm_read_telemetry(shm, ctypes.byref(telemetry)) == 0:
+                age_ms = (lib.gimbal_shm_now_ns() - telemetry.frame_ns) / 1e6
+                print(f"target {pan:7.2f} | applied pan {telemetry.pan_angle:7.2f} tilt {telemetry.tilt_angle:6.2f}"
+                      f" | updates {telemetry.updates} failures {telemetry.failures} | last frame {age_ms:.1f} ms ago")
+                next_report += 0.5
+            time.sleep(1.0 / args.rate)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        lib.gimbal_shm_set_target(shm, 0.0, 0.0, 0)
+        lib.gimbal_shm_close(shm)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,350 @@
+#ifndef BASIC_GIMBAL_H
+#define BASIC_GIMBAL_H
+
+#include "GimbalConfig.h"
+#include "GimbalStatus.h"
+#include "PulseMapping.h"
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @file BasicGimbal.h
+ * @brief Compile-time specialized gimbal command path
+ *
+ * BasicGimbal<Backend, Calibration> is the part of Gimbal that turns angles
+ * into pulses, with the PWM backend and the angle -> pulse mapping as
+ * template parameters instead of a PWMController pointer and a runtime
+ * table. With a backend whose pins are template arguments
+ * (PicoServoBackend, ControllerBackend in GimbalBackends.h) and a
+ * StaticCalibration, setTipAngle() has no indirect call and inlines down to
+ * the range checks, the mapping arithmetic and the compare-register store.
+ *
+ * A Backend provides:
+ * @code
+ *   GimbalStatus init(uint32_t pan_frequency, uint32_t tilt_frequency);  // claim both pins
+ *   GimbalStatus write(uint32_t pan_us, uint32_t tilt_us, uint8_t axes); // axes: GIMBAL_AXIS_* changed
+ *   void shutdown();                                                     // release both pins
+ *   uint32_t panPin() const;
+ *   uint32_t tiltPin() const;
+ * @endcode
+ * A Calibration provides toPulseWidth(float) and toPulseWidthQ16(int32_t),
+ * as ServoCalibration and StaticCalibration do.
+ *
+ * Gimbal is the type-erased wrapper: BasicGimbal<DynamicBackend,
+ * ServoCalibration> behind the runtime-configured interface, plus logging,
+ * calibration hot reload, statistics and telemetry. BasicGimbal itself does
+ * none of that; it only reports each command's outcome.
+ */
+
+/// Axis bits of the mask passed to Backend::write() (same as TelemetryRing::WROTE_*)
+constexpr uint8_t GIMBAL_AXIS_PAN = 1;
+constexpr uint8_t GIMBAL_AXIS_TILT = 2;
+
+/**
+ * @class StaticCalibration
+ * @brief Linear servo calibration with its constants folded at compile time
+ * @tparam MinPulseUs Pulse width at -MaxAngleDeg (µs)
+ * @tparam MaxPulseUs Pulse width at +MaxAngleDeg (µs)
+ * @tparam MaxAngleDeg Mechanical half-range (degrees)
+ */
+template <uint32_t MinPulseUs, uint32_t MaxPulseUs, uint32_t MaxAngleDeg = 90>
+class StaticCalibration {
+public:
+    using Mapping = PulseMapping<MinPulseUs, MaxPulseUs, MaxAngleDeg>;
+
+    uint32_t toPulseWidth(float angle) const { return Mapping::toPulseFloat(angle); }
+    constexpr uint32_t toPulseWidthQ16(int32_t angle_q16) const { return Mapping::toPulseQ16(angle_q16); }
+};
+
+/// MG90S: 1000 µs = -90°, 1500 µs = 0°, 2000 µs = +90°
+using MG90SStaticCalibration = StaticCalibration<1000, 2000, 90>;
+
+/**
+ * @class BasicGimbal
+ * @brief Pan-tilt command path specialized for one backend and calibration
+ * @tparam Backend PWM output (see the file comment for the interface)
+ * @tparam Calibration Angle -> pulse mapping of each axis
+ *
+ * Same semantics as Gimbal: angles outside ±90° are rejected, the deadzone
+ * holds an axis at its committed angle, unchanged pulses are not written,
+ * and both changed axes go to the backend in one write() call.
+ */
+template <typename Backend, typename Calibration>
+class BasicGimbal {
+public:
+    /// Default servo PWM frame rate (see setFrameRate())
+    static constexpr uint32_t PWM_FREQUENCY = GIMBAL_PWM_FREQUENCY;
+
+    /// Lowest and highest frame rates setFrameRate() accepts
+    static constexpr uint32_t MIN_PWM_FREQUENCY = GIMBAL_PWM_MIN_FREQUENCY;
+    static constexpr uint32_t MAX_PWM_FREQUENCY = GIMBAL_PWM_MAX_FREQUENCY;
+
+    /// Commanded angle range in degrees
+    static constexpr float MAX_ANGLE = 90.0f;
+    static constexpr float MIN_ANGLE = -90.0f;
+
+    /**
+     * @brief Constructor
+     * @param backend PWM output (copied)
+     * @param pan_calibration Calibration of the pan axis
+     * @param tilt_calibration Calibration of the tilt axis
+     */
+    explicit BasicGimbal(const Backend& backend = Backend(),
+                         const Calibration& pan_calibration = Calibration(),
+                         const Calibration& tilt_calibration = Calibration())
+        : backend_(backend),
+          pan_calibration_(pan_calibration),
+          tilt_calibration_(tilt_calibration),
+          pan_angle_(0.0f),
+          tilt_angle_(0.0f),
+          pan_pulse_(0),
+          tilt_pulse_(0),
+          pan_frequency_(PWM_FREQUENCY),
+          tilt_frequency_(PWM_FREQUENCY),
+          deadzone_(GIMBAL_ANGLE_DEADZONE),
+          last_writes_(0),
+          initialized_(false) {}
+
+    ~BasicGimbal() { shutdown(); }
+
+    BasicGimbal(const BasicGimbal&) = delete;
+    BasicGimbal& operator=(const BasicGimbal&) = delete;
+
+    /**
+     * @brief Claim both pins and center the gimbal at (0, 0)
+     * @return Success, or the backend's failure. getLastWrites() is nonzero
+     *         if the pins were claimed and the centering write was attempted.
+     */
+    GimbalStatus init() {
+        last_writes_ = 0;
+        if (initialized_) {
+            return GimbalStatus::success();
+        }
+
+        GimbalStatus status = backend_.init(pan_frequency_, tilt_frequency_);
+        if (!status) {
+            return status;
+        }
+
+        // Center (always written: the servo position is unknown)
+        uint32_t pan_pulse = toPulse(pan_calibration_, 0.0f);
+        uint32_t tilt_pulse = toPulse(tilt_calibration_, 0.0f);
+        last_writes_ = GIMBAL_AXIS_PAN | GIMBAL_AXIS_TILT;
+        status = backend_.write(pan_pulse, tilt_pulse, last_writes_);
+        if (!status) {
+            pan_pulse_ = 0;
+            tilt_pulse_ = 0;
+            return status;
+        }
+
+        pan_pulse_ = pan_pulse;
+        tilt_pulse_ = tilt_pulse;
+        pan_angle_ = 0.0f;
+        tilt_angle_ = 0.0f;
+        initialized_ = true;
+        return GimbalStatus::success();
+    }
+
+    /**
+     * @brief Set the PWM frame rate of each axis (before init())
+     *
+     * A command reaches a servo at its next frame, so the frame period is
+     * the worst-case actuation delay: 20 ms at 50 Hz, 3 ms at 333 Hz. The
+     * calibrated pulse range of the axis must fit inside the period. This
+     * does not know the servo model: Gimbal::setFrameRate() also checks the
+     * rate against the servo's profile.
+     * @return Success; InvalidArgument if initialized, or with the axis' pin
+     *         if its rate is below MIN_PWM_FREQUENCY, above
+     *         MAX_PWM_FREQUENCY or too short for its pulses
+     */
+    GimbalStatus setFrameRate(uint32_t pan_hz, uint32_t tilt_hz) {
+        if (initialized_) {
+            return GimbalStatus(GimbalError::InvalidArgument);
+        }
+        if (!fitsFrame(pan_calibration_, pan_hz)) {
+            return GimbalStatus(GimbalError::InvalidArgument, backend_.panPin());
+        }
+        if (!fitsFrame(tilt_calibration_, tilt_hz)) {
+            return GimbalStatus(GimbalError::InvalidArgument, backend_.tiltPin());
+        }
+        pan_frequency_ = pan_hz;
+        tilt_frequency_ = tilt_hz;
+        return GimbalStatus::success();
+    }
+
+    /// Pan frame rate in Hz
+    uint32_t getPanFrameRate() const { return pan_frequency_; }
+
+    /// Tilt frame rate in Hz
+    uint32_t getTiltFrameRate() const { return tilt_frequency_; }
+
+    /**
+     * @brief Release both pins (no-op if not initialized)
+     */
+    void shutdown() {
+        if (!initialized_) {
+            return;
+        }
+        backend_.shutdown();
+        pan_pulse_ = 0;
+        tilt_pulse_ = 0;
+        initialized_ = false;
+    }
+
+    /**
+     * @brief Set the gimbal tip angles
+     * @param pan_angle Pan angle in degrees (-90 to 90)
+     * @param tilt_angle Tilt angle in degrees (-90 to 90)
+     * @return Success; NotInitialized, InvalidAngle (with the axis' pin) or
+     *         the backend's failure
+     */
+    GimbalStatus setTipAngle(float pan_angle, float tilt_angle) {
+        last_writes_ = 0;
+        if (!initialized_) {
+            return GimbalStatus(GimbalError::NotInitialized);
+        }
+        if (!isValidAngle(pan_angle)) {
+            return GimbalStatus(GimbalError::InvalidAngle, backend_.panPin());
+        }
+        if (!isValidAngle(tilt_angle)) {
+            return GimbalStatus(GimbalError::InvalidAngle, backend_.tiltPin());
+        }
+
+        // Hold each axis where it is unless the request leaves the deadzone
+        pan_angle = applyDeadzone(pan_angle, pan_angle_);
+        tilt_angle = applyDeadzone(tilt_angle, tilt_angle_);
+
+        uint32_t pan_pulse = toPulse(pan_calibration_, pan_angle);
+        uint32_t tilt_pulse = toPulse(tilt_calibration_, tilt_angle);
+        uint8_t axes = (pan_pulse != pan_pulse_ ? GIMBAL_AXIS_PAN : 0) |
+                       (tilt_pulse != tilt_pulse_ ? GIMBAL_AXIS_TILT : 0);
+        last_writes_ = axes;
+
+        if (axes != 0) {
+            GimbalStatus status = backend_.write(pan_pulse, tilt_pulse, axes);
+            if (!status) {
+                // Output state unknown after a failed write: force the next one
+                pan_pulse_ = 0;
+                tilt_pulse_ = 0;
+                return status;
+            }
+            pan_pulse_ = pan_pulse;
+            tilt_pulse_ = tilt_pulse;
+        }
+
+        pan_angle_ = pan_angle;
+        tilt_angle_ = tilt_angle;
+        return GimbalStatus::success();
+    }
+
+    /// Committed pan angle in degrees
+    float getPanAngle() const { return pan_angle_; }
+
+    /// Committed tilt angle in degrees
+    float getTiltAngle() const { return tilt_angle_; }
+
+    /// Committed pan pulse in µs (0 = unknown)
+    uint32_t getPanPulse() const { return pan_pulse_; }
+
+    /// Committed tilt pulse in µs (0 = unknown)
+    uint32_t getTiltPulse() const { return tilt_pulse_; }
+
+    bool isInitialized() const { return initialized_; }
+
+    /**
+     * @brief Axes the latest init() / setTipAngle() passed to the backend
+     * @return GIMBAL_AXIS_* mask (0 if nothing was written)
+     */
+    uint8_t getLastWrites() const { return last_writes_; }
+
+    /**
+     * @brief Set the movement deadzone (0 disables the filter)
+     */
+    void setDeadzone(float degrees) { deadzone_ = degrees > 0.0f ? degrees : 0.0f; }
+
+    float getDeadzone() const { return deadzone_; }
+
+    /**
+     * @brief Check calibrations against the current frame rates
+     * @return Success, or InvalidArgument with the pin of an axis whose
+     *         end-stop pulses do not fit inside its frame
+     */
+    GimbalStatus checkCalibration(const Calibration& pan_calibration, const Calibration& tilt_calibration) const {
+        if (!fitsFrame(pan_calibration, pan_frequency_)) {
+            return GimbalStatus(GimbalError::InvalidArgument, backend_.panPin());
+        }
+        if (!fitsFrame(tilt_calibration, tilt_frequency_)) {
+            return GimbalStatus(GimbalError::InvalidArgument, backend_.tiltPin());
+        }
+        return GimbalStatus::success();
+    }
+
+    /**
+     * @brief Replace the calibration of both axes (takes effect on the next command)
+     * @return Success, or the checkCalibration() failure (calibration unchanged)
+     */
+    GimbalStatus setCalibration(const Calibration& pan_calibration, const Calibration& tilt_calibration) {
+        GimbalStatus status = checkCalibration(pan_calibration, tilt_calibration);
+        if (status) {
+            pan_calibration_ = pan_calibration;
+            tilt_calibration_ = tilt_calibration;
+        }
+        return status;
+    }
+
+    const Calibration& getPanCalibration() const { return pan_calibration_; }
+    const Calibration& getTiltCalibration() const { return tilt_calibration_; }
+
+    Backend& backend() { return backend_; }
+    const Backend& backend() const { return backend_; }
+
+    /**
+     * @brief Convert an angle with a calibration
+     * Fixed point with GIMBAL_FIXED_POINT.
+     */
+    static uint32_t toPulse(const Calibration& calibration, float angle) {
+#ifdef GIMBAL_FIXED_POINT
+        return calibration.toPulseWidthQ16(static_cast<int32_t>(angle * 65536.0f));
+#else
+        return calibration.toPulseWidth(angle);
+#endif
+    }
+
+private:
+    Backend backend_;
+    Calibration pan_calibration_;
+    Calibration tilt_calibration_;
+
+    // Committed angles and pulses (pulse 0 = unknown, always write)
+    float pan_angle_;
+    float tilt_angle_;
+    uint32_t pan_pulse_;
+    uint32_t tilt_pulse_;
+
+    // Frame rates passed to backend_.init()
+    uint32_t pan_frequency_;
+    uint32_t tilt_frequency_;
+
+    // Hysteresis filter width in degrees
+    float deadzone_;
+
+    uint8_t last_writes_;
+    bool initialized_;
+
+    static bool isValidAngle(float angle) { return angle >= MIN_ANGLE && angle <= MAX_ANGLE; }
+
+    /// Rate in range and both end-stop pulses shorter than its period
+    static bool fitsFrame(const Calibration& calibration, uint32_t hz) {
+        if (hz < MIN_PWM_FREQUENCY || hz > MAX_PWM_FREQUENCY) {
+            return false;
+        }
+        uint32_t period_us = 1000000 / hz;
+        return toPulse(calibration, MIN_ANGLE) < period_us && toPulse(calibration, MAX_ANGLE) < period_us;
+    }
+
+    float applyDeadzone(float requested, float current) const {
+        return std::fabs(requested - current) < deadzone_ ? current : requested;
+    }
+};
+
+#endif // BASIC_GIMBAL_H
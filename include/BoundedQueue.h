@@ -0,0 +1,128 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class BoundedQueue
+ * @brief Fixed-capacity lock-free multi-producer / multi-consumer FIFO
+ *
+ * Dmitry Vyukov's bounded queue: every cell carries a sequence number
+ * telling producers and consumers whose turn it is, so a push or pop is one
+ * CAS on the shared position plus one release store, and neither side ever
+ * blocks. All storage is inline; nothing is allocated.
+ *
+ * emplace() and consume() work on the cell in place, so large records (log
+ * messages) are written and read without an extra copy.
+ *
+ * @tparam T Element type (default constructible)
+ * @tparam Capacity Number of cells, a power of two
+ */
+template <typename T, size_t Capacity>
+class BoundedQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    BoundedQueue() : enqueue_pos_(0), dequeue_pos_(0) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Fill the next free cell in place
+     * @param fill Callable invoked as fill(T&) on the claimed cell
+     * @return false (fill not called) if the queue is full
+     */
+    template <typename Fill>
+    bool emplace(Fill&& fill) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & MASK];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Append a copy of a value
+     * @return false if the queue is full
+     */
+    bool push(const T& value) {
+        return emplace([&value](T& slot) { slot = value; });
+    }
+
+    /**
+     * @brief Remove the oldest element, reading it in place
+     * @param use Callable invoked as use(const T&) before the cell is released
+     * @return false (use not called) if the queue is empty
+     */
+    template <typename Use>
+    bool consume(Use&& use) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & MASK];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        use(static_cast<const T&>(cell->value));
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element
+     * @param out Receives the element
+     * @return false if the queue is empty
+     */
+    bool pop(T& out) {
+        return consume([&out](const T& value) { out = value; });
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Cell cells_[Capacity];
+    // Producers and consumers contend on different lines
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    alignas(64) std::atomic<size_t> dequeue_pos_;
+};
+
+#endif // BOUNDED_QUEUE_H
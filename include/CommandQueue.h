@@ -0,0 +1,127 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include "BoundedQueue.h"
+#include "GimbalConfig.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct GimbalCommand
+ * @brief Timestamped setpoint submitted to a CommandQueue
+ */
+struct GimbalCommand {
+    float pan_angle;         ///< Pan angle in degrees
+    float tilt_angle;        ///< Tilt angle in degrees
+    uint64_t timestamp_ns;   ///< Time the setpoint refers to (e.g. camera frame capture)
+    uint64_t enqueue_ns;     ///< Time submit() queued the command
+};
+
+/**
+ * @struct CommandQueueStats
+ * @brief Counters of a CommandQueue
+ *
+ * Latency is measured from submit() to recordApplied(); age from the
+ * command's own timestamp to recordApplied().
+ */
+struct CommandQueueStats {
+    uint64_t submitted;         ///< Commands queued by submit()
+    uint64_t applied;           ///< Commands passed to recordApplied()
+    uint64_t superseded;        ///< Commands dropped because a newer one arrived
+    uint64_t stale;             ///< Commands dropped as too old or out of order
+    uint64_t last_latency_ns;   ///< Enqueue-to-apply latency of the latest command
+    uint64_t max_latency_ns;    ///< Worst enqueue-to-apply latency observed
+    double mean_latency_ns;     ///< Mean enqueue-to-apply latency
+    uint64_t last_age_ns;       ///< Timestamp-to-apply age of the latest command
+};
+
+/**
+ * @class CommandQueue
+ * @brief Lock-free setpoint queue with latest-wins semantics
+ *
+ * Any number of producers submit() timestamped setpoints without blocking;
+ * one consumer (the control loop) calls takeLatest() once per tick. The
+ * consumer drains everything queued since the previous tick and keeps only
+ * the command with the newest timestamp, so a burst of setpoints costs one
+ * servo write and commands that arrive out of order can never move the
+ * gimbal backwards. When the queue is full, submit() evicts the oldest
+ * entry rather than losing the newest.
+ *
+ * Timestamps are CLOCK_MONOTONIC nanoseconds (time_us_64() * 1000 on Pico).
+ */
+class CommandQueue {
+public:
+    /// Number of queue slots
+    static constexpr size_t CAPACITY = GIMBAL_COMMAND_QUEUE_CAPACITY;
+
+    /**
+     * @brief Constructor
+     * @param max_age_ns Commands older than this when taken are dropped (0 = no limit)
+     */
+    explicit CommandQueue(uint64_t max_age_ns = 0);
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+     * @brief Queue a setpoint (lock-free, callable from any thread)
+     * @param pan_angle Pan angle in degrees
+     * @param tilt_angle Tilt angle in degrees
+     * @param timestamp_ns Time the setpoint refers to, 0 = now
+     */
+    void submit(float pan_angle, float tilt_angle, uint64_t timestamp_ns = 0);
+
+    /**
+     * @brief Take the newest pending command (consumer thread only)
+     * @param now_ns Current time, used for the age limit
+     * @param command Receives the newest command
+     * @return false if no command newer than the last one taken is pending
+     */
+    bool takeLatest(uint64_t now_ns, GimbalCommand& command);
+
+    /**
+     * @brief Drop pending and future commands not newer than a timestamp
+     *
+     * For consumers that also apply setpoints from another source.
+     * Consumer thread only.
+     */
+    void advance(uint64_t timestamp_ns);
+
+    /**
+     * @brief Record that a taken command reached the servos
+     * @param command Command returned by takeLatest()
+     * @param applied_ns Time the command was applied
+     */
+    void recordApplied(const GimbalCommand& command, uint64_t applied_ns);
+
+    /**
+     * @brief Snapshot of the queue counters
+     */
+    CommandQueueStats getStats() const;
+
+    /**
+     * @brief Reset the queue counters
+     */
+    void resetStats();
+
+    /**
+     * @brief Current time on the queue's clock in nanoseconds
+     */
+    static uint64_t now();
+
+private:
+    BoundedQueue<GimbalCommand, CAPACITY> queue_;
+    uint64_t max_age_ns_;
+    uint64_t newest_ns_;   // Consumer only: timestamp of the last command taken
+
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> applied_;
+    std::atomic<uint64_t> superseded_;
+    std::atomic<uint64_t> stale_;
+    std::atomic<uint64_t> last_latency_ns_;
+    std::atomic<uint64_t> max_latency_ns_;
+    std::atomic<uint64_t> total_latency_ns_;
+    std::atomic<uint64_t> last_age_ns_;
+};
+
+#endif // COMMAND_QUEUE_H
@@ -0,0 +1,174 @@
+#ifndef DUAL_CORE_GIMBAL_H
+#define DUAL_CORE_GIMBAL_H
+
+#include "Gimbal.h"
+#include "GimbalConfig.h"
+#include "InterCoreRing.h"
+#include <atomic>
+#include <cstdint>
+#ifndef PICO_BUILD
+#include <thread>
+#endif
+
+/**
+ * @struct CoreCommand
+ * @brief One target passed from core0 to the core1 loop (16 bytes)
+ */
+struct CoreCommand {
+    float pan_angle;      ///< Pan angle in degrees
+    float tilt_angle;     ///< Tilt angle in degrees
+    uint32_t sequence;    ///< Assigned by setTarget(), starting at 1
+    uint32_t issued_us;   ///< Low 32 bits of DualCoreGimbal::nowMicros() at setTarget()
+};
+
+/**
+ * @struct DualCoreStats
+ * @brief Counters of the core1 loop
+ *
+ * 32-bit counters: the RP2040 has no lock-free 64-bit atomics. At 50 Hz
+ * the frame counter wraps after 2.7 years, at 333 Hz after 149 days.
+ */
+struct DualCoreStats {
+    uint32_t frames;           ///< Alarm ticks executed on core1
+    uint32_t commands;         ///< Commands taken from the ring
+    uint32_t superseded;       ///< Commands replaced by a newer one within the same frame
+    uint32_t updates;          ///< Frames that commanded the gimbal
+    uint32_t failures;         ///< Frames where Gimbal::setTipAngle failed
+    uint32_t ring_full;        ///< setTarget() calls rejected because the ring was full
+    uint32_t missed_frames;    ///< Frame deadlines skipped after an overrun
+    uint32_t max_late_us;      ///< Worst delay between a deadline and its frame starting
+    uint32_t max_latency_us;   ///< Worst setTarget() -> written delay
+    uint32_t last_sequence;    ///< Sequence of the latest applied command (0 = none)
+    uint32_t last_error;       ///< GimbalError of the latest failure (0 = none)
+};
+
+/**
+ * @class DualCoreGimbal
+ * @brief Pico runtime: the gimbal loop on core1, commands from core0
+ *
+ * start() launches the loop on core1, which wakes on a hardware alarm at
+ * the frame rate (absolute deadlines, so it does not drift), takes every
+ * command queued since the previous frame and writes the newest one. Core0
+ * keeps USB stdio, logging and everything else; it hands targets over with
+ * setTarget(), a push into an InterCoreRing, and never touches the PWM
+ * hardware while the loop runs. The frame path has no stdio, no locks and
+ * no allocation, so USB interrupt servicing and printf() formatting on
+ * core0 no longer delay PWM updates.
+ *
+ * The SIO FIFO only carries the start handshake (this pointer) and the
+ * exit acknowledgement: a command (16 bytes) does not fit its 32-bit
+ * words without splitting, and the ring lets core0 queue several.
+ *
+ * Host builds run the identical loop on a std::thread with sleep_until()
+ * standing in for the alarm, so the ring and frame logic can be exercised
+ * in simulation (see dual_core_bench).
+ *
+ * Only one instance may run at a time on the Pico (there is one core1).
+ * Do not command the Gimbal directly while the loop is running, and keep
+ * GIMBAL_DEBUG_LOGGING off: Gimbal's debug log would run on core1.
+ */
+class DualCoreGimbal {
+public:
+    /// Commands core0 can queue ahead of the loop
+    static constexpr size_t RING_CAPACITY = GIMBAL_DUAL_CORE_RING_CAPACITY;
+
+    /**
+     * @brief Constructor
+     * @param gimbal Initialized gimbal driven by the loop (must outlive this object)
+     * @param frequency_hz Loop rate, 0 = the gimbal's frame rate (one tick per PWM frame)
+     */
+    explicit DualCoreGimbal(Gimbal& gimbal, uint32_t frequency_hz = 0);
+
+    /**
+     * @brief Destructor - stops the loop
+     */
+    ~DualCoreGimbal();
+
+    DualCoreGimbal(const DualCoreGimbal&) = delete;
+    DualCoreGimbal& operator=(const DualCoreGimbal&) = delete;
+
+    /**
+     * @brief Launch the loop on core1 (a thread on the host)
+     * @return false if already running or the gimbal is not initialized
+     */
+    bool start();
+
+    /**
+     * @brief Stop the loop and wait for it to exit (at most one frame)
+     */
+    void stop();
+
+    /**
+     * @brief Check if the loop is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Queue a target for the next frame (core0 only, never blocks)
+     * @param pan_angle Pan angle in degrees
+     * @param tilt_angle Tilt angle in degrees
+     * @return false if the ring is full (the target is dropped)
+     */
+    bool setTarget(float pan_angle, float tilt_angle);
+
+    /**
+     * @brief Snapshot of the loop counters (any core)
+     */
+    DualCoreStats getStats() const;
+
+    /**
+     * @brief One frame of the loop: drain the ring and write the newest target
+     *
+     * Called by the loop on core1; public so a host harness can step
+     * frames itself instead of calling start().
+     * @param deadline_us Deadline of this frame (nowMicros() clock)
+     * @param now_us Time the frame started
+     */
+    void runFrame(uint64_t deadline_us, uint64_t now_us);
+
+    /**
+     * @brief Microsecond clock of the loop (time_us_64() on the Pico)
+     */
+    static uint64_t nowMicros();
+
+private:
+    Gimbal& gimbal_;
+    uint32_t period_us_;
+
+    // Core0 -> core1 commands
+    InterCoreRing<CoreCommand, RING_CAPACITY> ring_;
+    uint32_t next_sequence_;   // core0 only
+
+    std::atomic<bool> running_;
+    std::atomic<bool> stop_requested_;
+#ifndef PICO_BUILD
+    std::thread thread_;
+#endif
+
+    // Counters, each with a single writer (ring_full_: core0, the rest: core1)
+    std::atomic<uint32_t> frames_;
+    std::atomic<uint32_t> commands_;
+    std::atomic<uint32_t> superseded_;
+    std::atomic<uint32_t> updates_;
+    std::atomic<uint32_t> failures_;
+    std::atomic<uint32_t> ring_full_;
+    std::atomic<uint32_t> missed_frames_;
+    std::atomic<uint32_t> max_late_us_;
+    std::atomic<uint32_t> max_latency_us_;
+    std::atomic<uint32_t> last_sequence_;
+    std::atomic<uint32_t> last_error_;
+
+    /**
+     * @brief Fixed-rate loop (runs on core1)
+     */
+    void loop();
+
+#ifdef PICO_BUILD
+    /**
+     * @brief Core1 entry point: receives the instance over the SIO FIFO
+     */
+    static void core1Entry();
+#endif
+};
+
+#endif // DUAL_CORE_GIMBAL_H
@@ -1,10 +1,32 @@
 #ifndef GIMBAL_H
 #define GIMBAL_H
 
+#include "BasicGimbal.h"
+#include "GimbalBackends.h"
 #include "PWMController.h"
+#include "ServoCalibration.h"
+#include "ServoProfile.h"
+#include "TelemetryRing.h"
+#ifndef PICO_BUILD
+#include "Seqlock.h"
+#endif
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
+/**
+ * @struct GimbalWriteStats
+ * @brief Counters of PWM writes issued to the controller versus skipped
+ *
+ * A write is suppressed when the quantized pulse width of an axis is the
+ * same as the one already committed, including when the deadzone holds the
+ * axis at its previous angle.
+ */
+struct GimbalWriteStats {
+    uint64_t issued;       ///< setPulseWidth calls made
+    uint64_t suppressed;   ///< Per-axis writes skipped as redundant
+};
+
 /**
  * @class Gimbal
  * @brief Basic 2D gimbal controller for MG90S servo motors
@@ -15,9 +37,26 @@
  * 
  * Platform-independent: works with any PWMController implementation
  * (RPi5 with pigpio, Pico with pico-sdk, etc.)
+ *
+ * Type-erased wrapper around BasicGimbal<DynamicBackend, ServoCalibration>:
+ * the controller and pins are chosen at run time and reached through a
+ * virtual call. Where they are known at compile time, BasicGimbal with a
+ * static backend (GimbalBackends.h) skips the indirection.
  */
 class Gimbal {
 public:
+    /// The command path this class wraps
+    using Core = BasicGimbal<DynamicBackend, ServoCalibration>;
+
+    /// Default servo PWM frame rate: 50 Hz (20ms period)
+    static constexpr uint32_t PWM_FREQUENCY = Core::PWM_FREQUENCY;
+
+    /// Lowest frame rate setFrameRate() accepts: 8 Hz (RP2040 slice limit)
+    static constexpr uint32_t MIN_PWM_FREQUENCY = Core::MIN_PWM_FREQUENCY;
+
+    /// Highest frame rate setFrameRate() accepts: 333 Hz (3ms period)
+    static constexpr uint32_t MAX_PWM_FREQUENCY = Core::MAX_PWM_FREQUENCY;
+
     /**
      * @brief Constructor for Gimbal controller
      * @param pwm_controller Platform-specific PWM controller (must be initialized)
@@ -42,9 +81,44 @@ public:
     /**
      * @brief Initialize the gimbal controller
      * Sets up GPIO pins, PWM, and centers the gimbal at (0, 0) degrees
-     * @return true if initialization successful, false otherwise
+     * @return Success, or the first failure
+     */
+    GimbalStatus init();
+
+    /**
+     * @brief Set the PWM frame rate of each axis (before init())
+     *
+     * Digital servos accept frames up to 333 Hz, so a command waits at
+     * most 3 ms for its frame instead of 20 ms. Analog servos must stay at
+     * 50 Hz: each rate is checked against the axis' servo profile
+     * (getServoProfile()) first.
+     * @param pan_hz Pan frame rate in Hz
+     * @param tilt_hz Tilt frame rate in Hz
+     * @param pan_model Servo on the pan axis
+     * @param tilt_model Servo on the tilt axis
+     * @return Success; InvalidArgument (with the axis' pin and the rate in
+     *         getErrorStats()) if initialized, if the rate exceeds the
+     *         servo's rating or MAX_PWM_FREQUENCY, is below
+     *         MIN_PWM_FREQUENCY, or if the calibrated pulses do not fit its
+     *         period
      */
-    bool init();
+    GimbalStatus setFrameRate(uint32_t pan_hz, uint32_t tilt_hz, ServoModel pan_model, ServoModel tilt_model);
+
+    /**
+     * @brief Set the frame rates for the GIMBAL_CALIBRATION_SERVO model on both axes
+     */
+    GimbalStatus setFrameRate(uint32_t pan_hz, uint32_t tilt_hz);
+
+    /// Pan frame rate in Hz
+    uint32_t getPanFrameRate() const;
+
+    /// Tilt frame rate in Hz
+    uint32_t getTiltFrameRate() const;
+
+    /**
+     * @brief Rate of the faster axis: how often a control loop can usefully command the gimbal
+     */
+    uint32_t getFrameRate() const;
 
     /**
      * @brief Shut down the gimbal controller
@@ -56,9 +130,11 @@ public:
      * @brief Set the gimbal tip angles
      * @param pan_angle Pan angle in degrees (-90 to 90, where 0 is center)
      * @param tilt_angle Tilt angle in degrees (-90 to 90, where 0 is center)
-     * @return true if angles are valid and set successfully, false otherwise
+     * @return Success; InvalidAngle, NotInitialized, or the controller's
+     *         failure if the write was rejected. Failures are counted in
+     *         getErrorStats() and never logged from this path.
      */
-    bool setTipAngle(float pan_angle, float tilt_angle);
+    GimbalStatus setTipAngle(float pan_angle, float tilt_angle);
 
     /**
      * @brief Get the current pan angle
@@ -78,54 +154,121 @@ public:
      */
     bool isInitialized() const;
 
-private:
-    // PWM controller (platform-specific implementation)
-    std::shared_ptr<PWMController> pwm_controller_;
-    
-    // GPIO and PWM configuration
-    uint32_t pan_pin_;
-    uint32_t tilt_pin_;
-    
-    // Servo angle tracking
-    float current_pan_angle_;
-    float current_tilt_angle_;
-    
-    // Initialization state
-    bool initialized_;
+    /**
+     * @brief Set the movement deadzone (hysteresis)
+     * Requested angles closer than this to the committed angle are ignored.
+     * @param degrees Deadzone width in degrees (0 disables the filter)
+     */
+    void setDeadzone(float degrees);
+
+    /**
+     * @brief Get the movement deadzone
+     * @return Deadzone width in degrees
+     */
+    float getDeadzone() const;
+
+    /**
+     * @brief Replace the servo calibration of both axes
+     *
+     * On Linux this may be called from any thread while another one is
+     * commanding the gimbal: the new calibration is published through a
+     * seqlock and adopted at the start of the next setTipAngle(), so the
+     * table is built off the command path and the swap is atomic.
+     * On Pico it takes effect immediately.
+     *
+     * The end-stop pulses of each axis must fit inside its frame (see
+     * setFrameRate(); rates are fixed once init() has run), otherwise
+     * every later write would fail.
+     *
+     * @param calibration Calibration of pan and tilt
+     * @return Success, or InvalidArgument with the pin of the axis that
+     *         does not fit (calibration unchanged, failure recorded)
+     */
+    GimbalStatus setCalibration(const GimbalCalibration& calibration);
+
+    /**
+     * @brief Calibration most recently set (a copy)
+     *
+     * On Linux this is the last one published by setCalibration(), which
+     * the next command adopts; safe to call from any thread.
+     */
+    GimbalCalibration getCalibration() const;
 
-    // PWM constants for MG90S servo motor
-    // MG90S specifications:
-    // - Operating voltage: 3-7V
-    // - Pulse width: 1000-2000 microseconds
-    // - 1000 µs = -90°, 1500 µs = 0°, 2000 µs = +90°
-    static constexpr uint32_t PWM_FREQUENCY = 50;      // 50 Hz (20ms period)
-    static constexpr uint32_t MIN_PULSE_WIDTH = 1000;  // 1000 µs for -90°
-    static constexpr uint32_t MID_PULSE_WIDTH = 1500;  // 1500 µs for 0°
-    static constexpr uint32_t MAX_PULSE_WIDTH = 2000;  // 2000 µs for +90°
-    static constexpr float MAX_ANGLE = 90.0f;          // ±90 degrees
-    static constexpr float MIN_ANGLE = -90.0f;
+#ifndef PICO_BUILD
+    /**
+     * @brief Load a calibration file (see loadCalibrationFile()) and apply it
+     * @param path INI calibration file
+     * @return false if the file is missing or malformed, or setCalibration()
+     *         rejects it (calibration unchanged)
+     */
+    bool loadCalibration(const char* path);
+#endif
 
     /**
-     * @brief Convert angle to PWM pulse width in microseconds
-     * @param angle Angle in degrees (-90 to 90)
-     * @return Pulse width in microseconds (1000-2000)
+     * @brief Get counters of issued versus suppressed PWM writes
+     * @return Snapshot of the write counters
      */
-    uint32_t angleToPulseWidth(float angle) const;
+    GimbalWriteStats getWriteStats() const;
+
+    /**
+     * @brief Reset the write counters to zero
+     */
+    void resetWriteStats();
+
+    /**
+     * @brief Failure counters and last failure of this gimbal
+     *
+     * Counts what init() and setTipAngle() returned; the controller keeps
+     * its own counters (PWMController::getErrorStats()).
+     */
+    const GimbalErrorStats& getErrorStats() const;
+
+    /**
+     * @brief Reset the failure counters
+     */
+    void resetErrorStats();
+
+    /**
+     * @brief Flight recorder of the latest commands
+     *
+     * Every setTipAngle() (and the centering write of init()) appends the
+     * requested angles, the pulses committed, the controller call duration
+     * and the result. Safe to snapshot or dump from another thread.
+     */
+    const TelemetryRing& getTelemetryRing() const;
+
+private:
+    // Angle -> pulse path over the run-time controller and pins
+    Core core_;
+
+#ifndef PICO_BUILD
+    // Hot-reload mailbox and the version adopted into core_
+    Seqlock<GimbalCalibration> calibration_mailbox_;
+    uint32_t calibration_version_;
+#endif
+
+    // Write coalescing counters (single writer: the commanding thread)
+    std::atomic<uint64_t> writes_issued_;
+    std::atomic<uint64_t> writes_suppressed_;
+
+    // Failure counters and last failure context
+    GimbalErrorStats errors_;
+
+    // Per-command flight recorder (single writer: the commanding thread)
+    TelemetryRing telemetry_;
 
     /**
-     * @brief Validate angle is within acceptable range
-     * @param angle Angle in degrees
-     * @return true if angle is valid, false otherwise
+     * @brief Adopt a calibration published by setCalibration() from another thread
      */
-    bool isValidAngle(float angle) const;
+    void refreshCalibration();
 
     /**
-     * @brief Apply PWM signal to servo motor
-     * @param pin GPIO pin number
-     * @param pulse_width Pulse width in microseconds
-     * @return true if successful, false otherwise
+     * @brief Count the writes of the latest core command and append its record
+     * @param record Record with the requested angles
+     * @param status Outcome of the command
+     * @param filtered Whether the command got past validation to write filtering
      */
-    bool setPWM(uint32_t pin, uint32_t pulse_width);
+    void recordCommand(TelemetryRecord& record, GimbalStatus status, bool filtered);
 };
 
 #endif // GIMBAL_H
@@ -0,0 +1,204 @@
+#ifndef GIMBAL_ARRAY_H
+#define GIMBAL_ARRAY_H
+
+#include "Gimbal.h"
+#include "GimbalConfig.h"
+#include "PWMController.h"
+#include "ServoProfile.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct AxisCalibration
+ * @brief Linear angle -> pulse mapping and PWM frame rate of one servo axis
+ */
+struct AxisCalibration {
+    float min_angle = -90.0f;        ///< Angle at min_pulse_us (degrees)
+    float max_angle = 90.0f;         ///< Angle at max_pulse_us (degrees)
+    uint32_t min_pulse_us = 1000;    ///< Pulse width at min_angle
+    uint32_t max_pulse_us = 2000;    ///< Pulse width at max_angle
+    ServoModel model = ServoModel::GIMBAL_CALIBRATION_SERVO;   ///< Servo on the axis; bounds frequency_hz
+    uint32_t frequency_hz = GIMBAL_PWM_FREQUENCY;              ///< PWM frame rate of the axis
+
+    /**
+     * @brief End points of a model's default calibration, at the fastest
+     *        frame rate its ServoProfile is rated for
+     */
+    static AxisCalibration forServo(ServoModel model);
+};
+
+/**
+ * @class GimbalArray
+ * @brief Drives many servo axes (e.g. several pan/tilt heads) through one PWM controller
+ *
+ * Axis state is kept in struct-of-arrays form, so update() converts every
+ * axis in one branch-free pass the compiler can vectorize (clamp, deadzone,
+ * angle -> pulse), then compacts the axes whose pulse changed into a single
+ * PWMController::setPulseWidths call. Per-frame cost is linear in the
+ * number of axes, with no allocation after init().
+ *
+ * Targets are staged with setTarget()/setHead() and take effect at the next
+ * update(). Not thread-safe: stage and update from one thread (or behind
+ * the caller's own lock).
+ */
+class GimbalArray {
+public:
+    /**
+     * @brief Constructor
+     * @param pwm_controller Shared PWM controller for every axis
+     */
+    explicit GimbalArray(std::shared_ptr<PWMController> pwm_controller);
+
+    /**
+     * @brief Constructor taking ownership of a raw controller
+     * @param pwm_controller PWM controller (deleted with the array)
+     */
+    explicit GimbalArray(PWMController* pwm_controller);
+
+    /**
+     * @brief Destructor - shuts down all axes
+     */
+    ~GimbalArray();
+
+    GimbalArray(const GimbalArray&) = delete;
+    GimbalArray& operator=(const GimbalArray&) = delete;
+
+    /**
+     * @brief Add one servo axis (before init())
+     *
+     * The frame rate must be one the PWM backends accept and the servo's
+     * profile is rated for, with both end-stop pulses shorter than its
+     * period (as Gimbal::setFrameRate() checks).
+     * @param pin GPIO pin of the servo
+     * @param calibration Angle -> pulse mapping and frame rate of the servo
+     * @return Axis index, or -1 if the array is already initialized or the
+     *         calibration is invalid (counted in getErrorStats())
+     */
+    int addAxis(uint32_t pin, const AxisCalibration& calibration = AxisCalibration());
+
+    /**
+     * @brief Add a pan/tilt head as two consecutive axes (before init())
+     * @param pan_pin GPIO pin of the pan servo
+     * @param tilt_pin GPIO pin of the tilt servo
+     * @return Index of the pan axis (tilt is the next one), or -1 on error
+     */
+    int addHead(uint32_t pan_pin, uint32_t tilt_pin);
+
+    /**
+     * @brief Initialize every axis and center it
+     * @return Success; DeviceUnavailable without a controller, InvalidArgument
+     *         without axes, or the controller's failure (pins initialized so
+     *         far are shut down again). Failures are counted in getErrorStats().
+     */
+    GimbalStatus init();
+
+    /**
+     * @brief Stop PWM output on every axis
+     */
+    void shutdown();
+
+    /**
+     * @brief Stage the target angle of one axis
+     * @param axis Axis index
+     * @param angle Angle in degrees within the axis calibration range
+     * @return Success; NotInitialized, InvalidArgument for an unknown axis, or
+     *         InvalidAngle (with the axis' pin). Failures are counted in
+     *         getErrorStats() and never logged from this path.
+     */
+    GimbalStatus setTarget(size_t axis, float angle);
+
+    /**
+     * @brief Stage the targets of a range of consecutive axes
+     * @param first First axis index
+     * @param angles Angles in degrees
+     * @param count Number of axes
+     * @return Success, or the first failure (valid axes are staged)
+     */
+    GimbalStatus setTargets(size_t first, const float* angles, size_t count);
+
+    /**
+     * @brief Stage pan and tilt of a head added with addHead()
+     * @param pan_axis Index returned by addHead()
+     * @return Success, or the first failure (a valid axis is staged)
+     */
+    GimbalStatus setHead(size_t pan_axis, float pan_angle, float tilt_angle);
+
+    /**
+     * @brief Convert all staged targets and write the changed pulses in one batch
+     * @return Success (also when nothing changed), or the controller's failure
+     *         (also counted in getErrorStats())
+     */
+    GimbalStatus update();
+
+    /**
+     * @brief Angle last committed for an axis
+     */
+    float getAngle(size_t axis) const;
+
+    /**
+     * @brief Pulse width last committed for an axis (0 = unknown)
+     */
+    uint32_t getPulseWidth(size_t axis) const;
+
+    /**
+     * @brief Number of axes
+     */
+    size_t size() const { return pins_.size(); }
+
+    bool isInitialized() const { return initialized_; }
+
+    /**
+     * @brief Set the movement deadzone applied to every axis
+     * @param degrees Deadzone width in degrees (0 disables the filter)
+     */
+    void setDeadzone(float degrees);
+    float getDeadzone() const { return deadzone_; }
+
+    /**
+     * @brief Counters of issued versus suppressed per-axis writes
+     */
+    GimbalWriteStats getWriteStats() const;
+    void resetWriteStats();
+
+    /**
+     * @brief Failure counters and last failure of this array
+     *
+     * Counts what init(), the setTarget() family and update() returned; the
+     * controller keeps its own counters (PWMController::getErrorStats()).
+     */
+    const GimbalErrorStats& getErrorStats() const { return errors_; }
+    void resetErrorStats() { errors_.reset(); }
+
+private:
+    std::shared_ptr<PWMController> pwm_controller_;
+
+    // Per-axis configuration
+    std::vector<uint32_t> pins_;
+    std::vector<float> min_angle_;
+    std::vector<float> max_angle_;
+    std::vector<float> pulse_offset_;   // Pulse width at 0 degrees (µs)
+    std::vector<float> pulse_scale_;    // µs per degree
+    std::vector<uint32_t> frequency_;   // PWM frame rate (Hz)
+    std::vector<uint32_t> period_us_;   // Frame period handed to the controller
+
+    // Per-axis state
+    std::vector<float> target_;
+    std::vector<float> current_;
+    std::vector<uint32_t> pulse_;       // Committed (0 = unknown, always write)
+    std::vector<uint32_t> next_pulse_;  // Output of the conversion pass
+
+    // Batch handed to the controller, sized once in init()
+    std::vector<PulseCommand> commands_;
+
+    float deadzone_;
+    uint64_t writes_issued_;
+    uint64_t writes_suppressed_;
+    bool initialized_;
+    GimbalErrorStats errors_;
+
+    void convertAll();
+};
+
+#endif // GIMBAL_ARRAY_H
@@ -0,0 +1,324 @@
+#ifndef GIMBAL_BACKENDS_H
+#define GIMBAL_BACKENDS_H
+
+#include "BasicGimbal.h"
+#include "PWMController.h"
+#include "PWMControllerPico.h"
+#include "PicoPWMConfig.h"
+#include "TelemetryRing.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifdef PICO_BUILD
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#endif
+
+/**
+ * @file GimbalBackends.h
+ * @brief PWM backends for BasicGimbal
+ *
+ * - DynamicBackend: any PWMController behind a shared_ptr, pins chosen at
+ *   run time, one virtual setPulseWidths() per command. Used by Gimbal.
+ * - ControllerBackend: a concrete controller with compile-time pins,
+ *   called non-virtually so the compiler can inline the controller.
+ * - PicoServoBackend: RP2040 PWM slices programmed directly, compile-time
+ *   pins; a command is one or two compare-register stores.
+ */
+
+/**
+ * @class DynamicBackend
+ * @brief Type-erased backend: a shared PWMController and run-time pins
+ *
+ * Times each controller call with TelemetryRing::ticks() for Gimbal's
+ * flight recorder.
+ */
+class DynamicBackend {
+public:
+    DynamicBackend(std::shared_ptr<PWMController> controller, uint32_t pan_pin, uint32_t tilt_pin)
+        : controller_(std::move(controller)),
+          pan_pin_(pan_pin),
+          tilt_pin_(tilt_pin),
+          pan_period_us_(0),
+          tilt_period_us_(0),
+          call_start_(0),
+          call_ticks_(0) {}
+
+    GimbalStatus init(uint32_t pan_frequency, uint32_t tilt_frequency) {
+        if (!controller_) {
+            return GimbalStatus(GimbalError::DeviceUnavailable);
+        }
+        GimbalStatus status = controller_->initPin(pan_pin_, pan_frequency);
+        if (!status) {
+            return status;
+        }
+        status = controller_->initPin(tilt_pin_, tilt_frequency);
+        if (!status) {
+            return status;
+        }
+        pan_period_us_ = 1000000 / pan_frequency;
+        tilt_period_us_ = 1000000 / tilt_frequency;
+        return GimbalStatus::success();
+    }
+
+    GimbalStatus write(uint32_t pan_us, uint32_t tilt_us, uint8_t axes) {
+        PulseCommand commands[2];
+        size_t count = 0;
+        if (axes & GIMBAL_AXIS_PAN) {
+            commands[count++] = PulseCommand{pan_pin_, pan_us, pan_period_us_};
+        }
+        if (axes & GIMBAL_AXIS_TILT) {
+            commands[count++] = PulseCommand{tilt_pin_, tilt_us, tilt_period_us_};
+        }
+        call_start_ = TelemetryRing::ticks();
+        GimbalStatus status = controller_->setPulseWidths(commands, count);
+        call_ticks_ = TelemetryRing::ticks() - call_start_;
+        return status;
+    }
+
+    void shutdown() {
+        if (controller_) {
+            controller_->shutdownPin(pan_pin_);
+            controller_->shutdownPin(tilt_pin_);
+        }
+    }
+
+    uint32_t panPin() const { return pan_pin_; }
+    uint32_t tiltPin() const { return tilt_pin_; }
+
+    PWMController* controller() const { return controller_.get(); }
+
+    /// TelemetryRing::ticks() at the start of the latest write()
+    uint64_t lastCallStart() const { return call_start_; }
+
+    /// Ticks spent in the latest write()
+    uint64_t lastCallTicks() const { return call_ticks_; }
+
+private:
+    std::shared_ptr<PWMController> controller_;
+    uint32_t pan_pin_;
+    uint32_t tilt_pin_;
+    uint32_t pan_period_us_;    // Precomputed per pin by init()
+    uint32_t tilt_period_us_;
+    uint64_t call_start_;
+    uint64_t call_ticks_;
+};
+
+/**
+ * @class ControllerBackend
+ * @brief A concrete PWMController with pins fixed at compile time
+ * @tparam Controller Concrete controller type (not owned)
+ * @tparam PanPin GPIO of the pan servo
+ * @tparam TiltPin GPIO of the tilt servo
+ *
+ * Calls are qualified with the controller type, so they bind statically
+ * and can be inlined.
+ */
+template <typename Controller, uint32_t PanPin, uint32_t TiltPin>
+class ControllerBackend {
+    static_assert(std::is_base_of<PWMController, Controller>::value, "Controller must be a PWMController");
+    static_assert(!std::is_abstract<Controller>::value, "Controller must be a concrete backend");
+    static_assert(PanPin != TiltPin, "pan and tilt need separate pins");
+
+public:
+    explicit ControllerBackend(Controller& controller)
+        : controller_(&controller), pan_period_us_(0), tilt_period_us_(0) {}
+
+    GimbalStatus init(uint32_t pan_frequency, uint32_t tilt_frequency) {
+        GimbalStatus status = controller_->Controller::initPin(PanPin, pan_frequency);
+        if (!status) {
+            return status;
+        }
+        status = controller_->Controller::initPin(TiltPin, tilt_frequency);
+        if (!status) {
+            return status;
+        }
+        pan_period_us_ = 1000000 / pan_frequency;
+        tilt_period_us_ = 1000000 / tilt_frequency;
+        return GimbalStatus::success();
+    }
+
+    GimbalStatus write(uint32_t pan_us, uint32_t tilt_us, uint8_t axes) {
+        PulseCommand commands[2];
+        size_t count = 0;
+        if (axes & GIMBAL_AXIS_PAN) {
+            commands[count++] = PulseCommand{PanPin, pan_us, pan_period_us_};
+        }
+        if (axes & GIMBAL_AXIS_TILT) {
+            commands[count++] = PulseCommand{TiltPin, tilt_us, tilt_period_us_};
+        }
+        return controller_->Controller::setPulseWidths(commands, count);
+    }
+
+    void shutdown() {
+        controller_->Controller::shutdownPin(PanPin);
+        controller_->Controller::shutdownPin(TiltPin);
+    }
+
+    static constexpr uint32_t panPin() { return PanPin; }
+    static constexpr uint32_t tiltPin() { return TiltPin; }
+
+    Controller& controller() const { return *controller_; }
+
+private:
+    Controller* controller_;
+    uint32_t pan_period_us_;
+    uint32_t tilt_period_us_;
+};
+
+/**
+ * @class PicoServoBackend
+ * @brief RP2040 PWM slices driven directly, pins fixed at compile time
+ * @tparam PanPin GPIO of the pan servo
+ * @tparam TiltPin GPIO of the tilt servo
+ *
+ * Slices are configured with solvePicoPWMConfig() as in PWMControllerPico,
+ * and slice, channel and register offsets are compile-time constants.
+ * When both pins share a slice (e.g. GPIO 16 and 17) a command is a single
+ * store of the slice's compare register, so both channels latch at the
+ * same counter wrap; such pins must use the same frame rate. Pins on
+ * different slices may run at different rates. The pins are owned by this backend: do not use them
+ * through a PWMControllerPico at the same time.
+ *
+ * Outside PICO_BUILD the compare registers are simulated (compare()).
+ */
+template <uint32_t PanPin, uint32_t TiltPin>
+class PicoServoBackend {
+    static_assert(PanPin < PWMControllerPico::MAX_PINS && TiltPin < PWMControllerPico::MAX_PINS,
+                  "pins must be RP2040 bank 0 GPIOs");
+    static_assert(PanPin != TiltPin, "pan and tilt need separate pins");
+
+public:
+    static constexpr uint32_t PAN_SLICE = (PanPin >> 1) % PWMControllerPico::MAX_SLICES;
+    static constexpr uint32_t TILT_SLICE = (TiltPin >> 1) % PWMControllerPico::MAX_SLICES;
+    static constexpr uint32_t PAN_CHANNEL = PanPin & 1u;    // 0 = A, 1 = B
+    static constexpr uint32_t TILT_CHANNEL = TiltPin & 1u;
+    static constexpr bool SHARED_SLICE = PAN_SLICE == TILT_SLICE;
+
+    PicoServoBackend() : pan_config_{}, tilt_config_{}, pan_period_us_(0), tilt_period_us_(0), compare_{} {}
+
+    GimbalStatus init(uint32_t pan_frequency, uint32_t tilt_frequency) {
+#ifdef PICO_BUILD
+        uint32_t clock_speed = clock_get_hz(clk_sys);
+#else
+        uint32_t clock_speed = PWMControllerPico::SIM_SYS_CLOCK_HZ;
+#endif
+        if (pan_frequency < GIMBAL_PWM_MIN_FREQUENCY || pan_frequency > GIMBAL_PWM_MAX_FREQUENCY ||
+            !solvePicoPWMConfig(clock_speed, pan_frequency, pan_config_)) {
+            return GimbalStatus(GimbalError::InvalidArgument, PanPin);
+        }
+        if (tilt_frequency < GIMBAL_PWM_MIN_FREQUENCY || tilt_frequency > GIMBAL_PWM_MAX_FREQUENCY ||
+            (SHARED_SLICE && tilt_frequency != pan_frequency) ||
+            !solvePicoPWMConfig(clock_speed, tilt_frequency, tilt_config_)) {
+            return GimbalStatus(GimbalError::InvalidArgument, TiltPin);
+        }
+        pan_period_us_ = 1000000 / pan_frequency;
+        tilt_period_us_ = 1000000 / tilt_frequency;
+
+#ifdef PICO_BUILD
+        configureSlice(PAN_SLICE, pan_config_);
+        if (!SHARED_SLICE) {
+            configureSlice(TILT_SLICE, tilt_config_);
+        }
+        gpio_set_function(PanPin, GPIO_FUNC_PWM);
+        gpio_set_function(TiltPin, GPIO_FUNC_PWM);
+#endif
+        return GimbalStatus::success();
+    }
+
+    GimbalStatus write(uint32_t pan_us, uint32_t tilt_us, uint8_t axes) {
+        uint32_t pan_level = level(pan_config_, pan_period_us_, pan_us);
+        uint32_t tilt_level = level(tilt_config_, tilt_period_us_, tilt_us);
+        if (SHARED_SLICE) {
+            // Channel A in the low half, B in the high half of one register
+            storeCompare(PAN_SLICE, (pan_level << (16 * PAN_CHANNEL)) | (tilt_level << (16 * TILT_CHANNEL)));
+        } else {
+            if (axes & GIMBAL_AXIS_PAN) {
+                storeChannel(PAN_SLICE, PAN_CHANNEL, pan_level);
+            }
+            if (axes & GIMBAL_AXIS_TILT) {
+                storeChannel(TILT_SLICE, TILT_CHANNEL, tilt_level);
+            }
+        }
+        return GimbalStatus::success();
+    }
+
+    void shutdown() {
+        storeChannel(PAN_SLICE, PAN_CHANNEL, 0);
+        storeChannel(TILT_SLICE, TILT_CHANNEL, 0);
+#ifdef PICO_BUILD
+        pwm_set_enabled(PAN_SLICE, false);
+        if (!SHARED_SLICE) {
+            pwm_set_enabled(TILT_SLICE, false);
+        }
+#endif
+    }
+
+    static constexpr uint32_t panPin() { return PanPin; }
+    static constexpr uint32_t tiltPin() { return TiltPin; }
+
+    /// Slice configurations solved by init()
+    const PicoPWMConfig& getPanConfig() const { return pan_config_; }
+    const PicoPWMConfig& getTiltConfig() const { return tilt_config_; }
+
+    /// Current compare register of a slice (channel A low, B high)
+    uint32_t compare(uint32_t slice) const {
+#ifdef PICO_BUILD
+        return pwm_hw->slice[slice].cc;
+#else
+        return compare_[slice];
+#endif
+    }
+
+private:
+    PicoPWMConfig pan_config_;
+    PicoPWMConfig tilt_config_;
+    uint32_t pan_period_us_;
+    uint32_t tilt_period_us_;
+    // Simulated compare registers (unused on hardware)
+    volatile uint32_t compare_[PWMControllerPico::MAX_SLICES];
+
+    /// Pulse width -> counter level with the slice's real counter rate
+    static uint32_t level(const PicoPWMConfig& config, uint32_t period_us, uint32_t pulse_width_us) {
+        if (pulse_width_us > period_us) {
+            pulse_width_us = period_us;
+        }
+#ifdef GIMBAL_FIXED_POINT
+        uint32_t counts = (pulse_width_us * config.counts_per_us_q12 + 2048u) >> 12;
+#else
+        uint32_t counts = static_cast<uint32_t>(static_cast<float>(pulse_width_us) * config.counts_per_us + 0.5f);
+#endif
+        return counts > config.wrap ? config.wrap : counts;
+    }
+
+    void storeCompare(uint32_t slice, uint32_t value) {
+#ifdef PICO_BUILD
+        pwm_hw->slice[slice].cc = value;
+#else
+        compare_[slice] = value;
+#endif
+    }
+
+    void storeChannel(uint32_t slice, uint32_t channel, uint32_t value) {
+#ifdef PICO_BUILD
+        pwm_set_chan_level(slice, channel, static_cast<uint16_t>(value));
+#else
+        uint32_t shift = 16 * channel;
+        compare_[slice] = (compare_[slice] & ~(0xFFFFu << shift)) | (value << shift);
+#endif
+    }
+
+#ifdef PICO_BUILD
+    static void configureSlice(uint32_t slice, const PicoPWMConfig& config) {
+        pwm_set_clkdiv_int_frac(slice, config.div_int, config.div_frac);
+        pwm_set_wrap(slice, config.wrap);
+        pwm_set_enabled(slice, true);
+    }
+#endif
+};
+
+#endif // GIMBAL_BACKENDS_H
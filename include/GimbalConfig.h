@@ -23,8 +23,19 @@
 // =============================================================================
 
 /// PWM frequency in Hz (standard for servo: 50 Hz = 20ms period)
+/// Default of both axes; Gimbal::setFrameRate() sets it per axis
 #define GIMBAL_PWM_FREQUENCY 50
 
+/// Highest servo frame rate the PWM backends accept (Hz); digital servos
+/// take up to 333 Hz (3 ms period), analog ones are limited by ServoProfile
+#define GIMBAL_PWM_MAX_FREQUENCY 333
+
+/// Lowest frame rate the PWM backends accept (Hz): a 16-bit RP2040 slice at
+/// the largest divider (255 + 15/16) and 125 MHz cannot run slower than 7.45 Hz
+#ifndef GIMBAL_PWM_MIN_FREQUENCY
+#define GIMBAL_PWM_MIN_FREQUENCY 8
+#endif
+
 /// Minimum pulse width in microseconds (servo at -90 degrees)
 #define GIMBAL_MIN_PULSE_WIDTH 1000
 
@@ -57,12 +68,113 @@
 /// Enable hardware PWM control (requires pigpio)
 // #define GIMBAL_ENABLE_PIGPIO
 
-/// Enable debug logging
+/// Enable debug logging (compiles in per-command trace messages)
 // #define GIMBAL_DEBUG_LOGGING
 
 /// Enable angle smoothing/interpolation
 // #define GIMBAL_ENABLE_SMOOTHING
 
+// =============================================================================
+// LOGGING
+// =============================================================================
+
+/**
+ * Compile-time log level. Messages above this level are removed by the
+ * preprocessor, so their arguments are never evaluated or formatted.
+ * 0 = off, 1 = error, 2 = warning, 3 = info, 4 = debug
+ */
+#ifndef GIMBAL_LOG_LEVEL
+#ifdef GIMBAL_DEBUG_LOGGING
+#define GIMBAL_LOG_LEVEL 4
+#else
+#define GIMBAL_LOG_LEVEL 3
+#endif
+#endif
+
+/// Number of slots in the log ring buffer (must be a power of two)
+#ifndef GIMBAL_LOG_RING_CAPACITY
+#define GIMBAL_LOG_RING_CAPACITY 256
+#endif
+
+/// Maximum formatted length of a single log message, including terminator
+#ifndef GIMBAL_LOG_MESSAGE_SIZE
+#define GIMBAL_LOG_MESSAGE_SIZE 120
+#endif
+
+// =============================================================================
+// COMMAND QUEUE
+// =============================================================================
+
+/// Slots in the asynchronous command queue (must be a power of two); when it
+/// is full, submitting drops the oldest queued command
+#ifndef GIMBAL_COMMAND_QUEUE_CAPACITY
+#define GIMBAL_COMMAND_QUEUE_CAPACITY 64
+#endif
+
+// =============================================================================
+// TELEMETRY
+// =============================================================================
+
+/// Records kept in each Gimbal's telemetry ring (must be a power of two);
+/// older records are overwritten
+#ifndef GIMBAL_TELEMETRY_RING_CAPACITY
+#ifdef PICO_BUILD
+#define GIMBAL_TELEMETRY_RING_CAPACITY 64
+#else
+#define GIMBAL_TELEMETRY_RING_CAPACITY 1024
+#endif
+#endif
+
+// =============================================================================
+// DUAL-CORE RUNTIME (PICO)
+// =============================================================================
+
+/// Commands core0 can queue for the core1 loop (must be a power of two);
+/// setTarget() fails while the ring is full
+#ifndef GIMBAL_DUAL_CORE_RING_CAPACITY
+#define GIMBAL_DUAL_CORE_RING_CAPACITY 16
+#endif
+
+// =============================================================================
+// IMU STABILIZATION
+// =============================================================================
+
+/// IMU samples an ImuBufferSource holds between two polls of the control
+/// loop (must be a power of two); 64 covers 50 ms at 1 kHz
+#ifndef GIMBAL_IMU_BUFFER_CAPACITY
+#define GIMBAL_IMU_BUFFER_CAPACITY 64
+#endif
+
+/// Mahony filter proportional gain (rad/s per unit error); lower rides
+/// through vibration on the gyro, higher corrects drift faster
+#ifndef GIMBAL_IMU_MAHONY_KP
+#define GIMBAL_IMU_MAHONY_KP 1.0f
+#endif
+
+/// Mahony filter integral gain (gyro bias learning, 0 = off)
+#ifndef GIMBAL_IMU_MAHONY_KI
+#define GIMBAL_IMU_MAHONY_KI 0.3f
+#endif
+
+// =============================================================================
+// UDP COMMAND PROTOCOL (LINUX)
+// =============================================================================
+
+/// Default UDP port of GimbalUdpServer
+#ifndef GIMBAL_UDP_PORT
+#define GIMBAL_UDP_PORT 5760
+#endif
+
+/// Datagrams drained per recvmmsg() call (and acks per sendmmsg())
+#ifndef GIMBAL_UDP_BATCH
+#define GIMBAL_UDP_BATCH 64
+#endif
+
+/// Axes a GimbalUdpCommand carries (pan, tilt, then extra axes)
+#ifndef GIMBAL_UDP_MAX_AXES
+#define GIMBAL_UDP_MAX_AXES 4
+#endif
+
 // =============================================================================
 // SERVO-SPECIFIC CALIBRATION
 // =============================================================================
@@ -77,10 +189,12 @@
  * - SG90:  1000-2000 µs (standard)
  * - HS-422: 900-2100 µs (wider range)
  * - MG996R: 1000-2000 µs (standard)
+ * - DIGITAL: 1000-2000 µs, generic high-refresh digital servo (up to 333 Hz)
  */
 
-// Define GIMBAL_CALIBRATION_SERVO to select preset values
-// Available options: MG90S (default), SG90, HS422, MG996R
+// Define GIMBAL_CALIBRATION_SERVO to select preset values (ServoCalibration::fromConfig)
+// Available options: MG90S (default), SG90, HS422, MG996R, DIGITAL
+// Per-unit calibration files can be loaded at runtime with Gimbal::loadCalibration()
 #define GIMBAL_CALIBRATION_SERVO MG90S
 
 /**
@@ -100,11 +214,19 @@
 // =============================================================================
 
 /// Angle change threshold to consider as movement (degrees)
+/// Requests within this distance of the committed angle leave the axis where
+/// it is (hysteresis); adjustable at runtime with Gimbal::setDeadzone()
 #define GIMBAL_ANGLE_DEADZONE 0.5f
 
-/// Maximum angle change per command (degrees, 0 = unlimited)
+/// Maximum angular velocity of the motion profile (degrees/s, 0 = unlimited: step commands)
 #define GIMBAL_MAX_ANGLE_VELOCITY 0.0f
 
+/// Maximum angular acceleration of the motion profile (degrees/s², 0 = unlimited)
+#define GIMBAL_MAX_ANGLE_ACCELERATION 0.0f
+
+/// Maximum angular jerk of the motion profile (degrees/s³, 0 = trapezoidal profile)
+#define GIMBAL_MAX_ANGLE_JERK 0.0f
+
 /// Smoothing factor for angle interpolation (0.0 to 1.0, 0 = disabled)
 #define GIMBAL_SMOOTHING_FACTOR 0.0f
 
@@ -0,0 +1,218 @@
+#ifndef GIMBAL_CONTROLLER_H
+#define GIMBAL_CONTROLLER_H
+
+#include "CommandQueue.h"
+#include "Gimbal.h"
+#include "GimbalConfig.h"
+#include "MotionProfile.h"
+#include "Seqlock.h"
+#include "Stabilizer.h"
+#include "TargetPredictor.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @struct Setpoint
+ * @brief Target angles published to the control loop
+ */
+struct Setpoint {
+    float pan_angle;         ///< Pan angle in degrees
+    float tilt_angle;        ///< Tilt angle in degrees
+    uint64_t timestamp_ns;   ///< CLOCK_MONOTONIC time the setpoint was published
+};
+
+/// Latest-value mailbox between producers and the control loop
+using SetpointMailbox = Seqlock<Setpoint>;
+
+/**
+ * @struct GimbalTelemetry
+ * @brief Applied state published by the control loop once per frame
+ */
+struct GimbalTelemetry {
+    float pan_angle;                 ///< Last pan angle written to the servos
+    float tilt_angle;                ///< Last tilt angle written to the servos
+    uint64_t setpoint_timestamp_ns;  ///< Timestamp of the latest setpoint taken by the loop
+    uint64_t applied_ns;             ///< CLOCK_MONOTONIC time of the last successful write
+    uint64_t frame_ns;               ///< Deadline of the frame that published this (heartbeat)
+    uint64_t frames;                 ///< Ticks executed
+    uint64_t updates;                ///< Ticks that commanded the gimbal
+    uint64_t failures;               ///< Ticks where Gimbal::setTipAngle failed
+    uint32_t last_error;             ///< GimbalError of the latest failure (0 = none)
+    uint32_t reserved;
+};
+
+/// Latest-value mailbox from the control loop to observers
+using TelemetryMailbox = Seqlock<GimbalTelemetry>;
+
+/**
+ * @struct GimbalControllerConfig
+ * @brief Scheduling and motion options for GimbalController
+ *
+ * When the axis limits set a velocity, setpoints become targets of a
+ * jerk-limited MotionProfile that the loop samples every frame. Keep the
+ * Gimbal deadzone below the per-frame step of slow moves, or they will
+ * advance in deadzone-sized increments.
+ */
+struct GimbalControllerConfig {
+    uint32_t frequency_hz = 0;                      ///< Loop rate, 0 = the gimbal's frame rate (Gimbal::getFrameRate())
+    int realtime_priority = 0;                      ///< SCHED_FIFO priority 1-99, 0 = default policy
+    int cpu = -1;                                   ///< CPU to pin the loop to, -1 = any
+    uint64_t max_command_age_ns = 0;                ///< Drop submitted commands older than this, 0 = no limit
+    bool predict_targets = false;                   ///< Treat submit() commands as measurements and lead them
+    PredictorConfig predictor;                      ///< Filter and latency model used with predict_targets
+    SetpointMailbox* mailbox = nullptr;             ///< Read setpoints from this mailbox (e.g. in shared memory), nullptr = internal
+    TelemetryMailbox* telemetry = nullptr;          ///< Publish GimbalTelemetry here every frame, nullptr = off
+    Stabilizer* stabilizer = nullptr;               ///< Treat targets as world-frame angles on a moving mount, nullptr = off
+    AxisLimits pan_limits = {GIMBAL_MAX_ANGLE_VELOCITY, GIMBAL_MAX_ANGLE_ACCELERATION, GIMBAL_MAX_ANGLE_JERK};
+    AxisLimits tilt_limits = {GIMBAL_MAX_ANGLE_VELOCITY, GIMBAL_MAX_ANGLE_ACCELERATION, GIMBAL_MAX_ANGLE_JERK};
+};
+
+/**
+ * @struct GimbalControllerStats
+ * @brief Timing counters of the control loop
+ *
+ * Jitter is the delay between a frame's absolute deadline and the moment
+ * the loop actually woke up for it.
+ */
+struct GimbalControllerStats {
+    uint64_t frames;            ///< Ticks executed
+    uint64_t updates;           ///< Ticks that commanded the gimbal
+    uint64_t failures;          ///< Ticks where Gimbal::setTipAngle failed
+    uint64_t deadline_misses;   ///< Frames skipped because a tick overran
+    int64_t last_jitter_ns;     ///< Wake-up jitter of the latest tick
+    int64_t max_jitter_ns;      ///< Worst wake-up jitter observed
+    double mean_jitter_ns;      ///< Mean wake-up jitter
+    bool realtime;              ///< true if SCHED_FIFO was granted
+};
+
+/**
+ * @class GimbalController
+ * @brief Fixed-rate control loop driving a Gimbal from its own thread
+ *
+ * The loop wakes once per PWM frame on an absolute CLOCK_MONOTONIC deadline,
+ * reads the latest setpoint from a seqlock mailbox and, if it changed,
+ * commands the gimbal once. Producers call setTarget() from any thread
+ * without blocking; intermediate setpoints published within one frame are
+ * superseded, so each pin receives at most one write per frame. With
+ * axis limits configured, the loop instead follows a MotionProfile towards
+ * the latest setpoint, sampling it once per frame.
+ *
+ * submit() queues timestamped setpoints instead (e.g. one per camera frame)
+ * and exposes their enqueue-to-apply latency; each tick applies the queued
+ * command with the newest timestamp. When setTarget() and submit() both
+ * deliver within one frame, the newer timestamp wins.
+ *
+ * The setpoint mailbox and a telemetry mailbox may be supplied by the
+ * caller, e.g. placed in a shared-memory segment (see GimbalShm) so other
+ * processes command the loop and read back its state without syscalls.
+ * The loop never blocks on a mailbox: a setpoint caught mid-store is
+ * picked up on the next frame.
+ *
+ * With predict_targets, submitted commands are treated as timestamped
+ * measurements of a moving target: a TargetPredictor filters them and the
+ * loop commands the predicted position at each frame deadline plus the
+ * configured servo latency, instead of the stale measured one.
+ *
+ * With a Stabilizer, targets (after prediction and motion profiling) are
+ * world-frame angles: every frame the loop drains the IMU, fuses it and
+ * re-solves the servo angles for the current mount attitude, so the
+ * camera holds its pointing while the mount moves under it. The
+ * stabilizer is owned by the loop thread while it runs; keep the Gimbal
+ * deadzone below the corrections of interest.
+ *
+ * While the loop is running, the Gimbal must not be commanded directly.
+ */
+class GimbalController {
+public:
+    /**
+     * @brief Constructor
+     * @param gimbal Initialized gimbal driven by the loop (must outlive the controller)
+     * @param config Loop rate and scheduling options
+     */
+    explicit GimbalController(Gimbal& gimbal, const GimbalControllerConfig& config = GimbalControllerConfig());
+
+    /**
+     * @brief Destructor - stops the loop thread
+     */
+    ~GimbalController();
+
+    GimbalController(const GimbalController&) = delete;
+    GimbalController& operator=(const GimbalController&) = delete;
+
+    /**
+     * @brief Start the control loop thread
+     * @return true if the thread is running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the control loop thread and wait for it to exit
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the loop thread is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Publish new target angles (wait-free, callable from any thread)
+     * @param pan_angle Pan angle in degrees
+     * @param tilt_angle Tilt angle in degrees
+     */
+    void setTarget(float pan_angle, float tilt_angle);
+
+    /**
+     * @brief Queue timestamped target angles (lock-free, callable from any thread)
+     * @param pan_angle Pan angle in degrees
+     * @param tilt_angle Tilt angle in degrees
+     * @param timestamp_ns CLOCK_MONOTONIC time the setpoint refers to, 0 = now;
+     *                     commands older than the last applied one are dropped
+     */
+    void submit(float pan_angle, float tilt_angle, uint64_t timestamp_ns = 0);
+
+    /**
+     * @brief Snapshot of the loop timing counters
+     */
+    GimbalControllerStats getStats() const;
+
+    /**
+     * @brief Snapshot of the submit() queue counters and latencies
+     */
+    CommandQueueStats getCommandStats() const;
+
+    /**
+     * @brief Predicted time at which the gimbal reaches the latest applied target
+     * @return CLOCK_MONOTONIC time in nanoseconds (in the past when settled)
+     */
+    uint64_t getArrivalTime() const;
+
+private:
+    Gimbal& gimbal_;
+    GimbalControllerConfig config_;
+    uint32_t frequency_hz_;   // Loop rate resolved by start()
+    SetpointMailbox own_mailbox_;
+    SetpointMailbox* mailbox_;   // own_mailbox_ or config_.mailbox
+    CommandQueue commands_;
+    TargetPredictor predictor_;   // Owned by the loop thread
+    MotionProfile profile_;   // Owned by the loop thread
+    std::atomic<uint64_t> arrival_time_ns_;
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> updates_;
+    std::atomic<uint64_t> failures_;
+    std::atomic<uint64_t> deadline_misses_;
+    std::atomic<int64_t> last_jitter_ns_;
+    std::atomic<int64_t> max_jitter_ns_;
+    std::atomic<int64_t> total_jitter_ns_;
+    std::atomic<bool> realtime_;
+
+    void run();
+    void configureThread();
+};
+
+#endif // GIMBAL_CONTROLLER_H
@@ -0,0 +1,134 @@
+#ifndef GIMBAL_LOG_H
+#define GIMBAL_LOG_H
+
+#include "GimbalConfig.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file GimbalLog.h
+ * @brief Low-overhead logging for the gimbal library
+ *
+ * Messages are formatted into a fixed-size slot of a lock-free ring buffer
+ * and written out later by drain(), either from a background thread
+ * (startDrainThread) or from the application's idle loop on the Pico.
+ * Producers never allocate, block or flush.
+ *
+ * Levels above GIMBAL_LOG_LEVEL (see GimbalConfig.h) compile to nothing,
+ * so per-command trace messages cost nothing unless GIMBAL_DEBUG_LOGGING
+ * is defined.
+ */
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log message
+ */
+enum class LogLevel : uint8_t {
+    Error = 1,
+    Warning = 2,
+    Info = 3,
+    Debug = 4
+};
+
+/**
+ * @struct LogRecord
+ * @brief A single formatted log message as stored in the ring buffer
+ */
+struct LogRecord {
+    uint64_t timestamp_us;                    ///< Monotonic time of the call
+    LogLevel level;                           ///< Message severity
+    char message[GIMBAL_LOG_MESSAGE_SIZE];    ///< NUL-terminated text
+};
+
+/**
+ * @brief Sink receiving drained records
+ * @param record Record to output
+ * @param context User pointer passed to GimbalLog::setSink()
+ */
+using LogSink = void (*)(const LogRecord& record, void* context);
+
+/**
+ * @class GimbalLog
+ * @brief Process-wide log ring buffer and drain control
+ */
+class GimbalLog {
+public:
+    /**
+     * @brief Format a message into the ring buffer
+     *
+     * Never blocks: if the ring is full the message is dropped and counted.
+     * Safe to call from any thread.
+     * @param level Message severity
+     * @param format printf-style format string
+     */
+    static void write(LogLevel level, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    /**
+     * @brief Output all buffered records through the current sink
+     *
+     * Must only be called from one thread at a time.
+     * @return Number of records drained
+     */
+    static size_t drain();
+
+    /**
+     * @brief Replace the sink used by drain()
+     * @param sink Sink function (nullptr restores the default stdout/stderr sink)
+     * @param context User pointer forwarded to the sink
+     */
+    static void setSink(LogSink sink, void* context = nullptr);
+
+    /**
+     * @brief Number of messages lost because the ring was full
+     * @return Dropped message count since startup
+     */
+    static uint64_t droppedCount();
+
+#ifndef PICO_BUILD
+    /**
+     * @brief Start a background thread that drains the ring periodically
+     * @param interval_ms Drain interval in milliseconds
+     * @return true if the thread was started (or already running)
+     */
+    static bool startDrainThread(uint32_t interval_ms = 10);
+
+    /**
+     * @brief Stop the background drain thread and flush remaining records
+     */
+    static void stopDrainThread();
+#endif
+};
+
+// Disabled levels keep their arguments type-checked (and "used") but the
+// call sits behind a constant false branch and is never executed.
+#define GIMBAL_LOG_NOOP(...) do { if (false) { GimbalLog::write(LogLevel::Debug, __VA_ARGS__); } } while (0)
+
+#if GIMBAL_LOG_LEVEL >= 1
+#define GIMBAL_LOG_ERROR(...) GimbalLog::write(LogLevel::Error, __VA_ARGS__)
+#else
+#define GIMBAL_LOG_ERROR(...) GIMBAL_LOG_NOOP(__VA_ARGS__)
+#endif
+
+#if GIMBAL_LOG_LEVEL >= 2
+#define GIMBAL_LOG_WARNING(...) GimbalLog::write(LogLevel::Warning, __VA_ARGS__)
+#else
+#define GIMBAL_LOG_WARNING(...) GIMBAL_LOG_NOOP(__VA_ARGS__)
+#endif
+
+#if GIMBAL_LOG_LEVEL >= 3
+#define GIMBAL_LOG_INFO(...) GimbalLog::write(LogLevel::Info, __VA_ARGS__)
+#else
+#define GIMBAL_LOG_INFO(...) GIMBAL_LOG_NOOP(__VA_ARGS__)
+#endif
+
+#if GIMBAL_LOG_LEVEL >= 4
+#define GIMBAL_LOG_DEBUG(...) GimbalLog::write(LogLevel::Debug, __VA_ARGS__)
+#else
+#define GIMBAL_LOG_DEBUG(...) GIMBAL_LOG_NOOP(__VA_ARGS__)
+#endif
+
+#endif // GIMBAL_LOG_H
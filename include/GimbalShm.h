@@ -0,0 +1,112 @@
+#ifndef GIMBAL_SHM_H
+#define GIMBAL_SHM_H
+
+#include "GimbalController.h"
+#include "GimbalStatus.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// Default POSIX shared-memory name of the gimbal daemon
+#define GIMBAL_SHM_DEFAULT_NAME "/gimbal"
+
+/**
+ * @struct GimbalShmBlock
+ * @brief Layout of the shared-memory segment
+ *
+ * Clients write the setpoint block and the daemon writes the telemetry
+ * block; each sits on its own cache line so the two sides do not
+ * invalidate each other's line on every write. Both are seqlocks built
+ * from lock-free atomics, which work across processes.
+ */
+struct GimbalShmBlock {
+    static constexpr uint32_t MAGIC = 0x4D484347;  // "GCHM" little-endian
+    static constexpr uint16_t VERSION = 1;
+
+    std::atomic<uint32_t> magic;  ///< MAGIC once the daemon finished initializing the block
+    uint16_t version;             ///< Layout version
+    uint16_t reserved;
+    uint32_t size;                ///< sizeof(GimbalShmBlock) of the creator
+    uint32_t daemon_pid;          ///< Process that owns the PWM controller
+
+    alignas(64) SetpointMailbox setpoint;    ///< Written by clients, read by the daemon loop
+    alignas(64) TelemetryMailbox telemetry;  ///< Written by the daemon loop, read by clients
+};
+
+/**
+ * @class GimbalShm
+ * @brief POSIX shared-memory setpoint/telemetry interface to a gimbal daemon
+ *
+ * The daemon create()s the segment and runs a GimbalController on its
+ * mailboxes; clients open() it and call setTarget() / getTelemetry(),
+ * which are plain memory accesses (the timestamp comes from the vDSO
+ * clock). Several clients may write; their stores are serialized by the
+ * seqlock. A client killed in the middle of a store leaves the setpoint
+ * block locked: the daemon keeps running on the last setpoint, and
+ * restarting it recreates the segment.
+ *
+ * The C ABI in GimbalShmApi.h wraps the client side for other languages.
+ */
+class GimbalShm {
+public:
+    GimbalShm();
+    ~GimbalShm();
+
+    GimbalShm(const GimbalShm&) = delete;
+    GimbalShm& operator=(const GimbalShm&) = delete;
+
+    /**
+     * @brief Create (or recreate) the segment as its owner (daemon side)
+     * @param name POSIX shm name, e.g. "/gimbal"
+     * @return Success, or DeviceUnavailable with errno as detail
+     */
+    GimbalStatus create(const char* name);
+
+    /**
+     * @brief Map an existing segment (client side)
+     * @param name POSIX shm name used by the daemon
+     * @return Success, DeviceUnavailable (errno as detail) or
+     *         InvalidArgument if the segment is not a compatible block
+     */
+    GimbalStatus open(const char* name);
+
+    /**
+     * @brief Unmap the segment; the owner also unlinks it
+     */
+    void close();
+
+    bool isOpen() const { return block_ != nullptr; }
+
+    /**
+     * @brief Publish target angles (no syscall)
+     * @param pan_angle Pan angle in degrees
+     * @param tilt_angle Tilt angle in degrees
+     * @param timestamp_ns CLOCK_MONOTONIC time the target refers to, 0 = now
+     * @return false if the segment is not mapped
+     */
+    bool setTarget(float pan_angle, float tilt_angle, uint64_t timestamp_ns = 0);
+
+    /**
+     * @brief Read the state last published by the daemon (no syscall)
+     * @param telemetry Receives the snapshot
+     * @return false if not mapped or the daemon was caught mid-store
+     *         repeatedly (e.g. it died while publishing)
+     */
+    bool getTelemetry(GimbalTelemetry& telemetry) const;
+
+    /// Setpoint mailbox to hand to GimbalControllerConfig::mailbox
+    SetpointMailbox* setpoints() { return block_ ? &block_->setpoint : nullptr; }
+
+    /// Telemetry mailbox to hand to GimbalControllerConfig::telemetry
+    TelemetryMailbox* telemetry() { return block_ ? &block_->telemetry : nullptr; }
+
+    /// CLOCK_MONOTONIC in nanoseconds, the clock of all shm timestamps
+    static uint64_t now();
+
+private:
+    GimbalShmBlock* block_;
+    bool owner_;
+    char name_[64];
+};
+
+#endif // GIMBAL_SHM_H
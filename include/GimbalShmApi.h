@@ -0,0 +1,77 @@
+#ifndef GIMBAL_SHM_API_H
+#define GIMBAL_SHM_API_H
+
+/**
+ * @file GimbalShmApi.h
+ * @brief C ABI of the shared-memory gimbal client (libgimbal_shm.so)
+ *
+ * Lets processes in other languages command a running gimbal daemon, e.g.
+ * from Python through ctypes (see examples/gimbal_shm_client.py). All calls
+ * except open/close are plain memory accesses on the mapped segment.
+ */
+
+#include <stdint.h>
+
+/// Only the C entry points are exported from libgimbal_shm.so
+#ifdef GIMBAL_SHM_EXPORTS
+#define GIMBAL_SHM_API __attribute__((visibility("default")))
+#else
+#define GIMBAL_SHM_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Opaque handle to a mapped daemon segment
+typedef struct gimbal_shm gimbal_shm;
+
+/// Applied state published by the daemon (mirrors GimbalTelemetry)
+typedef struct gimbal_shm_telemetry {
+    float pan_angle;                 ///< Last pan angle written to the servos
+    float tilt_angle;                ///< Last tilt angle written to the servos
+    uint64_t setpoint_timestamp_ns;  ///< Timestamp of the latest setpoint taken by the daemon
+    uint64_t applied_ns;             ///< CLOCK_MONOTONIC time of the last successful write
+    uint64_t frame_ns;               ///< Time of the daemon's latest frame (heartbeat)
+    uint64_t frames;                 ///< Frames executed
+    uint64_t updates;                ///< Frames that commanded the gimbal
+    uint64_t failures;               ///< Frames where the write failed
+    uint32_t last_error;             ///< GimbalError of the latest failure (0 = none)
+    uint32_t reserved;
+} gimbal_shm_telemetry;
+
+/**
+ * @brief Map the segment of a running daemon
+ * @param name POSIX shm name, NULL for the default "/gimbal"
+ * @return Handle, or NULL if the daemon is not running or incompatible
+ */
+GIMBAL_SHM_API gimbal_shm* gimbal_shm_open(const char* name);
+
+/**
+ * @brief Unmap the segment and free the handle (NULL is ignored)
+ */
+GIMBAL_SHM_API void gimbal_shm_close(gimbal_shm* shm);
+
+/**
+ * @brief Publish target angles
+ * @param timestamp_ns CLOCK_MONOTONIC time the target refers to, 0 = now
+ * @return 0 on success, -1 on a NULL handle
+ */
+GIMBAL_SHM_API int gimbal_shm_set_target(gimbal_shm* shm, float pan_angle, float tilt_angle, uint64_t timestamp_ns);
+
+/**
+ * @brief Read the state last published by the daemon
+ * @return 0 on success, -1 on a NULL handle or if no consistent snapshot could be read
+ */
+GIMBAL_SHM_API int gimbal_shm_read_telemetry(const gimbal_shm* shm, gimbal_shm_telemetry* telemetry);
+
+/**
+ * @brief CLOCK_MONOTONIC in nanoseconds, the clock of all timestamps above
+ */
+GIMBAL_SHM_API uint64_t gimbal_shm_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GIMBAL_SHM_API_H
@@ -0,0 +1,131 @@
+#ifndef GIMBAL_STATUS_H
+#define GIMBAL_STATUS_H
+
+#include "Seqlock.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum GimbalError
+ * @brief Failure kinds reported by PWMController and Gimbal
+ */
+enum class GimbalError : uint8_t {
+    None = 0,            ///< Success
+    NotInitialized,      ///< Gimbal used before init() / after shutdown()
+    InvalidAngle,        ///< Angle outside the allowed range or NaN
+    InvalidArgument,     ///< Bad frequency, period or pulse width
+    PinNotInitialized,   ///< Write to a pin without a successful initPin()
+    PinUnavailable,      ///< Pin has no PWM channel or conflicts with another pin
+    DeviceUnavailable,   ///< Driver or device could not be opened or claimed
+    IoError,             ///< Driver rejected a write (detail holds the driver code / errno)
+    Count                ///< Number of kinds (not an error)
+};
+
+/**
+ * @brief Static name of an error kind (never allocates)
+ */
+const char* gimbalErrorName(GimbalError error);
+
+/**
+ * @class GimbalStatus
+ * @brief Result of a PWMController or Gimbal operation
+ *
+ * A small value type (8 bytes) returned instead of a bool: the kind of
+ * failure, the pin involved and a driver-specific detail code (an lgpio
+ * error or errno), so callers can react without parsing log text. Tests
+ * true on success, so `if (!gimbal.setTipAngle(...))` reads as before.
+ */
+class GimbalStatus {
+public:
+    /// Pin value when no specific pin is involved
+    static constexpr uint32_t NO_PIN = 0xFFFFFFFFu;
+
+    constexpr GimbalStatus() : pin_(NO_PIN), detail_(0), error_(GimbalError::None) {}
+
+    constexpr GimbalStatus(GimbalError error, uint32_t pin = NO_PIN, int32_t detail = 0)
+        : pin_(pin), detail_(detail), error_(error) {}
+
+    static constexpr GimbalStatus success() { return GimbalStatus(); }
+
+    constexpr bool ok() const { return error_ == GimbalError::None; }
+    constexpr explicit operator bool() const { return ok(); }
+
+    constexpr GimbalError error() const { return error_; }
+    constexpr uint32_t pin() const { return pin_; }
+    constexpr int32_t detail() const { return detail_; }
+
+private:
+    uint32_t pin_;
+    int32_t detail_;
+    GimbalError error_;
+};
+
+/**
+ * @struct GimbalErrorRecord
+ * @brief Context of the most recent failure
+ */
+struct GimbalErrorRecord {
+    GimbalError error;       ///< Failure kind
+    uint32_t pin;            ///< Pin involved (GimbalStatus::NO_PIN if none)
+    int32_t detail;          ///< Driver code / errno (0 if none)
+    float value;             ///< Offending value, e.g. the rejected angle (0 if none)
+    uint64_t timestamp_ns;   ///< Monotonic time of the failure
+    uint64_t sequence;       ///< Total failures recorded up to and including this one
+};
+
+/**
+ * @class GimbalErrorStats
+ * @brief Per-kind failure counters plus the context of the last failure
+ *
+ * Recording a failure is a relaxed atomic increment and a seqlock store of
+ * a fixed-size record: no allocation, no formatting and no I/O, so a fault
+ * storm costs the failing path almost nothing. Readers (e.g. a supervisor
+ * thread) may take snapshots concurrently.
+ */
+class GimbalErrorStats {
+public:
+    GimbalErrorStats();
+
+    GimbalErrorStats(const GimbalErrorStats&) = delete;
+    GimbalErrorStats& operator=(const GimbalErrorStats&) = delete;
+
+    /**
+     * @brief Count a failure and remember its context
+     * @param status Failed status (success is ignored)
+     * @param value Offending value, if any
+     * @return status, so failures can be recorded and returned in one step
+     */
+    GimbalStatus record(GimbalStatus status, float value = 0.0f);
+
+    /**
+     * @brief Failures recorded of one kind
+     */
+    uint64_t count(GimbalError error) const;
+
+    /**
+     * @brief Failures recorded of all kinds
+     */
+    uint64_t total() const;
+
+    /**
+     * @brief Context of the latest failure
+     * @param record Receives the record
+     * @return false if no failure has been recorded
+     */
+    bool getLastError(GimbalErrorRecord& record) const;
+
+    /**
+     * @brief Zero the counters and forget the last failure
+     */
+    void reset();
+
+private:
+    static constexpr size_t KINDS = static_cast<size_t>(GimbalError::Count);
+
+    std::atomic<uint64_t> counts_[KINDS];
+    std::atomic<uint64_t> total_;
+    Seqlock<GimbalErrorRecord> last_;
+};
+
+#endif // GIMBAL_STATUS_H
@@ -0,0 +1,335 @@
+#ifndef GIMBAL_UDP_H
+#define GIMBAL_UDP_H
+
+#include "GimbalConfig.h"
+#include "GimbalController.h"
+#include "GimbalStatus.h"
+#include "Seqlock.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+
+// The wire format is the in-memory layout of the packet structs
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "GimbalUdp packets are little-endian");
+
+/// Wire format version of both packets
+#define GIMBAL_UDP_VERSION 1
+
+/// Command flag: first datagram of a sender's session (its sequence restarted). The
+/// server only resynchronizes to it once GimbalUdpConfig::resync_ns passed without
+/// a newer datagram, so a late or foreign copy cannot rewind the sequence
+#define GIMBAL_UDP_FLAG_RESET 0x01
+/// Command flag: answer this datagram's batch with a GimbalUdpAck
+#define GIMBAL_UDP_FLAG_ACK 0x02
+
+/// Ack flag: telemetry fields are valid (a telemetry mailbox is attached)
+#define GIMBAL_UDP_ACK_TELEMETRY 0x01
+
+/**
+ * @struct GimbalUdpCommand
+ * @brief Setpoint datagram from a ground station (40 bytes, little-endian)
+ *
+ * angles[0] is pan and angles[1] tilt; further axes are carried for
+ * consumers of GimbalUdpServer::getLatest() (e.g. extra heads). Angles
+ * beyond axis_count are ignored.
+ */
+struct GimbalUdpCommand {
+    uint32_t magic;            ///< GimbalUdpCommand::MAGIC
+    uint8_t version;           ///< GIMBAL_UDP_VERSION
+    uint8_t flags;             ///< GIMBAL_UDP_FLAG_*
+    uint8_t axis_count;        ///< Valid entries in angles (1 to GIMBAL_UDP_MAX_AXES)
+    uint8_t reserved;          ///< Zero
+    uint32_t sequence;         ///< Incremented per datagram by the sender (wraps)
+    uint32_t reserved2;        ///< Zero
+    uint64_t timestamp_ns;     ///< Sender clock, echoed in acks (round-trip measurement)
+    float angles[GIMBAL_UDP_MAX_AXES];   ///< Target angles in degrees
+
+    static constexpr uint32_t MAGIC = 0x43445547;  // "GUDC" little-endian
+};
+
+/**
+ * @struct GimbalUdpAck
+ * @brief Acknowledgement and telemetry datagram to a ground station (56 bytes, little-endian)
+ *
+ * One ack answers every datagram a sender had in a received batch: it
+ * names the newest sequence accepted so far, not each datagram.
+ */
+struct GimbalUdpAck {
+    uint32_t magic;            ///< GimbalUdpAck::MAGIC
+    uint8_t version;           ///< GIMBAL_UDP_VERSION
+    uint8_t flags;             ///< GIMBAL_UDP_ACK_* state bits
+    uint16_t batch;            ///< Datagrams of this sender asking for an ack in the acknowledged batch
+    uint32_t sequence;         ///< Newest accepted sequence
+    uint32_t last_error;       ///< GimbalError of the control loop's latest failure (0 = none)
+    uint64_t echo_timestamp_ns;   ///< timestamp_ns of the newest accepted command
+    uint32_t received;         ///< Valid datagrams received (wraps)
+    uint32_t stale;            ///< Datagrams dropped as out of order or duplicate (wraps)
+    uint32_t invalid;          ///< Malformed datagrams (wraps)
+    uint32_t applied_age_us;   ///< Time since the loop last wrote the servos (saturates)
+    float pan_angle;           ///< Last pan angle written to the servos
+    float tilt_angle;          ///< Last tilt angle written to the servos
+    uint64_t frames;           ///< Control loop ticks executed
+
+    static constexpr uint32_t MAGIC = 0x41445547;  // "GUDA" little-endian
+};
+
+static_assert(sizeof(GimbalUdpCommand) == 24 + 4 * GIMBAL_UDP_MAX_AXES, "GimbalUdpCommand must match the wire layout");
+static_assert(sizeof(GimbalUdpAck) == 56, "GimbalUdpAck must match the wire layout");
+
+/**
+ * @struct GimbalUdpConfig
+ * @brief Socket options of a GimbalUdpServer
+ */
+struct GimbalUdpConfig {
+    uint16_t port = GIMBAL_UDP_PORT;          ///< UDP port, 0 = any free port (see getPort())
+    const char* bind_address = nullptr;       ///< IPv4 address to bind, nullptr = all interfaces
+    int receive_buffer_bytes = 0;             ///< SO_RCVBUF, 0 = system default
+    uint64_t resync_ns = 1000000000;          ///< After this long without a newer sequence, accept any (sender restarted)
+};
+
+/**
+ * @struct GimbalUdpStats
+ * @brief Counters of a GimbalUdpServer
+ */
+struct GimbalUdpStats {
+    uint64_t batches;       ///< recvmmsg() calls that returned datagrams
+    uint64_t received;      ///< Valid datagrams
+    uint64_t accepted;      ///< Datagrams newer than every earlier one
+    uint64_t superseded;    ///< Accepted datagrams overtaken within their batch (never published)
+    uint64_t stale;         ///< Datagrams dropped as out of order or duplicate
+    uint64_t invalid;       ///< Datagrams of the wrong size, magic, version or content
+    uint64_t published;     ///< Setpoints handed to the mailbox (one per batch at most)
+    uint64_t acks_sent;     ///< Ack datagrams sent
+    uint64_t ack_errors;    ///< Ack datagrams the socket refused
+    uint32_t last_sequence; ///< Newest accepted sequence
+};
+
+/**
+ * @class GimbalUdpServer
+ * @brief Network front end: fixed-size UDP setpoints in, batched acks out
+ *
+ * Each poll() drains the socket with recvmmsg(), up to GIMBAL_UDP_BATCH
+ * datagrams per system call, and keeps only what moves the target
+ * forward: a datagram is accepted if its sequence is newer (serial number
+ * arithmetic, so it wraps) than every one accepted before, and the newest
+ * accepted command of the batch is the only one stored into the setpoint
+ * mailbox. A burst of queued setpoints therefore costs one syscall and
+ * one mailbox store, and a reordered or duplicated datagram can never
+ * move the gimbal back. Senders that set GIMBAL_UDP_FLAG_ACK get one
+ * GimbalUdpAck per batch, all of them sent with a single sendmmsg().
+ *
+ * Give the same setpoint mailbox to GimbalControllerConfig::mailbox and
+ * the loop's telemetry mailbox to the constructor: the control loop then
+ * applies the newest setpoint at its next frame, and acks report what it
+ * applied. All buffers are members: nothing is allocated once the socket
+ * is open.
+ *
+ * poll() and start() are exclusive: drive the server either from a
+ * thread of your own or from its own thread.
+ */
+class GimbalUdpServer {
+public:
+    /// Datagrams per recvmmsg() / acks per sendmmsg()
+    static constexpr size_t BATCH = GIMBAL_UDP_BATCH;
+
+    /**
+     * @brief Constructor
+     * @param mailbox Mailbox receiving pan/tilt setpoints (must outlive the server)
+     * @param telemetry Mailbox whose state is reported in acks, nullptr = none
+     */
+    explicit GimbalUdpServer(SetpointMailbox& mailbox, const TelemetryMailbox* telemetry = nullptr);
+
+    /**
+     * @brief Destructor - stops the thread and closes the socket
+     */
+    ~GimbalUdpServer();
+
+    GimbalUdpServer(const GimbalUdpServer&) = delete;
+    GimbalUdpServer& operator=(const GimbalUdpServer&) = delete;
+
+    /**
+     * @brief Bind the UDP socket
+     * @return Success, InvalidArgument for a bad bind address, or
+     *         DeviceUnavailable with errno as detail
+     */
+    GimbalStatus open(const GimbalUdpConfig& config = GimbalUdpConfig());
+
+    /**
+     * @brief Stop the thread and close the socket
+     */
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /// Port the socket is bound to (useful with port 0)
+    uint16_t getPort() const { return port_; }
+
+    /**
+     * @brief Wait for datagrams and process everything queued
+     * @param timeout_ms Longest wait for the first datagram, 0 = none, -1 = forever
+     * @return Datagrams received, or -1 if the socket failed
+     */
+    int poll(int timeout_ms);
+
+    /**
+     * @brief Run poll() on a thread of the server's own
+     * @return true if the thread is running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the thread started by start() (returns within ~100 ms)
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    /**
+     * @brief Newest accepted command with all its axes
+     * @return false if none was accepted yet
+     */
+    bool getLatest(GimbalUdpCommand& command) const;
+
+    /**
+     * @brief Snapshot of the counters
+     */
+    GimbalUdpStats getStats() const;
+
+    /**
+     * @brief Validate a received datagram
+     * @return true if it is a well-formed GimbalUdpCommand with finite angles
+     */
+    static bool decode(const void* data, size_t size, GimbalUdpCommand& command);
+
+private:
+    /// One datagram slot, padded so an oversized datagram is detected by its length
+    struct Slot {
+        alignas(8) uint8_t data[sizeof(GimbalUdpCommand) + 8];
+    };
+
+    SetpointMailbox* mailbox_;
+    const TelemetryMailbox* telemetry_;
+    Seqlock<GimbalUdpCommand> latest_;
+    int fd_;
+    uint16_t port_;
+    uint64_t resync_ns_;
+
+    // Sequence filter state (owned by the polling thread)
+    bool synced_;
+    uint32_t last_sequence_;
+    uint64_t last_accept_ns_;
+    uint64_t echo_timestamp_ns_;
+
+    // recvmmsg()/sendmmsg() buffers, set up once by open()
+    mmsghdr messages_[BATCH];
+    iovec vectors_[BATCH];
+    sockaddr_in senders_[BATCH];
+    Slot slots_[BATCH];
+    mmsghdr ack_messages_[BATCH];
+    iovec ack_vectors_[BATCH];
+    sockaddr_in ack_peers_[BATCH];
+    GimbalUdpAck acks_[BATCH];
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    // Counters (single writer: the polling thread)
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> received_;
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> superseded_;
+    std::atomic<uint64_t> stale_;
+    std::atomic<uint64_t> invalid_;
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> acks_sent_;
+    std::atomic<uint64_t> ack_errors_;
+    std::atomic<uint32_t> stats_sequence_;   // Copy of last_sequence_ for getStats()
+
+    /**
+     * @brief Filter, publish and acknowledge one received batch
+     */
+    void processBatch(int count, uint64_t now_ns);
+
+    /**
+     * @brief Fill an ack with the current counters and telemetry
+     */
+    void fillAck(GimbalUdpAck& ack, uint16_t batch, uint64_t now_ns) const;
+
+    void run();
+};
+
+/**
+ * @class GimbalUdpClient
+ * @brief Ground-station side of the UDP protocol
+ *
+ * Numbers and timestamps the commands it sends (the first one carries
+ * GIMBAL_UDP_FLAG_RESET), and reads acks back. sendBatch() and
+ * receiveAcks() move up to GIMBAL_UDP_BATCH datagrams per system call.
+ */
+class GimbalUdpClient {
+public:
+    GimbalUdpClient();
+    ~GimbalUdpClient();
+
+    GimbalUdpClient(const GimbalUdpClient&) = delete;
+    GimbalUdpClient& operator=(const GimbalUdpClient&) = delete;
+
+    /**
+     * @brief Connect the socket to a server
+     * @param host IPv4 address of the server
+     * @param port UDP port of the server
+     * @return Success, InvalidArgument for a bad address, or
+     *         DeviceUnavailable with errno as detail
+     */
+    GimbalStatus open(const char* host, uint16_t port = GIMBAL_UDP_PORT);
+
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /**
+     * @brief Fill in the next command: sequence, timestamp, flags and angles
+     * @param command Receives the command
+     * @param angles Target angles in degrees (pan, tilt, ...)
+     * @param axis_count Entries in angles (1 to GIMBAL_UDP_MAX_AXES)
+     * @param flags GIMBAL_UDP_FLAG_* to set (RESET is added on the first command)
+     */
+    void prepare(GimbalUdpCommand& command, const float* angles, uint8_t axis_count, uint8_t flags = 0);
+
+    /**
+     * @brief Send pan/tilt target angles
+     * @return false if the datagram was not sent
+     */
+    bool setTarget(float pan_angle, float tilt_angle, uint8_t flags = 0);
+
+    /**
+     * @brief Send prepared commands with one sendmmsg() per GIMBAL_UDP_BATCH
+     * @return Datagrams sent, or -1 if the first could not be
+     */
+    int sendBatch(const GimbalUdpCommand* commands, size_t count);
+
+    /**
+     * @brief Read the acks that have arrived
+     * @param acks Receives valid acks
+     * @param max Capacity of acks
+     * @param timeout_ms Longest wait for the first ack, 0 = none
+     * @return Acks stored, or -1 if the socket failed
+     */
+    int receiveAcks(GimbalUdpAck* acks, size_t max, int timeout_ms);
+
+    /// Sequence the next prepared command will carry
+    uint32_t getNextSequence() const { return next_sequence_; }
+
+    /// Clock of the command timestamps (CLOCK_MONOTONIC, nanoseconds)
+    static uint64_t now();
+
+private:
+    int fd_;
+    uint32_t next_sequence_;
+    bool reset_sent_;
+};
+
+#endif // GIMBAL_UDP_H
@@ -0,0 +1,216 @@
+#ifndef IMU_SOURCE_H
+#define IMU_SOURCE_H
+
+#include "GimbalConfig.h"
+#include "InterCoreRing.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct ImuSample
+ * @brief One gyro + accelerometer reading (32 bytes, also the replay file record)
+ *
+ * Axes are those of the gimbal mount: x forward, y left, z up. A mount at
+ * rest reads about +9.81 m/s² on z (specific force, not gravity).
+ */
+struct ImuSample {
+    uint64_t timestamp_ns;   ///< Sample time on the monotonic clock (non-decreasing)
+    float gyro[3];           ///< Angular rate in rad/s
+    float accel[3];          ///< Specific force in m/s²
+};
+
+/**
+ * @struct ImuReplayHeader
+ * @brief 32-byte header of an IMU replay ("GIMU") file
+ */
+struct ImuReplayHeader {
+    char magic[4];          ///< "GIMU"
+    uint16_t version;       ///< ImuReplaySource::VERSION
+    uint16_t record_size;   ///< sizeof(ImuSample)
+    uint64_t count;         ///< Number of samples
+    uint64_t duration_ns;   ///< Last sample time minus first sample time
+    uint64_t reserved;      ///< Zero
+};
+
+static_assert(sizeof(ImuSample) == 32, "ImuSample must match the file layout");
+static_assert(sizeof(ImuReplayHeader) == 32, "ImuReplayHeader must match the file layout");
+
+/**
+ * @class ImuSource
+ * @brief Pluggable supplier of IMU samples
+ *
+ * Consumers (the Stabilizer) poll read() from the control loop and take
+ * everything that arrived since the previous call, so a source must never
+ * block: drivers sampling at 500-1000 Hz buffer between polls (see
+ * ImuBufferSource).
+ */
+class ImuSource {
+public:
+    virtual ~ImuSource() = default;
+
+    /**
+     * @brief Take the samples available now, oldest first
+     * @param samples Destination array
+     * @param max Capacity of the array
+     * @return Number of samples written (0 if none are pending)
+     */
+    virtual size_t read(ImuSample* samples, size_t max) = 0;
+
+    /**
+     * @brief Short name for logs
+     */
+    virtual const char* getName() const = 0;
+};
+
+/**
+ * @class ImuBufferSource
+ * @brief ImuSource fed by a driver thread or interrupt handler
+ *
+ * The driver calls push() for every sample; the control loop drains them
+ * with read(). The two sides share an InterCoreRing, so neither takes a
+ * lock and push() is safe from an interrupt on the other Pico core. When
+ * the ring is full the new sample is dropped and counted: the filter
+ * tolerates a gap better than a producer that stalls.
+ */
+class ImuBufferSource : public ImuSource {
+public:
+    /// Samples buffered between two polls
+    static constexpr size_t CAPACITY = GIMBAL_IMU_BUFFER_CAPACITY;
+
+    ImuBufferSource() : dropped_(0) {}
+
+    /**
+     * @brief Queue a sample (producer only, never blocks)
+     * @return false if the buffer is full (the sample is dropped)
+     */
+    bool push(const ImuSample& sample) {
+        if (!ring_.push(sample)) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    size_t read(ImuSample* samples, size_t max) override {
+        size_t count = 0;
+        while (count < max && ring_.pop(samples[count])) {
+            ++count;
+        }
+        return count;
+    }
+
+    const char* getName() const override { return "buffer"; }
+
+    /**
+     * @brief Samples rejected by push() because the buffer was full
+     */
+    uint32_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    InterCoreRing<ImuSample, CAPACITY> ring_;
+    std::atomic<uint32_t> dropped_;   // Written by the producer only
+};
+
+/**
+ * @class ImuReplaySource
+ * @brief Plays back a recorded IMU replay ("GIMU") file in real time
+ *
+ * The file is an ImuReplayHeader followed by count ImuSamples, mapped
+ * with mmap like a TrajectoryFile (or attached in place from flash on the
+ * Pico). After start(), read() releases each sample once the wall clock
+ * has advanced past its offset from the first sample, with the timestamp
+ * rebased onto the clock, so replaying a flight recording looks to the
+ * Stabilizer exactly like the live IMU did. readUntil() steps the replay
+ * on a caller-supplied clock instead, e.g. for offline analysis.
+ */
+class ImuReplaySource : public ImuSource {
+public:
+    /// Current format version
+    static constexpr uint16_t VERSION = 1;
+
+    ImuReplaySource();
+    ~ImuReplaySource() override;
+
+    ImuReplaySource(const ImuReplaySource&) = delete;
+    ImuReplaySource& operator=(const ImuReplaySource&) = delete;
+
+#ifndef PICO_BUILD
+    /**
+     * @brief Map a replay file
+     * @param path File to open
+     * @return false (source closed) if the file cannot be mapped or is malformed
+     */
+    bool open(const char* path);
+
+    /**
+     * @brief Write a replay file
+     * @param path File to create or replace
+     * @param samples Samples to store, with non-decreasing timestamps
+     * @param count Number of samples
+     * @return false on I/O errors or unordered timestamps
+     */
+    static bool write(const char* path, const ImuSample* samples, size_t count);
+#endif
+
+    /**
+     * @brief Use a replay image already in memory (e.g. in flash)
+     * @param data Start of the header (8-byte aligned, must outlive the source)
+     * @param size Size of the image in bytes
+     * @return false (source closed) if the image is malformed
+     */
+    bool attach(const void* data, size_t size);
+
+    /**
+     * @brief Release the mapping
+     */
+    void close();
+
+    /**
+     * @brief Rewind and anchor the first sample at a point in time
+     * @param now_ns Clock time at which the first sample is released
+     */
+    void start(uint64_t now_ns);
+
+    /**
+     * @brief Take the samples due by now() (start() must have been called)
+     */
+    size_t read(ImuSample* samples, size_t max) override;
+
+    /**
+     * @brief Take the samples due by a given time, rebased onto that clock
+     * @param samples Destination array
+     * @param max Capacity of the array
+     * @param now_ns Time on the clock passed to start()
+     * @return Number of samples written
+     */
+    size_t readUntil(ImuSample* samples, size_t max, uint64_t now_ns);
+
+    const char* getName() const override { return "replay"; }
+
+    bool isOpen() const { return samples_ != nullptr; }
+    bool isFinished() const { return cursor_ >= count_; }
+    size_t size() const { return count_; }
+    const ImuSample* samples() const { return samples_; }
+
+    /**
+     * @brief Time between the first and the last sample in nanoseconds
+     */
+    uint64_t getDuration() const { return duration_ns_; }
+
+    /**
+     * @brief Current monotonic time in nanoseconds (the clock read() uses)
+     */
+    static uint64_t now();
+
+private:
+    const ImuSample* samples_;
+    size_t count_;
+    uint64_t duration_ns_;
+    size_t cursor_;        // Next sample to release
+    uint64_t start_ns_;    // Clock time of the first sample
+    void* mapping_;
+    size_t mapping_size_;
+};
+
+#endif // IMU_SOURCE_H
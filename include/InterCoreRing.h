@@ -0,0 +1,86 @@
+#ifndef INTER_CORE_RING_H
+#define INTER_CORE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class InterCoreRing
+ * @brief Fixed-capacity single-producer / single-consumer FIFO between two cores
+ *
+ * One core pushes, the other pops. Each side owns one index and only reads
+ * the other's, so an operation is a copy of the element plus one acquire
+ * load and one release store of a 32-bit word: no read-modify-write, no
+ * lock and no interrupt masking. That matters on the RP2040, whose
+ * Cortex-M0+ cores have no exclusive-access instructions (compare-and-swap
+ * would fall back to a hardware spinlock) but do have single-copy atomic
+ * aligned word accesses and a DMB for the acquire/release ordering.
+ *
+ * The same code runs between two threads on the host, which is how the
+ * Pico runtime is exercised in simulation builds.
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam Capacity Number of slots, a power of two
+ */
+template <typename T, size_t Capacity>
+class InterCoreRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(Capacity <= (1u << 31), "indices are 32-bit");
+
+public:
+    InterCoreRing() : head_(0), tail_(0) {}
+
+    InterCoreRing(const InterCoreRing&) = delete;
+    InterCoreRing& operator=(const InterCoreRing&) = delete;
+
+    /**
+     * @brief Append a copy of a value (producer only)
+     * @return false if the ring is full
+     */
+    bool push(const T& value) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots_[head & MASK] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer only)
+     * @return false if the ring is empty
+     */
+    bool pop(T& value) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots_[tail & MASK];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Elements queued (exact only when called by the producer or consumer)
+     */
+    size_t size() const {
+        // Tail first: the head read after it can only be further ahead
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr uint32_t MASK = static_cast<uint32_t>(Capacity - 1);
+
+    // Written by the producer only
+    alignas(64) std::atomic<uint32_t> head_;
+    // Written by the consumer only
+    alignas(64) std::atomic<uint32_t> tail_;
+    T slots_[Capacity];
+};
+
+#endif // INTER_CORE_RING_H
@@ -0,0 +1,169 @@
+#ifndef LOOK_AT_H
+#define LOOK_AT_H
+
+#include "GimbalConfig.h"
+#include "ServoProfile.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct CameraIntrinsics
+ * @brief Pinhole model of the gimbal camera (no distortion)
+ *
+ * Pixel u grows to the right, v downwards; (cx, cy) is where the optical
+ * axis meets the image.
+ */
+struct CameraIntrinsics {
+    float fx = 1000.0f;   ///< Focal length in pixels, horizontal
+    float fy = 1000.0f;   ///< Focal length in pixels, vertical
+    float cx = 640.0f;    ///< Principal point (pixels)
+    float cy = 360.0f;
+
+    /**
+     * @brief Intrinsics of an image with square pixels, centered principal point
+     * @param horizontal_fov_deg Horizontal field of view in degrees
+     */
+    static CameraIntrinsics fromFieldOfView(uint32_t width, uint32_t height, float horizontal_fov_deg);
+};
+
+/**
+ * @struct GimbalKinematics
+ * @brief Where the gimbal sits and how its axes and camera are offset
+ *
+ * Frames follow the Stabilizer: x forward, y left, z up, lengths in any
+ * unit (the same as the points). The pan axis is the base's z axis; the
+ * tilt axis is parallel to y after panning. Zero offsets describe a camera
+ * whose optical centre lies on both axes.
+ */
+struct GimbalKinematics {
+    float mount_position[3] = {0.0f, 0.0f, 0.0f};   ///< Pan axis origin in the reference frame of the points
+    float mount_yaw = 0.0f;        ///< Base heading in the reference frame (degrees, positive left)
+    float mount_pitch = 0.0f;      ///< Base pitch (degrees, positive nose up)
+    float mount_roll = 0.0f;       ///< Base roll (degrees, positive lifts the left side)
+    float tilt_offset[3] = {0.0f, 0.0f, 0.0f};      ///< Tilt axis origin relative to the pan axis, panned frame
+    float camera_offset[3] = {0.0f, 0.0f, 0.0f};    ///< Optical centre relative to the tilt axis, tilted frame
+    float pan_trim = 0.0f;         ///< Servo pan angle at which the camera faces the base's x axis
+    float tilt_trim = 0.0f;        ///< Servo tilt angle at which the optical axis is level
+};
+
+/**
+ * @struct LookAtConfig
+ * @brief Geometry and slew rates of a LookAt
+ *
+ * The slew rates (degrees/s, 0 = free) default to the rated speed of the
+ * GIMBAL_CALIBRATION_SERVO model.
+ */
+struct LookAtConfig {
+    CameraIntrinsics camera;
+    GimbalKinematics kinematics;
+    float pan_speed_dps = getServoProfile(ServoModel::GIMBAL_CALIBRATION_SERVO).max_speed_dps;
+    float tilt_speed_dps = getServoProfile(ServoModel::GIMBAL_CALIBRATION_SERVO).max_speed_dps;
+};
+
+/**
+ * @class LookAt
+ * @brief Turns pixels and 3D points into the servo angles setTipAngle() wants
+ *
+ * The batch calls take structure-of-arrays input and run one branch-free
+ * loop per call with a polynomial atan2 (error within
+ * MAX_APPROX_ERROR_DEG of std::atan2), so the compiler vectorizes them
+ * (SSE on x86-64, NEON on the RPi5); the single-target calls use the
+ * exact functions. Batch results are not clamped: angles outside the
+ * servo range, or NaN for geometry without a solution, mark candidates
+ * the gimbal cannot reach, and selectTarget() skips them.
+ *
+ * All angles are servo angles in degrees, pan positive left, tilt
+ * positive up. Const methods are thread-safe; nothing allocates.
+ */
+class LookAt {
+public:
+    /// selectTarget() result when no candidate is reachable
+    static constexpr size_t NO_TARGET = static_cast<size_t>(-1);
+
+    /// Worst-case difference between a batch and a single-target result (degrees)
+    static constexpr float MAX_APPROX_ERROR_DEG = 0.001f;
+
+    explicit LookAt(const LookAtConfig& config = LookAtConfig());
+
+    /**
+     * @brief Replace the geometry and slew rates
+     */
+    void configure(const LookAtConfig& config);
+
+    const LookAtConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief Servo angles that center pixels of a frame
+     *
+     * Targets are taken to be far enough away that the camera offsets do
+     * not matter (parallax is ignored); the mount pose is not used.
+     * @param u Pixel columns
+     * @param v Pixel rows
+     * @param count Number of pixels
+     * @param pan_now Servo pan angle the frame was captured at
+     * @param tilt_now Servo tilt angle the frame was captured at
+     * @param pan Receives count pan angles
+     * @param tilt Receives count tilt angles
+     */
+    void pixelsToAngles(const float* u, const float* v, size_t count, float pan_now, float tilt_now, float* pan,
+                        float* tilt) const;
+
+    /**
+     * @brief Servo angles that put 3D points on the optical axis
+     *
+     * Solves the mount pose and the axis and camera offsets exactly. A
+     * point closer to an axis than the camera's offset from it has no
+     * solution (NaN).
+     * @param x Point x coordinates in the reference frame
+     * @param y Point y coordinates
+     * @param z Point z coordinates
+     * @param count Number of points
+     * @param pan Receives count pan angles
+     * @param tilt Receives count tilt angles
+     */
+    void pointsToAngles(const float* x, const float* y, const float* z, size_t count, float* pan, float* tilt) const;
+
+    /**
+     * @brief Single pixel with std::atan2
+     * @return false if the result was clamped to the servo range
+     */
+    bool pixelToAngles(float u, float v, float pan_now, float tilt_now, float& pan, float& tilt) const;
+
+    /**
+     * @brief Single point with std::atan2
+     * @return false if the point has no solution or the result was clamped to the servo range
+     */
+    bool pointToAngles(float x, float y, float z, float& pan, float& tilt) const;
+
+    /**
+     * @brief Time for both axes to slew from the current angles (seconds)
+     *
+     * The axes move together, so the slower one decides. Unreachable
+     * candidates cost infinity.
+     * @param seconds Receives count costs
+     */
+    void slewCosts(const float* pan, const float* tilt, size_t count, float pan_now, float tilt_now,
+                   float* seconds) const;
+
+    /**
+     * @brief Cheapest reachable candidate
+     * @param bias Seconds added to each candidate's slew time (e.g. negative for high
+     *        detection confidence), nullptr = none
+     * @param seconds Receives count costs including bias, nullptr = not needed
+     * @return Index of the candidate, or NO_TARGET
+     */
+    size_t selectTarget(const float* pan, const float* tilt, const float* bias, size_t count, float pan_now,
+                        float tilt_now, float* seconds = nullptr) const;
+
+private:
+    LookAtConfig config_;
+
+    float inv_fx_;
+    float inv_fy_;
+    float to_base_[9];   ///< Reference frame -> base frame rotation, row-major
+    float lateral_;      ///< Offset of the optical axis from the pan axis' plane (y, panned frame)
+    float inv_pan_speed_;
+    float inv_tilt_speed_;
+};
+
+#endif // LOOK_AT_H
@@ -0,0 +1,147 @@
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <cstdint>
+
+/**
+ * @struct AxisLimits
+ * @brief Kinematic limits of one gimbal axis
+ *
+ * A limit of 0 means unlimited. With all three set the profile is a
+ * jerk-limited S-curve; with max_jerk = 0 it is trapezoidal; with
+ * max_velocity = 0 the axis does not constrain the move.
+ */
+struct AxisLimits {
+    float max_velocity;       ///< Degrees per second
+    float max_acceleration;   ///< Degrees per second squared
+    float max_jerk;           ///< Degrees per second cubed
+};
+
+/**
+ * @class MotionProfile
+ * @brief Time-optimal, jerk-limited point-to-point trajectories for pan and tilt
+ *
+ * Each axis follows up to seven constant-jerk segments: change velocity to
+ * a cruise velocity, cruise, and decelerate to rest on the target. A move
+ * from rest runs along the straight line from the current setpoint to the
+ * target in (pan, tilt) space: the limits of each axis are scaled by its
+ * share of the move, so the most constrained axis sets the pace and both
+ * axes arrive at the same instant.
+ *
+ * A new target while moving replans each axis from its current position,
+ * velocity and acceleration, so setpoints streamed every frame are
+ * followed without dropping the velocity. The faster axis then cruises
+ * slower so both still arrive together, unless it cannot (e.g. it must
+ * first brake past the target).
+ *
+ * Planning happens in setTarget() (a bisection on the cruise velocity, a
+ * few microseconds); sample() evaluates a cubic on one of seven
+ * precomputed segments per axis, so each control tick is O(1) and never
+ * allocates.
+ *
+ * Times are absolute microseconds on the caller's monotonic clock.
+ */
+class MotionProfile {
+public:
+    MotionProfile();
+
+    /**
+     * @brief Set the kinematic limits (takes effect at the next setTarget)
+     * @param pan Pan axis limits
+     * @param tilt Tilt axis limits
+     */
+    void setLimits(const AxisLimits& pan, const AxisLimits& tilt);
+
+    /**
+     * @brief Check whether any limit is active
+     * @return false if both axes are unlimited (every move is a step)
+     */
+    bool isLimited() const;
+
+    /**
+     * @brief Hold at a position with no motion in progress
+     * @param pan_angle Pan angle in degrees
+     * @param tilt_angle Tilt angle in degrees
+     */
+    void reset(float pan_angle, float tilt_angle);
+
+    /**
+     * @brief Plan a move from the current setpoint, velocity and acceleration to a new target
+     * @param pan_angle Target pan angle in degrees
+     * @param tilt_angle Target tilt angle in degrees
+     * @param now_us Current time in microseconds
+     */
+    void setTarget(float pan_angle, float tilt_angle, uint64_t now_us);
+
+    /**
+     * @brief Evaluate the setpoint at a given time
+     * @param now_us Time in microseconds
+     * @param pan_angle Receives the pan setpoint in degrees
+     * @param tilt_angle Receives the tilt setpoint in degrees
+     */
+    void sample(uint64_t now_us, float& pan_angle, float& tilt_angle) const;
+
+    /**
+     * @brief Predicted time at which the current move reaches its target
+     * @return Arrival time in microseconds
+     */
+    uint64_t getArrivalTime() const;
+
+    /**
+     * @brief Duration of the current move
+     * @return Duration in seconds (0 for a step or when idle)
+     */
+    float getDuration() const;
+
+    /**
+     * @brief Check whether the move is complete at a given time
+     * @param now_us Time in microseconds
+     */
+    bool isSettled(uint64_t now_us) const;
+
+    float getTargetPan() const { return pan_.target; }
+    float getTargetTilt() const { return tilt_.target; }
+
+private:
+    static constexpr int SEGMENTS = 7;
+
+    /// One constant-jerk piece of an axis' trajectory
+    struct Segment {
+        float start;          ///< Start time relative to the move (s)
+        float position;       ///< Degrees at segment start
+        float velocity;       ///< Degrees/s at segment start
+        float acceleration;   ///< Degrees/s^2 at segment start
+        float jerk;           ///< Degrees/s^3 within the segment
+    };
+
+    /// Position, velocity and acceleration of one axis
+    struct AxisState {
+        float position;
+        float velocity;
+        float acceleration;
+    };
+
+    /// Planned move of one axis; a duration of 0 holds the target
+    struct AxisPlan {
+        float target;
+        float duration;
+        float cruise_velocity;
+        Segment segments[SEGMENTS];
+    };
+
+    AxisLimits pan_limits_;
+    AxisLimits tilt_limits_;
+
+    AxisPlan pan_;
+    AxisPlan tilt_;
+    uint64_t start_us_;
+
+    AxisState stateAt(const AxisPlan& plan, uint64_t now_us) const;
+    static AxisState evaluate(const AxisPlan& plan, float t);
+    static void plan(AxisPlan& plan, const AxisState& from, float target, const AxisLimits& limits);
+    static void stretch(AxisPlan& plan, const AxisState& from, const AxisLimits& limits, float duration);
+    static void build(AxisPlan& plan, const AxisState& from, const AxisLimits& limits, float cruise_velocity,
+                      float cruise_time);
+};
+
+#endif // MOTION_PROFILE_H
@@ -1,8 +1,21 @@
 #ifndef PWM_CONTROLLER_H
 #define PWM_CONTROLLER_H
 
+#include "GimbalConfig.h"
+#include "GimbalStatus.h"
+#include <cstddef>
 #include <cstdint>
 
+/**
+ * @struct PulseCommand
+ * @brief One pin update within a batched setPulseWidths() call
+ */
+struct PulseCommand {
+    uint32_t pin;              ///< GPIO pin number
+    uint32_t pulse_width_us;   ///< Pulse width in microseconds
+    uint32_t period_us;        ///< Period in microseconds (1000000 / frequency)
+};
+
 /**
  * @class PWMController
  * @brief Platform-agnostic PWM controller interface
@@ -10,6 +23,10 @@
  * Abstract interface for PWM control across different platforms:
  * - Raspberry Pi 5 (using pigpio)
  * - Raspberry Pi Pico (using pico-sdk)
+ *
+ * Operations return a GimbalStatus. Implementations record every failure
+ * they report in the controller's GimbalErrorStats (see fail()), so
+ * failures are counted without formatting a message on the failing path.
  */
 class PWMController {
 public:
@@ -19,31 +36,92 @@ public:
      * @brief Initialize PWM on a GPIO pin
      * @param pin GPIO pin number
      * @param frequency PWM frequency in Hz
-     * @return true if successful
+     * @return Success, or why the pin could not be set up
      */
-    virtual bool initPin(uint32_t pin, uint32_t frequency) = 0;
+    virtual GimbalStatus initPin(uint32_t pin, uint32_t frequency) = 0;
 
     /**
      * @brief Set PWM duty cycle via pulse width
      * @param pin GPIO pin number
      * @param pulse_width_us Pulse width in microseconds
      * @param period_us Period in microseconds (1000000 / frequency)
-     * @return true if successful
+     * @return Success, or why the write failed
+     */
+    virtual GimbalStatus setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) = 0;
+
+    /**
+     * @brief Set the pulse widths of several pins in one call
+     *
+     * Backends that can commit multiple channels together (so they change in
+     * the same PWM frame) override this; the default applies each command
+     * with setPulseWidth(). All commands are attempted even if one fails.
+     * @param commands Array of pin updates
+     * @param count Number of entries in commands
+     * @return Success, or the first failure in the batch
      */
-    virtual bool setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) = 0;
+    virtual GimbalStatus setPulseWidths(const PulseCommand* commands, size_t count) {
+        GimbalStatus result;
+        for (size_t i = 0; i < count; ++i) {
+            GimbalStatus status = setPulseWidth(commands[i].pin, commands[i].pulse_width_us, commands[i].period_us);
+            if (result && !status) {
+                result = status;
+            }
+        }
+        return result;
+    }
 
     /**
      * @brief Shutdown PWM on a pin
      * @param pin GPIO pin number
-     * @return true if successful
+     * @return Success, or why the pin could not be released
      */
-    virtual bool shutdownPin(uint32_t pin) = 0;
+    virtual GimbalStatus shutdownPin(uint32_t pin) = 0;
 
     /**
      * @brief Get platform name for logging
      * @return Platform identifier string
      */
     virtual const char* getPlatformName() const = 0;
+
+    /**
+     * @brief Failure counters and last failure of this controller
+     */
+    const GimbalErrorStats& getErrorStats() const { return errors_; }
+
+    /**
+     * @brief Reset the failure counters
+     */
+    void resetErrorStats() { errors_.reset(); }
+
+protected:
+    /**
+     * @brief Record a failure and return it
+     * @code
+     * return fail(GimbalError::IoError, pin, rc);
+     * @endcode
+     */
+    GimbalStatus fail(GimbalError error, uint32_t pin = GimbalStatus::NO_PIN, int32_t detail = 0) {
+        return errors_.record(GimbalStatus(error, pin, detail));
+    }
+
+    /**
+     * @brief Frame rate a backend accepts: GIMBAL_PWM_MIN_FREQUENCY to
+     *        GIMBAL_PWM_MAX_FREQUENCY Hz
+     */
+    static bool isValidFrequency(uint32_t frequency) {
+        return frequency >= GIMBAL_PWM_MIN_FREQUENCY && frequency <= GIMBAL_PWM_MAX_FREQUENCY;
+    }
+
+    /**
+     * @brief Write a backend accepts: a period no shorter than the fastest
+     *        frame rate allows, and a pulse that ends before the frame does
+     */
+    static bool isValidFrame(uint32_t pulse_width_us, uint32_t period_us) {
+        return period_us >= 1000000 / GIMBAL_PWM_MAX_FREQUENCY && pulse_width_us < period_us;
+    }
+
+private:
+    GimbalErrorStats errors_;
 };
 
 #endif // PWM_CONTROLLER_H
@@ -2,6 +2,7 @@
 #define PWM_CONTROLLER_PICO_H
 
 #include "PWMController.h"
+#include "PicoPWMConfig.h"
 #include <cstdint>
 
 /**
@@ -9,27 +10,72 @@
  * @brief PWM controller for Raspberry Pi Pico using pico-sdk
  * 
  * Implements PWM control via pico-sdk for RP2040 microcontroller.
+ *
+ * Each slice gets the divider/wrap chosen by solvePicoPWMConfig() for its
+ * frequency, and pulse widths are converted with the slice's real counter
+ * rate, so the pulse is exact even when the period is not. The two
+ * channels of a slice share one configuration; initializing them at
+ * different frequencies is rejected.
  */
 class PWMControllerPico : public PWMController {
 public:
     PWMControllerPico();
     ~PWMControllerPico() override;
 
-    bool initPin(uint32_t pin, uint32_t frequency) override;
-    bool setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
-    bool shutdownPin(uint32_t pin) override;
+    GimbalStatus initPin(uint32_t pin, uint32_t frequency) override;
+    GimbalStatus setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
+    GimbalStatus setPulseWidths(const PulseCommand* commands, size_t count) override;
+    GimbalStatus shutdownPin(uint32_t pin) override;
     const char* getPlatformName() const override { return "Raspberry Pi Pico (pico-sdk)"; }
 
+    /**
+     * @brief Configuration of the slice driving a pin
+     * @return Slice configuration, or nullptr if the pin is not initialized
+     */
+    const PicoPWMConfig* getSliceConfig(uint32_t pin) const;
+
+    /// Number of RP2040 bank 0 GPIOs
+    static constexpr uint32_t MAX_PINS = 30;
+
+    /// Number of RP2040 PWM slices
+    static constexpr uint32_t MAX_SLICES = 8;
+
+    /// System clock assumed by simulation builds
+    static constexpr uint32_t SIM_SYS_CLOCK_HZ = 125000000;
+
 private:
     bool initialized_;
-    
+
+    /// Last level written per pin (-1 = unknown); repeated levels are skipped
+    int32_t last_level_[MAX_PINS];
+
+    /// Pins currently initialized
+    bool pin_active_[MAX_PINS];
+
+    /// Cached configuration per slice (frequency 0 = unconfigured)
+    PicoPWMConfig slices_[MAX_SLICES];
+
+    static uint32_t sliceOf(uint32_t pin);
+
+    /**
+     * @brief Program a slice for a frequency (no-op if already configured for it)
+     * @param slice Slice number
+     * @param frequency PWM frequency in Hz
+     * @return true on success
+     */
+    bool configureSlice(uint32_t slice, uint32_t frequency);
+
     /**
-     * @brief Calculate PWM level from pulse width
+     * @brief Calculate PWM level from pulse width, reconfiguring the slice if the period changed
+     * @param pin GPIO pin (initialized)
      * @param pulse_width_us Pulse width in microseconds
      * @param period_us Period in microseconds
-     * @return PWM level (0-65535)
+     * @param level Receives the counter compare level
+     * @return false if the period cannot be produced, the pulse does not fit
+     *         in it, or it would change the rate under the slice's other
+     *         active channel
      */
-    uint16_t calculatePWMLevel(uint32_t pulse_width_us, uint32_t period_us) const;
+    bool calculatePWMLevel(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us, uint16_t& level);
 };
 
 #endif // PWM_CONTROLLER_PICO_H
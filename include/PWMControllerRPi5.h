@@ -3,38 +3,55 @@
 
 #include "PWMController.h"
 #include <cstdint>
-#include <set>
-#include <map>
 
 /**
  * @class PWMControllerRPi5
  * @brief PWM controller for Raspberry Pi 5 using lgpio userspace driver
  * 
- * Generates hardware PWM signals via lgpio's tx_pwm() at 50 Hz for servo control.
+ * Generates PWM signals via lgpio's tx_pwm() for servo control, at 50 Hz or,
+ * for digital servos, up to GIMBAL_PWM_MAX_FREQUENCY (333 Hz).
  * Requires: liblgpio-dev (install: sudo apt install -y liblgpio-dev)
  * GPIO Pins: GPIO 17 (pan), GPIO 27 (tilt)
  * 
  * Features:
  * - No daemon required (userspace control)
  * - Direct PWM with precise pulse widths (1000-2000 µs)
- * - Proper servo signal at 50 Hz
+ * - Frame rate per pin, following the period of each write
+ *
+ * Pin bookkeeping is a flat array indexed by GPIO number (the RP1 exposes
+ * GPIO 0-53), so validating a write is one bounds check and one load and
+ * claiming a pin never allocates.
  */
 class PWMControllerRPi5 : public PWMController {
 public:
     PWMControllerRPi5();
     ~PWMControllerRPi5() override;
 
-    bool initPin(uint32_t pin, uint32_t frequency) override;
-    bool setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
-    bool shutdownPin(uint32_t pin) override;
+    GimbalStatus initPin(uint32_t pin, uint32_t frequency) override;
+    GimbalStatus setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
+    GimbalStatus setPulseWidths(const PulseCommand* commands, size_t count) override;
+    GimbalStatus shutdownPin(uint32_t pin) override;
     const char* getPlatformName() const override { return "Raspberry Pi 5 (lgpio)"; }
 
+    /// Number of GPIO lines on gpiochip0 (RP1)
+    static constexpr uint32_t MAX_PINS = 54;
+
 private:
+    /// Per-pin output state; the last written pulse lets repeated writes be skipped
+    struct PinState {
+        float frequency;           ///< PWM frequency passed to lgTxPwm (1000000 / period_us)
+        float duty_per_us;         ///< 100 / period_us, recomputed only when the period changes
+        uint32_t pulse_width_us;   ///< Last pulse written (0 = none)
+        uint32_t period_us;        ///< Period of the last write (0 = none)
+        bool claimed;              ///< Pin claimed as an lgpio output
+    };
+
     int chip_;
-    std::set<uint32_t> claimed_pins_;
-    std::map<uint32_t, uint32_t> pin_frequency_;
+    PinState pins_[MAX_PINS];
 
-    bool initLgpio();
+    bool isClaimed(uint32_t pin) const { return pin < MAX_PINS && pins_[pin].claimed; }
+    GimbalStatus writePulse(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us);
+    GimbalStatus initLgpio();
     void shutdownLgpio();
 };
 
@@ -0,0 +1,122 @@
+#ifndef PWM_CONTROLLER_SERVO_SIM_H
+#define PWM_CONTROLLER_SERVO_SIM_H
+
+#include "PWMController.h"
+#include "ServoCalibration.h"
+#include "ServoProfile.h"
+#include <cstdint>
+
+/**
+ * @class PWMControllerServoSim
+ * @brief PWM controller that simulates the servos it drives
+ *
+ * Where PWMControllerSim records pulses, this backend answers what the
+ * horns do with them. Each pin carries a servo modelled on its
+ * ServoProfile:
+ *
+ * - the servo reads its input once per PWM frame, so a write takes effect
+ *   at the next frame boundary of that pin
+ * - pulse changes smaller than the dead band are ignored
+ * - the horn follows the latched pulse (mapped back to an angle with the
+ *   servo's calibration) as a second-order system whose speed is limited
+ *   to the rated slew rate, and stops at the calibrated end stops
+ *
+ * Time is simulated: nothing moves until advance() is called, so a
+ * scenario runs as fast as the host allows and repeats exactly.
+ */
+class PWMControllerServoSim : public PWMController {
+public:
+    /// Highest GPIO number accepted (exclusive)
+    static constexpr uint32_t MAX_PINS = 64;
+
+    /// Integration step of advance() in nanoseconds
+    static constexpr uint64_t STEP_NS = 100000;
+
+    PWMControllerServoSim();
+    ~PWMControllerServoSim() override = default;
+
+    GimbalStatus initPin(uint32_t pin, uint32_t frequency) override;
+    GimbalStatus setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
+    GimbalStatus shutdownPin(uint32_t pin) override;
+    const char* getPlatformName() const override { return "Servo Simulation"; }
+
+    /**
+     * @brief Put a servo on a pin
+     *
+     * Pins start with a GIMBAL_CALIBRATION_SERVO servo calibrated by
+     * ServoCalibration::fromConfig(). The horn is placed at 0 degrees, at rest.
+     * @param pin GPIO pin number
+     * @param model Servo model whose ServoProfile sets the dynamics
+     * @param calibration How the servo maps pulse widths to angles (the
+     *        preset of the model if omitted)
+     * @return false if the pin is out of range
+     */
+    bool attachServo(uint32_t pin, ServoModel model, const ServoCalibration& calibration);
+    bool attachServo(uint32_t pin, ServoModel model);
+
+    /**
+     * @brief Move a horn to an angle, at rest, and make it the servo's target
+     */
+    void setServoAngle(uint32_t pin, float angle);
+
+    /**
+     * @brief Run the simulation forward
+     * @param duration_ns Simulated time to advance in nanoseconds
+     */
+    void advance(uint64_t duration_ns);
+
+    /**
+     * @brief Simulated time since construction in nanoseconds
+     */
+    uint64_t now() const { return now_ns_; }
+
+    /**
+     * @brief Horn angle of a pin's servo in degrees
+     */
+    float getServoAngle(uint32_t pin) const;
+
+    /**
+     * @brief Horn speed of a pin's servo in degrees/s
+     */
+    float getServoVelocity(uint32_t pin) const;
+
+    /**
+     * @brief Angle the servo is steering to: the last pulse it latched
+     */
+    float getServoTarget(uint32_t pin) const;
+
+    /**
+     * @brief Last pulse width successfully written to a pin (0 if none)
+     */
+    uint32_t getPulseWidth(uint32_t pin) const;
+
+    /**
+     * @brief Frames in which a pin's servo latched a new pulse
+     */
+    uint64_t getLatchCount(uint32_t pin) const;
+
+private:
+    struct PinState {
+        bool initialized;
+        uint64_t period_ns;
+        uint64_t next_frame_ns;    ///< Next frame boundary (simulated time)
+        uint32_t pulse_width_us;   ///< Last pulse written
+        uint32_t latched_us;       ///< Pulse the servo is steering to (0 = none yet)
+        uint64_t latches;
+        ServoModel model;
+        ServoCalibration calibration;
+        float target;              ///< latched_us as an angle
+        float angle;
+        float velocity;
+    };
+
+    PinState pins_[MAX_PINS];
+    uint64_t now_ns_;
+
+    void advancePin(PinState& pin, uint64_t end_ns);
+    void latch(PinState& pin);
+    static void integrate(PinState& pin, float dt);
+    static float toAngle(const ServoCalibration& calibration, float pulse_width_us);
+};
+
+#endif // PWM_CONTROLLER_SERVO_SIM_H
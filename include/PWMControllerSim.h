@@ -0,0 +1,126 @@
+#ifndef PWM_CONTROLLER_SIM_H
+#define PWM_CONTROLLER_SIM_H
+
+#include "PWMController.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum SimCallType
+ * @brief PWMController entry point recorded by PWMControllerSim
+ */
+enum class SimCallType : uint8_t {
+    InitPin,
+    SetPulseWidth,
+    ShutdownPin
+};
+
+/**
+ * @struct SimCallRecord
+ * @brief One recorded PWMController call
+ */
+struct SimCallRecord {
+    uint64_t timestamp_ns;   ///< Monotonic time at which the call was made
+    SimCallType type;        ///< Which method was called
+    bool success;            ///< Value returned to the caller
+    uint32_t pin;            ///< GPIO pin argument
+    uint32_t value;          ///< Frequency (InitPin) or pulse width in µs (SetPulseWidth)
+    uint32_t period_us;      ///< Period argument (SetPulseWidth only)
+};
+
+/**
+ * @class PWMControllerSim
+ * @brief Recording PWM controller for host builds and benchmarks
+ *
+ * Runs on any machine without GPIO hardware. Every call is timestamped into
+ * a ring of records preallocated at construction, so recording never
+ * allocates. Write latency and write failures can be injected to model a
+ * slow or faulty driver.
+ */
+class PWMControllerSim : public PWMController {
+public:
+    /// Highest GPIO number accepted (exclusive)
+    static constexpr uint32_t MAX_PINS = 64;
+
+    /**
+     * @brief Constructor
+     * @param record_capacity Number of call records kept (oldest are overwritten)
+     */
+    explicit PWMControllerSim(size_t record_capacity = 4096);
+    ~PWMControllerSim() override = default;
+
+    GimbalStatus initPin(uint32_t pin, uint32_t frequency) override;
+    GimbalStatus setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
+    GimbalStatus setPulseWidths(const PulseCommand* commands, size_t count) override;
+    GimbalStatus shutdownPin(uint32_t pin) override;
+    const char* getPlatformName() const override { return "Simulation"; }
+
+    /**
+     * @brief Busy-wait this long inside every setPulseWidth / setPulseWidths call
+     * A batch is modelled as one driver transaction and pays the latency once.
+     * @param latency_ns Injected latency in nanoseconds (0 = none)
+     */
+    void setWriteLatency(uint32_t latency_ns);
+
+    /**
+     * @brief Make setPulseWidth fail (GimbalError::IoError) with the given probability
+     * @param probability Failure probability (0.0 to 1.0)
+     * @param seed Seed for the deterministic failure sequence
+     */
+    void setFailureRate(double probability, uint64_t seed = 1);
+
+    /**
+     * @brief Number of records currently held (at most the capacity)
+     */
+    size_t getRecordCount() const;
+
+    /**
+     * @brief Total number of calls made since construction or clearRecords()
+     */
+    uint64_t getTotalCalls() const { return total_calls_; }
+
+    /**
+     * @brief Access a held record
+     * @param index 0 is the oldest held record
+     */
+    const SimCallRecord& getRecord(size_t index) const;
+
+    /**
+     * @brief Discard all records and reset the call counter
+     */
+    void clearRecords();
+
+    /**
+     * @brief Last pulse width successfully written to a pin (0 if none)
+     */
+    uint32_t getPulseWidth(uint32_t pin) const;
+
+    /**
+     * @brief Check whether initPin() has been called for a pin
+     */
+    bool isPinInitialized(uint32_t pin) const;
+
+private:
+    struct PinState {
+        bool initialized;
+        uint32_t frequency;
+        uint32_t pulse_width_us;
+    };
+
+    std::vector<SimCallRecord> records_;
+    uint64_t total_calls_;
+    PinState pins_[MAX_PINS];
+
+    uint32_t write_latency_ns_;
+    uint64_t failure_threshold_;
+    uint64_t rng_state_;
+
+    void record(SimCallType type, bool success, uint32_t pin, uint32_t value,
+                uint32_t period_us, uint64_t timestamp_ns);
+    bool injectFailure();
+    GimbalStatus writePulse(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us);
+    void waitLatency(uint64_t start_ns) const;
+};
+
+#endif // PWM_CONTROLLER_SIM_H
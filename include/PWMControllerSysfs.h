@@ -0,0 +1,82 @@
+#ifndef PWM_CONTROLLER_SYSFS_H
+#define PWM_CONTROLLER_SYSFS_H
+
+#include "PWMController.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class PWMControllerSysfs
+ * @brief Hardware PWM controller using the Linux kernel pwm sysfs interface
+ *
+ * Drives the RP1 hardware PWM channels of the Raspberry Pi 5 through
+ * /sys/class/pwm/pwmchipN. Unlike lgpio's software-timed tx_pwm, the
+ * waveform is generated by the PWM peripheral and does not jitter when the
+ * CPUs are busy.
+ *
+ * The duty_cycle file of every channel is opened once in initPin() and kept
+ * open; each update is a single pwrite() of the new value, with no
+ * open/close per write.
+ *
+ * Requires a PWM overlay, e.g. in /boot/firmware/config.txt:
+ *   dtoverlay=pwm-2chan,pin=12,func=4,pin2=13,func2=4
+ * Default pin mapping (RP1 PWM0): GPIO 12 -> ch0, 13 -> ch1, 18 -> ch2, 19 -> ch3
+ */
+class PWMControllerSysfs : public PWMController {
+public:
+    /// Highest GPIO number accepted (exclusive)
+    static constexpr uint32_t MAX_PINS = 64;
+
+    /**
+     * @brief Constructor
+     * @param chip_path pwmchip directory (a fake tree may be used for testing)
+     */
+    explicit PWMControllerSysfs(const std::string& chip_path = "/sys/class/pwm/pwmchip0");
+    ~PWMControllerSysfs() override;
+
+    PWMControllerSysfs(const PWMControllerSysfs&) = delete;
+    PWMControllerSysfs& operator=(const PWMControllerSysfs&) = delete;
+
+    /**
+     * @brief Map a GPIO pin to a PWM channel of the chip
+     * Must be called before initPin() for pins outside the default mapping.
+     * A channel drives a single pin; unmapPin() frees a default mapping.
+     * @param pin GPIO pin number
+     * @param channel PWM channel index (pwmN)
+     * @return true if the mapping was stored, false if the pin is active or
+     *         the channel is mapped to another pin
+     */
+    bool mapPin(uint32_t pin, uint32_t channel);
+
+    /**
+     * @brief Remove the channel mapping of an inactive pin
+     * @return false if the pin is out of range or active
+     */
+    bool unmapPin(uint32_t pin);
+
+    GimbalStatus initPin(uint32_t pin, uint32_t frequency) override;
+    GimbalStatus setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) override;
+    GimbalStatus shutdownPin(uint32_t pin) override;
+    const char* getPlatformName() const override { return "Raspberry Pi 5 (sysfs hardware PWM)"; }
+
+private:
+    struct ChannelState {
+        bool mapped;
+        bool active;
+        uint32_t channel;
+        int duty_fd;          ///< Open duty_cycle file
+        int period_fd;        ///< Open period file
+        uint32_t period_ns;   ///< Last period written
+        uint32_t duty_ns;     ///< Last duty cycle written
+    };
+
+    std::string chip_path_;
+    ChannelState pins_[MAX_PINS];
+
+    std::string channelPath(uint32_t channel) const;
+    bool exportChannel(uint32_t channel);
+    bool writePeriod(ChannelState& state, uint32_t period_ns);
+    void closeChannel(ChannelState& state);
+};
+
+#endif // PWM_CONTROLLER_SYSFS_H
@@ -0,0 +1,43 @@
+#ifndef PICO_PWM_CONFIG_H
+#define PICO_PWM_CONFIG_H
+
+#include <cstdint>
+
+/**
+ * @struct PicoPWMConfig
+ * @brief Clock divider and wrap of one RP2040 PWM slice
+ *
+ * The slice counter runs at sys_clk / (div_int + div_frac / 16) and wraps
+ * after wrap + 1 counts, so the output frequency is
+ * sys_clk * 16 / (divider_16ths * (wrap + 1)).
+ */
+struct PicoPWMConfig {
+    uint32_t frequency;          ///< Requested frequency in Hz (0 = unconfigured)
+    uint8_t div_int;             ///< Integer part of the divider (1-255)
+    uint8_t div_frac;            ///< Fractional part of the divider in 1/16
+    uint16_t wrap;               ///< Counter TOP value
+    float actual_frequency;      ///< Frequency the slice really produces (Hz)
+    uint32_t counts_per_us_q12;  ///< Counter ticks per µs in Q20.12
+    float counts_per_us;         ///< Counter ticks per µs
+};
+
+/**
+ * @brief Choose the divider and wrap for a PWM frequency
+ *
+ * Prefers the smallest divider (most counter ticks per µs, i.e. the finest
+ * pulse resolution) whose period is within PICO_PWM_MAX_PERIOD_ERROR_PPM of
+ * the requested one; if no divider gets that close, the one with the least
+ * period error is used. Pure integer search over the 4080 legal dividers,
+ * host-compilable so it can be checked off target.
+ *
+ * @param sys_clk_hz System clock feeding the PWM block
+ * @param frequency PWM frequency in Hz
+ * @param config Receives the chosen configuration
+ * @return false if the frequency cannot be produced with a 16-bit counter
+ */
+bool solvePicoPWMConfig(uint32_t sys_clk_hz, uint32_t frequency, PicoPWMConfig& config);
+
+/// Period error accepted in exchange for a finer divider (parts per million)
+constexpr uint32_t PICO_PWM_MAX_PERIOD_ERROR_PPM = 100;
+
+#endif // PICO_PWM_CONFIG_H
@@ -0,0 +1,92 @@
+#ifndef PULSE_MAPPING_H
+#define PULSE_MAPPING_H
+
+#include <cstdint>
+
+/**
+ * @file PulseMapping.h
+ * @brief Angle -> pulse width conversions, in float and fixed point
+ *
+ * The RP2040 has no FPU, so every float operation on the command path is a
+ * soft-float library call. The fixed-point variants below replace the
+ * clamp/divide/multiply chain with integer arithmetic whose constants are
+ * folded at compile time; only the float-to-Q16.16 conversion of the input
+ * angle remains. All intermediates fit in 32 bits (no 64-bit multiply
+ * helpers on Cortex-M0+).
+ *
+ * Build with -DGIMBAL_FIXED_POINT=ON (default on PICO) to make Gimbal and
+ * PWMControllerPico use the fixed-point path.
+ */
+
+/**
+ * @class PulseMapping
+ * @brief Linear servo mapping from ±MaxAngleDeg to [MinPulseUs, MaxPulseUs]
+ * @tparam MinPulseUs Pulse width at -MaxAngleDeg (µs)
+ * @tparam MaxPulseUs Pulse width at +MaxAngleDeg (µs)
+ * @tparam MaxAngleDeg Mechanical half-range (degrees)
+ */
+template <uint32_t MinPulseUs, uint32_t MaxPulseUs, uint32_t MaxAngleDeg>
+class PulseMapping {
+    static_assert(MinPulseUs < MaxPulseUs, "pulse range must be increasing");
+    static_assert(MaxAngleDeg > 0 && MaxAngleDeg <= 180, "angle range out of bounds");
+
+public:
+    static constexpr uint32_t MID_PULSE_US = (MinPulseUs + MaxPulseUs) / 2;
+
+    /// Angle limit in Q16.16
+    static constexpr int32_t MAX_ANGLE_Q16 = static_cast<int32_t>(MaxAngleDeg) << 16;
+
+    /// µs per degree in Q8.8, rounded; applied to the angle in Q8.8 so the
+    /// product (at most 2^15 * 2^11) stays well inside 32 bits
+    static constexpr int32_t US_PER_DEGREE_Q8 = static_cast<int32_t>(
+        ((MaxPulseUs - MID_PULSE_US) * 256u + MaxAngleDeg / 2) / MaxAngleDeg);
+
+    /**
+     * @brief Float reference mapping (clamps, truncates toward zero offset)
+     */
+    static uint32_t toPulseFloat(float angle) {
+        const float max_angle = static_cast<float>(MaxAngleDeg);
+        if (angle < -max_angle) {
+            angle = -max_angle;
+        } else if (angle > max_angle) {
+            angle = max_angle;
+        }
+        return static_cast<uint32_t>(
+            MID_PULSE_US + (angle / max_angle) * static_cast<float>(MaxPulseUs - MID_PULSE_US));
+    }
+
+    /**
+     * @brief Fixed-point mapping of a Q16.16 angle (clamps, rounds to nearest µs)
+     */
+    static constexpr uint32_t toPulseQ16(int32_t angle_q16) {
+        if (angle_q16 < -MAX_ANGLE_Q16) {
+            angle_q16 = -MAX_ANGLE_Q16;
+        } else if (angle_q16 > MAX_ANGLE_Q16) {
+            angle_q16 = MAX_ANGLE_Q16;
+        }
+        // Q8.8 angle * Q8.8 scale = Q16.16 µs offset; shift with rounding
+        int32_t offset_q16 = (angle_q16 / 256) * US_PER_DEGREE_Q8;
+        int32_t offset = offset_q16 >= 0 ? (offset_q16 + 0x8000) >> 16 : -((-offset_q16 + 0x8000) >> 16);
+        return static_cast<uint32_t>(static_cast<int32_t>(MID_PULSE_US) + offset);
+    }
+
+    /**
+     * @brief Fixed-point mapping of a float angle (one float-to-int conversion)
+     */
+    static uint32_t toPulseFixed(float angle) {
+        return toPulseQ16(static_cast<int32_t>(angle * 65536.0f));
+    }
+
+    /**
+     * @brief Mapping selected by the GIMBAL_FIXED_POINT build option
+     */
+    static uint32_t toPulse(float angle) {
+#ifdef GIMBAL_FIXED_POINT
+        return toPulseFixed(angle);
+#else
+        return toPulseFloat(angle);
+#endif
+    }
+};
+
+#endif // PULSE_MAPPING_H
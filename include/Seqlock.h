@@ -0,0 +1,131 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @class Seqlock
+ * @brief Single-slot mailbox holding the latest value of a trivially copyable type
+ *
+ * Readers never block writers and never take a lock: they copy the value
+ * and retry if a write overlapped the copy. With a single writer, store()
+ * is wait-free; concurrent writers are serialized by a CAS on the sequence.
+ *
+ * The payload is kept in relaxed atomic words, so the object contains no
+ * pointers and may be placed in shared memory between processes.
+ */
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock payload must be trivially copyable");
+
+public:
+    Seqlock() : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    explicit Seqlock(const T& initial) : Seqlock() {
+        store(initial);
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    /**
+     * @brief Publish a new value
+     * @param value Value to store
+     */
+    void store(const T& value) {
+        uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((seq & 1u) == 0 &&
+                sequence_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+                break;
+            }
+            seq = sequence_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read a consistent copy of the latest value
+     * @param out Receives the value
+     * @return Version of the value read (even; increases with every store)
+     */
+    uint32_t load(T& out) const {
+        uint64_t buffer[WORDS];
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            while (before & 1u) {
+                before = sequence_.load(std::memory_order_acquire);
+            }
+            for (size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while (before != after);
+
+        std::memcpy(&out, buffer, sizeof(T));
+        return before;
+    }
+
+    /**
+     * @brief Single non-blocking attempt at load()
+     *
+     * For readers that must not wait on another process: a writer that dies
+     * mid-store leaves the sequence odd, and load() would spin forever.
+     *
+     * @param out Receives the value (only on success)
+     * @param version Receives the version read (only on success)
+     * @return false if a store was in progress or overlapped the copy
+     */
+    bool tryLoad(T& out, uint32_t& version) const {
+        uint32_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1u) {
+            return false;
+        }
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+        version = before;
+        return true;
+    }
+
+    /**
+     * @brief Current version without reading the payload
+     * @return Sequence number (odd while a store is in progress)
+     */
+    uint32_t version() const {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_;
+    std::atomic<uint64_t> words_[WORDS];
+};
+
+#endif // SEQLOCK_H
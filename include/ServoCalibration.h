@@ -0,0 +1,149 @@
+#ifndef SERVO_CALIBRATION_H
+#define SERVO_CALIBRATION_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum ServoModel
+ * @brief Servo presets selectable with GIMBAL_CALIBRATION_SERVO
+ */
+enum class ServoModel : uint8_t {
+    MG90S,    ///< 1000-2000 µs
+    SG90,     ///< 1000-2000 µs
+    HS422,    ///< 900-2100 µs (wider range)
+    MG996R,   ///< 1000-2000 µs
+    DIGITAL   ///< 1000-2000 µs, generic high-refresh digital servo
+};
+
+/**
+ * @struct CalibrationPoint
+ * @brief One measured angle -> pulse width pair
+ */
+struct CalibrationPoint {
+    float angle;      ///< Degrees
+    float pulse_us;   ///< Pulse width in microseconds
+};
+
+/**
+ * @class ServoCalibration
+ * @brief Piecewise-linear angle -> pulse width curve of one servo axis
+ *
+ * Up to MAX_POINTS measured points describe the curve (e.g. a slightly
+ * off-center servo, or one that is non-linear near its ends). setPoints()
+ * resamples the curve into a fixed table, so a conversion is one index
+ * computation and one interpolation regardless of the point count, in
+ * float or integer-only (Q16.16 input) arithmetic.
+ *
+ * Fixed size and trivially copyable: no allocation, and it can be
+ * published through a Seqlock.
+ */
+class ServoCalibration {
+public:
+    /// Maximum number of calibration points
+    static constexpr size_t MAX_POINTS = 16;
+
+    /// Lookup table entries (TABLE_SIZE - 1 cells across the angle range)
+    static constexpr size_t TABLE_SIZE = 257;
+
+    /**
+     * @brief Default calibration: MG90S, ±90° over 1000-2000 µs
+     */
+    ServoCalibration();
+
+    /**
+     * @brief Preset calibration for a servo model
+     */
+    static ServoCalibration forModel(ServoModel model);
+
+    /**
+     * @brief Calibration selected by GimbalConfig.h
+     * GIMBAL_CALIBRATION_SERVO picks the preset; the *_PULSE_WIDTH_CALIBRATED
+     * macros, when defined, override its -90/0/+90 points.
+     */
+    static ServoCalibration fromConfig();
+
+    /**
+     * @brief Replace the curve
+     * @param points Points with strictly increasing angles
+     * @param count Number of points (2 to MAX_POINTS)
+     * @return false (calibration unchanged) if the points are invalid
+     */
+    bool setPoints(const CalibrationPoint* points, size_t count);
+
+    /**
+     * @brief Exact curve value (binary search over the points)
+     * @param angle Angle in degrees (clamped to the calibrated range)
+     * @return Pulse width in microseconds
+     */
+    float evaluate(float angle) const;
+
+    /**
+     * @brief Table lookup in float arithmetic
+     * @param angle Angle in degrees (clamped to the calibrated range)
+     * @return Pulse width in microseconds, rounded
+     */
+    uint32_t toPulseWidth(float angle) const;
+
+    /**
+     * @brief Table lookup in integer arithmetic
+     * @param angle_q16 Angle in degrees, Q16.16 (clamped to the calibrated range)
+     * @return Pulse width in microseconds, rounded
+     */
+    uint32_t toPulseWidthQ16(int32_t angle_q16) const;
+
+    float getMinAngle() const { return points_[0].angle; }
+    float getMaxAngle() const { return points_[count_ - 1].angle; }
+    size_t getPointCount() const { return count_; }
+    const CalibrationPoint& getPoint(size_t index) const { return points_[index]; }
+
+private:
+    CalibrationPoint points_[MAX_POINTS];
+    uint32_t count_;
+
+    float cells_per_degree_;
+    int32_t min_angle_q16_;
+    int32_t span_q16_;
+    int32_t cells_per_degree_q14_;
+
+    /// Pulse width in 1/16 µs at min angle + i / cells_per_degree
+    uint16_t table_[TABLE_SIZE];
+
+    void buildTable();
+};
+
+/**
+ * @struct GimbalCalibration
+ * @brief Calibration of both gimbal axes
+ */
+struct GimbalCalibration {
+    ServoCalibration pan;
+    ServoCalibration tilt;
+};
+
+#ifndef PICO_BUILD
+/**
+ * @brief Load a calibration file
+ *
+ * INI format, one section per axis; a section may start from a preset and
+ * then list its points (angle in degrees, pulse in µs):
+ * @code
+ * [pan]
+ * model = MG90S
+ * point = -90 980
+ * point = 0 1510
+ * point = 90 2040
+ *
+ * [tilt]
+ * model = HS422
+ * @endcode
+ * Axes without a section keep the calibration from GimbalConfig.h.
+ *
+ * @param path File to read
+ * @param calibration Receives the calibration (unchanged on failure)
+ * @return false if the file cannot be read or is malformed
+ */
+bool loadCalibrationFile(const char* path, GimbalCalibration& calibration);
+#endif
+
+#endif // SERVO_CALIBRATION_H
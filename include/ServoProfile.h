@@ -0,0 +1,52 @@
+#ifndef SERVO_PROFILE_H
+#define SERVO_PROFILE_H
+
+#include "ServoCalibration.h"
+#include <cstdint>
+
+/**
+ * @enum ServoDrive
+ * @brief How a servo's electronics drive the motor
+ */
+enum class ServoDrive : uint8_t {
+    Analog,   ///< Motor pulsed once per input frame: faster frames overheat it
+    Digital   ///< Own motor loop; the frame rate only sets how fast commands arrive
+};
+
+/**
+ * @struct ServoProfile
+ * @brief Frame-rate capabilities and dynamics of a servo model
+ *
+ * Speed and dead band are the makers' figures at 4.8 V. The natural
+ * frequency and damping ratio describe the servo's position loop as a
+ * second-order system; they are rough fits for an unloaded horn, used by
+ * PWMControllerServoSim rather than by the drivers.
+ */
+struct ServoProfile {
+    ServoModel model;
+    const char* name;            ///< Name as used in calibration files
+    ServoDrive drive;
+    uint32_t max_frequency_hz;   ///< Highest frame rate the servo is rated for
+    float max_speed_dps;         ///< No-load slew rate (degrees/s)
+    uint32_t deadband_us;        ///< Pulse change the servo ignores (µs)
+    float natural_frequency_hz;  ///< Position loop natural frequency
+    float damping_ratio;         ///< Position loop damping (1 = critically damped)
+};
+
+/**
+ * @brief Compatibility entry of a servo model
+ *
+ * Analog servos energize the motor for every received pulse, so driving
+ * one faster than its rated 50 Hz overheats it and makes it buzz; digital
+ * servos run their own motor loop and accept frames down to a 3 ms period.
+ * Models whose maker does not rate them above 50 Hz are listed at 50 Hz.
+ */
+const ServoProfile& getServoProfile(ServoModel model);
+
+/**
+ * @brief Check a frame rate against a servo model's profile
+ * @return true if 0 < frequency_hz <= the model's max_frequency_hz
+ */
+bool isFrameRateSupported(ServoModel model, uint32_t frequency_hz);
+
+#endif // SERVO_PROFILE_H
@@ -0,0 +1,100 @@
+#ifndef STABILIZER_H
+#define STABILIZER_H
+
+#include "AttitudeFilter.h"
+#include "ImuSource.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct StabilizerConfig
+ * @brief Options of a Stabilizer
+ */
+struct StabilizerConfig {
+    AttitudeConfig attitude;    ///< Fusion gains
+    bool hold_heading = true;   ///< true: pan targets are world headings; false: pan follows the mount's heading
+    uint64_t lead_ns = 0;       ///< Predict the mount attitude this far past the command time (servo latency)
+};
+
+/**
+ * @struct StabilizerStats
+ * @brief Counters of a Stabilizer (read from the thread that updates it)
+ */
+struct StabilizerStats {
+    uint64_t samples;          ///< IMU samples fused
+    uint64_t rejected;         ///< Samples ignored (not finite or out of order)
+    uint64_t saturated;        ///< Conversions clamped to the servo range
+    uint64_t last_sample_ns;   ///< Timestamp of the newest fused sample
+};
+
+/**
+ * @class Stabilizer
+ * @brief Turns world-frame pan/tilt targets into servo angles on a moving mount
+ *
+ * The IMU sits on the gimbal base, aligned with it (x forward, y left,
+ * z up). update() drains an ImuSource into an AttitudeFilter; once per PWM
+ * frame toServoAngles() rotates the world-frame pointing direction into
+ * the mount frame with the latest (optionally extrapolated) attitude and
+ * solves the pan/tilt angles that realize it, cancelling the mount's roll,
+ * pitch and, with hold_heading, yaw.
+ *
+ * Angle conventions follow the gimbal: pan positive towards +y (left),
+ * tilt positive up, both in degrees. A pan-tilt gimbal cannot cancel
+ * rotation about the camera axis, so mount roll still rolls the image.
+ *
+ * GimbalController runs a Stabilizer in its loop when one is configured;
+ * it can also be driven directly. Not thread-safe and allocation-free.
+ */
+class Stabilizer {
+public:
+    /**
+     * @brief Constructor
+     * @param source IMU drained by update() (must outlive the stabilizer), nullptr = samples are fed explicitly
+     * @param config Fusion and geometry options
+     */
+    explicit Stabilizer(ImuSource* source = nullptr, const StabilizerConfig& config = StabilizerConfig());
+
+    /**
+     * @brief Replace the options and restart the attitude estimate
+     */
+    void configure(const StabilizerConfig& config);
+
+    /**
+     * @brief Restart the attitude estimate and the counters
+     */
+    void reset();
+
+    /**
+     * @brief Fuse every sample the source has pending
+     * @return Number of samples read
+     */
+    size_t update();
+
+    /**
+     * @brief Fuse samples supplied by the caller
+     */
+    void update(const ImuSample* samples, size_t count);
+
+    /**
+     * @brief Servo angles that point the camera at world-frame angles
+     * @param world_pan Pan target in degrees (heading with hold_heading, else relative to the mount's)
+     * @param world_tilt Tilt target in degrees above the horizon
+     * @param time_ns Time the command takes effect (lead_ns is added); clock of the IMU timestamps
+     * @param pan_angle Receives the servo pan angle, clamped to the gimbal range
+     * @param tilt_angle Receives the servo tilt angle, clamped to the gimbal range
+     * @return false if no attitude is known yet (the world angles are passed through)
+     */
+    bool toServoAngles(float world_pan, float world_tilt, uint64_t time_ns, float& pan_angle, float& tilt_angle);
+
+    bool isReady() const { return filter_.isInitialized(); }
+    const AttitudeFilter& getFilter() const { return filter_; }
+    StabilizerStats getStats() const { return stats_; }
+
+private:
+    ImuSource* source_;
+    StabilizerConfig config_;
+    AttitudeFilter filter_;
+    StabilizerStats stats_;
+};
+
+#endif // STABILIZER_H
@@ -0,0 +1,131 @@
+#ifndef TARGET_PREDICTOR_H
+#define TARGET_PREDICTOR_H
+
+#include <cstdint>
+
+/**
+ * @enum PredictorModel
+ * @brief Filter used by TargetPredictor
+ */
+enum class PredictorModel : uint8_t {
+    AlphaBeta,   ///< Fixed-gain alpha-beta tracker (cheapest, needs tuning per target)
+    Kalman       ///< Constant-velocity Kalman filter (adapts gains to the sample interval)
+};
+
+/**
+ * @struct PredictorConfig
+ * @brief Filter tuning and latency model of a TargetPredictor
+ *
+ * The latency model describes what happens after the commanded time:
+ * fixed_latency_ns covers delays not visible to the caller (e.g. the PWM
+ * output settling into the next frame), and a first-order servo with time
+ * constant servo_time_constant_s trails a moving target by velocity * tau,
+ * so the predictor leads by that much more.
+ */
+struct PredictorConfig {
+    PredictorModel model = PredictorModel::Kalman;
+
+    float alpha = 0.7f;                  ///< Alpha-beta position gain (0-1)
+    float beta = 0.38f;                  ///< Alpha-beta velocity gain (critically damped: alpha² / (2 - alpha))
+
+    float process_noise = 5000.0f;       ///< Kalman acceleration noise density, (deg/s²)²·s
+    float measurement_noise = 0.25f;     ///< Kalman measurement variance, deg²
+
+    uint64_t fixed_latency_ns = 0;       ///< Delay between commanding and the servo starting to move
+    float servo_time_constant_s = 0.0f;  ///< First-order servo lag (0 = servo follows instantly)
+
+    float max_velocity = 720.0f;             ///< Velocity estimate clamp, deg/s
+    float max_extrapolation_s = 0.25f;       ///< Prediction horizon limit beyond the last measurement
+    uint64_t reset_gap_ns = 500000000;       ///< Restart the track after a measurement gap this long
+};
+
+/**
+ * @class TargetPredictor
+ * @brief Extrapolates timestamped target angles to the time the servos get there
+ *
+ * A target measured at capture time t is acted on 60-100 ms later (vision,
+ * the wait for the next PWM frame, servo slew), so a tracker that commands
+ * the measured angle always lags a moving target. TargetPredictor filters
+ * the measurements with an independent constant-velocity model per axis
+ * and predicts where the target will be when the command takes effect.
+ *
+ * Fixed size, no allocation, a few dozen flops per call. Not thread-safe:
+ * use it from one thread (e.g. the control loop).
+ *
+ * Timestamps are nanoseconds on the caller's monotonic clock.
+ */
+class TargetPredictor {
+public:
+    explicit TargetPredictor(const PredictorConfig& config = PredictorConfig());
+
+    /**
+     * @brief Replace the configuration and restart the track
+     */
+    void configure(const PredictorConfig& config);
+
+    /**
+     * @brief Forget the track
+     */
+    void reset();
+
+    /**
+     * @brief Add a measurement
+     * @param pan_angle Measured pan angle in degrees
+     * @param tilt_angle Measured tilt angle in degrees
+     * @param timestamp_ns Capture time of the measurement
+     * @return false (ignored) if it is NaN or not newer than the previous one
+     */
+    bool update(float pan_angle, float tilt_angle, uint64_t timestamp_ns);
+
+    /**
+     * @brief Predict the angles to command at a given time
+     *
+     * Extrapolates to command_ns plus the latency model's lead time, at most
+     * max_extrapolation_s past the last measurement.
+     *
+     * @param command_ns Time the command will be written to the servos
+     * @param pan_angle Receives the pan angle in degrees
+     * @param tilt_angle Receives the tilt angle in degrees
+     * @return false (outputs unchanged) if no measurement has been added
+     */
+    bool predict(uint64_t command_ns, float& pan_angle, float& tilt_angle) const;
+
+    /**
+     * @brief Check whether predict(command_ns) is limited by max_extrapolation_s
+     * @return true once the track is too old to extrapolate further
+     */
+    bool isHorizonExceeded(uint64_t command_ns) const;
+
+    /**
+     * @brief Extra time the latency model adds to the command time
+     * @return Lead time in nanoseconds
+     */
+    uint64_t getLeadTime() const;
+
+    bool isTracking() const { return samples_ > 0; }
+    uint64_t getLastTimestamp() const { return last_ns_; }
+    float getPanVelocity() const { return pan_.velocity; }
+    float getTiltVelocity() const { return tilt_.velocity; }
+
+    const PredictorConfig& getConfig() const { return config_; }
+
+private:
+    /// Position, velocity and (Kalman) covariance of one axis
+    struct AxisState {
+        float position;
+        float velocity;
+        float p00, p01, p11;
+    };
+
+    PredictorConfig config_;
+    AxisState pan_;
+    AxisState tilt_;
+    uint64_t last_ns_;
+    uint32_t samples_;
+
+    void start(AxisState& axis, float angle) const;
+    void updateAxis(AxisState& axis, float angle, float dt) const;
+    float clampVelocity(float velocity) const;
+};
+
+#endif // TARGET_PREDICTOR_H
@@ -0,0 +1,170 @@
+#ifndef TELEMETRY_RING_H
+#define TELEMETRY_RING_H
+
+#include "GimbalConfig.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @struct TelemetryRecord
+ * @brief What one setTipAngle() call did (32 bytes, also the on-disk layout)
+ */
+struct TelemetryRecord {
+    uint64_t timestamp_ns;   ///< Monotonic time of the controller call (of the command if none)
+    float pan_angle;         ///< Requested pan angle in degrees
+    float tilt_angle;        ///< Requested tilt angle in degrees
+    uint32_t pan_pulse_us;   ///< Pan pulse committed after the command (0 = unknown)
+    uint32_t tilt_pulse_us;  ///< Tilt pulse committed after the command (0 = unknown)
+    uint32_t driver_ns;      ///< Duration of the controller call (0 = no write issued)
+    uint8_t error;           ///< GimbalError of the command (0 = success)
+    uint8_t writes;          ///< Axes written: WROTE_PAN | WROTE_TILT
+    uint16_t reserved;       ///< Zero
+};
+
+/**
+ * @struct TelemetryFileHeader
+ * @brief 32-byte header of a binary telemetry dump ("GTEL")
+ */
+struct TelemetryFileHeader {
+    char magic[4];          ///< "GTEL"
+    uint16_t version;       ///< TelemetryRing::VERSION
+    uint16_t record_size;   ///< sizeof(TelemetryRecord)
+    uint64_t count;         ///< Records that follow, oldest first
+    uint64_t overwritten;   ///< Records lost to wrap-around before the dump
+    uint64_t reserved;      ///< Zero
+};
+
+static_assert(sizeof(TelemetryRecord) == 32, "TelemetryRecord must match the file layout");
+static_assert(sizeof(TelemetryFileHeader) == 32, "TelemetryFileHeader must match the file layout");
+
+/**
+ * @class TelemetryRing
+ * @brief Fixed-size, always-on flight recorder of gimbal commands
+ *
+ * A single writer (the thread commanding the gimbal) appends records with
+ * four relaxed word stores and one release store of the head, so recording
+ * costs a few nanoseconds and never allocates, locks or blocks. The newest
+ * GIMBAL_TELEMETRY_RING_CAPACITY records are kept. Any thread may take a
+ * snapshot concurrently; records overwritten while being copied are
+ * discarded rather than returned torn.
+ *
+ * Times are taken with ticks(), the CPU's timestamp counter (TSC on x86,
+ * the generic timer on AArch64), because a clock_gettime() pair would cost
+ * more than the rest of a command. snapshot() converts them to monotonic
+ * nanoseconds; on x86 the TSC rate is estimated over the ring's lifetime.
+ *
+ * Snapshots can be written as Chrome trace / Perfetto JSON (counters for
+ * angles and pulses, a slice per controller call, instants for failures)
+ * or as a compact binary dump: a TelemetryFileHeader followed by the raw
+ * records.
+ */
+class TelemetryRing {
+public:
+    /// Current binary dump version
+    static constexpr uint16_t VERSION = 1;
+
+    /// Records kept
+    static constexpr size_t CAPACITY = GIMBAL_TELEMETRY_RING_CAPACITY;
+
+    /// TelemetryRecord::writes bits
+    static constexpr uint8_t WROTE_PAN = 1;
+    static constexpr uint8_t WROTE_TILT = 2;
+
+    TelemetryRing();
+
+    TelemetryRing(const TelemetryRing&) = delete;
+    TelemetryRing& operator=(const TelemetryRing&) = delete;
+
+    /**
+     * @brief Append a record, overwriting the oldest when full (single writer)
+     * @param record Record whose timestamp_ns and driver_ns hold ticks() values
+     */
+    void record(const TelemetryRecord& record) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t words[WORDS];
+        std::memcpy(words, &record, sizeof(record));
+        std::atomic<uint64_t>* slot = slots_[head & (CAPACITY - 1)].words;
+        for (size_t i = 0; i < WORDS; ++i) {
+            slot[i].store(words[i], std::memory_order_relaxed);
+        }
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy the newest records, oldest first, with times in nanoseconds
+     * @param out Destination
+     * @param max Capacity of out
+     * @return Records copied
+     */
+    size_t snapshot(TelemetryRecord* out, size_t max) const;
+
+    /**
+     * @brief Records appended since construction or clear()
+     */
+    uint64_t total() const { return head_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Forget all records (not concurrently with record())
+     */
+    void clear();
+
+#ifndef PICO_BUILD
+    /**
+     * @brief Write the current contents as Chrome trace / Perfetto JSON
+     * @param path Output file (open in chrome://tracing or ui.perfetto.dev)
+     * @param process_name Name shown for the track
+     * @return false if the file could not be written
+     */
+    bool writeChromeTrace(const char* path, const char* process_name = "gimbal") const;
+
+    /**
+     * @brief Write the current contents as a binary dump
+     * @param path Output file
+     * @return false if the file could not be written
+     */
+    bool writeBinary(const char* path) const;
+#endif
+
+    /// Raw timestamp counter passed to record()
+    static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return now();
+#endif
+    }
+
+    /// Monotonic nanoseconds, the clock of snapshot timestamps
+    static uint64_t now();
+
+private:
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "GIMBAL_TELEMETRY_RING_CAPACITY must be a power of two");
+
+    static constexpr size_t WORDS = sizeof(TelemetryRecord) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> words[WORDS];
+    };
+
+    std::atomic<uint64_t> head_;
+    Slot slots_[CAPACITY];
+
+    // Same instant on both clocks, anchoring the tick -> ns conversion
+    uint64_t anchor_ns_;
+    uint64_t anchor_ticks_;
+
+    double nanosPerTick() const;
+};
+
+#endif // TELEMETRY_RING_H
@@ -0,0 +1,106 @@
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct TrajectoryRecord
+ * @brief One trajectory point as stored on disk (16 bytes, little-endian)
+ */
+struct TrajectoryRecord {
+    uint64_t time_us;    ///< Point time in microseconds (non-decreasing)
+    float pan_angle;     ///< Pan angle in degrees
+    float tilt_angle;    ///< Tilt angle in degrees
+};
+
+/**
+ * @struct TrajectoryHeader
+ * @brief 32-byte header in front of the records
+ */
+struct TrajectoryHeader {
+    char magic[4];          ///< "GTRJ"
+    uint16_t version;       ///< TrajectoryFile::VERSION
+    uint16_t record_size;   ///< sizeof(TrajectoryRecord)
+    uint64_t count;         ///< Number of records
+    uint64_t duration_us;   ///< Last record time minus first record time
+    uint64_t reserved;      ///< Zero
+};
+
+static_assert(sizeof(TrajectoryRecord) == 16, "TrajectoryRecord must match the file layout");
+static_assert(sizeof(TrajectoryHeader) == 32, "TrajectoryHeader must match the file layout");
+
+/**
+ * @class TrajectoryFile
+ * @brief Read-only view of a binary trajectory ("GTRJ") file
+ *
+ * The file is a TrajectoryHeader followed by count TrajectoryRecords. On
+ * Linux open() maps it with mmap, so opening only validates the header and
+ * records are paged in as playback reaches them; a track with millions of
+ * points opens in constant time and is never copied. On the Pico the same
+ * image can be linked into flash and used in place with attach().
+ *
+ * Record times are expected to be non-decreasing; this is not checked when
+ * opening, since that would touch every page.
+ */
+class TrajectoryFile {
+public:
+    /// Current format version
+    static constexpr uint16_t VERSION = 1;
+
+    TrajectoryFile();
+    ~TrajectoryFile();
+
+    TrajectoryFile(const TrajectoryFile&) = delete;
+    TrajectoryFile& operator=(const TrajectoryFile&) = delete;
+
+#ifndef PICO_BUILD
+    /**
+     * @brief Map a trajectory file
+     * @param path File to open
+     * @return false (view closed) if the file cannot be mapped or is malformed
+     */
+    bool open(const char* path);
+
+    /**
+     * @brief Write a trajectory file
+     * @param path File to create or replace
+     * @param records Points to store, with non-decreasing times
+     * @param count Number of points
+     * @return false on I/O errors or unordered times
+     */
+    static bool write(const char* path, const TrajectoryRecord* records, size_t count);
+#endif
+
+    /**
+     * @brief Use a trajectory image already in memory (e.g. in flash)
+     * @param data Start of the header (8-byte aligned, must outlive the view)
+     * @param size Size of the image in bytes
+     * @return false (view closed) if the image is malformed
+     */
+    bool attach(const void* data, size_t size);
+
+    /**
+     * @brief Release the mapping
+     */
+    void close();
+
+    bool isOpen() const { return records_ != nullptr; }
+    size_t size() const { return count_; }
+    const TrajectoryRecord* records() const { return records_; }
+    const TrajectoryRecord& operator[](size_t index) const { return records_[index]; }
+
+    /**
+     * @brief Time between the first and the last record in microseconds
+     */
+    uint64_t getDuration() const { return duration_us_; }
+
+private:
+    const TrajectoryRecord* records_;
+    size_t count_;
+    uint64_t duration_us_;
+    void* mapping_;
+    size_t mapping_size_;
+};
+
+#endif // TRAJECTORY_FILE_H
@@ -0,0 +1,103 @@
+#ifndef TRAJECTORY_PLAYER_H
+#define TRAJECTORY_PLAYER_H
+
+#include "Gimbal.h"
+#include "TrajectoryFile.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TrajectoryPlayer
+ * @brief Streams a TrajectoryFile to a gimbal on absolute deadlines
+ *
+ * Playback position is a pure function of the clock: track time =
+ * anchor position + (now - anchor time) * scale. Commands are sampled at
+ * fixed frame deadlines, never from "previous deadline + work done", so
+ * per-command latency does not accumulate into drift the way delay-based
+ * loops do. Samples interpolate linearly between records; a cursor makes
+ * sequential access O(1) and seeks binary-search the mapped records.
+ *
+ * Times are nanoseconds on the monotonic clock returned by now().
+ */
+class TrajectoryPlayer {
+public:
+    /**
+     * @brief Constructor
+     * @param trajectory Open trajectory (must outlive the player)
+     */
+    explicit TrajectoryPlayer(const TrajectoryFile& trajectory);
+
+    /**
+     * @brief Wrap around at the end instead of stopping
+     */
+    void setLoop(bool loop) { loop_ = loop; }
+    bool getLoop() const { return loop_; }
+
+    /**
+     * @brief Change the playback speed without a jump in position
+     * @param scale Track seconds per wall-clock second (e.g. 0.5 = half speed, > 0)
+     * @param now_ns Current time
+     * @return false if the scale is invalid
+     */
+    bool setTimeScale(float scale, uint64_t now_ns);
+    float getTimeScale() const;
+
+    /**
+     * @brief Start (or restart) the clock at the current track position
+     * @param now_ns Time at which the current position is reached
+     */
+    void start(uint64_t now_ns);
+
+    /**
+     * @brief Jump to a track position
+     * @param position_us Offset from the first record in microseconds
+     * @param now_ns Time at which the position is reached
+     */
+    void seek(uint64_t position_us, uint64_t now_ns);
+
+    /**
+     * @brief Track position at a given time
+     * @return Offset from the first record in microseconds
+     */
+    uint64_t getPosition(uint64_t now_ns) const;
+
+    /**
+     * @brief Interpolated angles at a given time
+     * @param now_ns Time to sample
+     * @param pan_angle Receives the pan angle in degrees
+     * @param tilt_angle Receives the tilt angle in degrees
+     * @return false once a non-looping track has ended (outputs hold the last point),
+     *         or if no track is open (outputs unchanged)
+     */
+    bool sample(uint64_t now_ns, float& pan_angle, float& tilt_angle);
+
+    /**
+     * @brief Play the trajectory on a gimbal, blocking until it ends
+     *
+     * Starts at the current position now and commands the gimbal once per
+     * frame at rate_hz. Frames that are overrun are skipped, not bunched.
+     *
+     * @param gimbal Initialized gimbal
+     * @param rate_hz Command rate, 0 = the gimbal's frame rate (Gimbal::getFrameRate())
+     * @param stop Optional flag that ends playback when set
+     * @return false if the gimbal rejected a command
+     */
+    bool play(Gimbal& gimbal, uint32_t rate_hz = 0, const std::atomic<bool>* stop = nullptr);
+
+    /**
+     * @brief Current monotonic time in nanoseconds
+     */
+    static uint64_t now();
+
+private:
+    const TrajectoryFile& trajectory_;
+    bool loop_;
+    uint32_t scale_q16_;       // Track time per wall time, Q16.16
+    uint64_t anchor_ns_;       // Wall time of anchor_us_
+    uint64_t anchor_us_;       // Track position at anchor_ns_
+    size_t cursor_;            // Record at or before the last sampled position
+
+    size_t locate(uint64_t time_us);
+};
+
+#endif // TRAJECTORY_PLAYER_H
@@ -23,9 +23,9 @@ echo "Build directory: $BUILD_DIR"
 echo ""
 
 # Validate platform
-if [[ "$PLATFORM" != "RPi5" && "$PLATFORM" != "PICO" ]]; then
+if [[ "$PLATFORM" != "RPi5" && "$PLATFORM" != "PICO" && "$PLATFORM" != "SIM" ]]; then
     echo -e "${RED}Error: Invalid platform '$PLATFORM'${NC}"
-    echo "Usage: $0 [RPi5|PICO]"
+    echo "Usage: $0 [RPi5|PICO|SIM]"
     exit 1
 fi
 
@@ -52,6 +52,8 @@ cd "$BUILD_DIR"
 echo -e "${YELLOW}Configuring CMake for $PLATFORM...${NC}"
 if [[ "$PLATFORM" == "PICO" ]]; then
     cmake .. -DPLATFORM=PICO -DCMAKE_BUILD_TYPE=Release
+elif [[ "$PLATFORM" == "SIM" ]]; then
+    cmake .. -DPLATFORM=SIM -DCMAKE_BUILD_TYPE=Release
 else
     cmake .. -DPLATFORM=RPi5 -DCMAKE_BUILD_TYPE=Release
 fi
@@ -71,11 +73,17 @@ if [[ "$PLATFORM" == "PICO" ]]; then
     mkdir -p "$BUILD_DIR/bin"
     cp "$BUILD_DIR"/gimbal_example.uf2 "$BUILD_DIR/bin/" 2>/dev/null || true
     cp "$BUILD_DIR"/gimbal_example.bin "$BUILD_DIR/bin/" 2>/dev/null || true
-    echo "  Location: $BUILD_DIR/bin/gimbal_example.uf2"
+    cp "$BUILD_DIR"/gimbal_dual_core.uf2 "$BUILD_DIR/bin/" 2>/dev/null || true
+    cp "$BUILD_DIR"/gimbal_dual_core.bin "$BUILD_DIR/bin/" 2>/dev/null || true
+    echo "  Location: $BUILD_DIR/bin/gimbal_example.uf2 (dual-core runtime: gimbal_dual_core.uf2)"
     echo "  To flash:"
     echo "    1. Connect Pico to USB with BOOTSEL held"
     echo "    2. Run: cp $BUILD_DIR/bin/gimbal_example.uf2 /media/[username]/RPI-RP2/"
     echo "    Or use: bash $SCRIPT_DIR/flash.sh"
+elif [[ "$PLATFORM" == "SIM" ]]; then
+    echo "Simulation build:"
+    echo "  Example:   $BUILD_DIR/bin/gimbal_example"
+    echo "  Benchmark: $BUILD_DIR/bin/gimbal_bench --json bench.json"
 else
     echo "RPi5 executable:"
     echo "  Location: $BUILD_DIR/bin/gimbal_example"
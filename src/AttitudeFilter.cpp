@@ -0,0 +1,162 @@
+#include "AttitudeFilter.h"
+#include <cmath>
+
+namespace {
+
+constexpr float STANDARD_GRAVITY = 9.80665f;
+constexpr float RAD_TO_DEG = 57.29578f;
+constexpr float PI = 3.14159265f;
+
+bool isFinite(const ImuSample& sample) {
+    for (int i = 0; i < 3; ++i) {
+        if (!std::isfinite(sample.gyro[i]) || !std::isfinite(sample.accel[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// q += 0.5 * q ⊗ (0, rate) * dt, renormalized
+void integrate(Quaternion& q, const float rate[3], float dt) {
+    const float hx = 0.5f * rate[0] * dt;
+    const float hy = 0.5f * rate[1] * dt;
+    const float hz = 0.5f * rate[2] * dt;
+    const Quaternion p = q;
+    q.w = p.w - p.x * hx - p.y * hy - p.z * hz;
+    q.x = p.x + p.w * hx + p.y * hz - p.z * hy;
+    q.y = p.y + p.w * hy - p.x * hz + p.z * hx;
+    q.z = p.z + p.w * hz + p.x * hy - p.y * hx;
+    const float inv_norm = 1.0f / std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    q.w *= inv_norm;
+    q.x *= inv_norm;
+    q.y *= inv_norm;
+    q.z *= inv_norm;
+}
+
+} // namespace
+
+AttitudeFilter::AttitudeFilter(const AttitudeConfig& config)
+    : config_(config) {
+    reset();
+}
+
+void AttitudeFilter::configure(const AttitudeConfig& config) {
+    config_ = config;
+    reset();
+}
+
+void AttitudeFilter::reset() {
+    attitude_ = Quaternion();
+    for (int i = 0; i < 3; ++i) {
+        bias_[i] = 0.0f;
+        rate_[i] = 0.0f;
+    }
+    timestamp_ns_ = 0;
+    initialized_ = false;
+}
+
+void AttitudeFilter::level(const float accel[3]) {
+    // Roll and pitch from gravity, heading zero
+    const float roll = std::atan2(accel[1], accel[2]);
+    const float pitch = std::atan2(-accel[0], std::sqrt(accel[1] * accel[1] + accel[2] * accel[2]));
+    const float cr = std::cos(0.5f * roll);
+    const float sr = std::sin(0.5f * roll);
+    const float cp = std::cos(0.5f * pitch);
+    const float sp = std::sin(0.5f * pitch);
+    attitude_.w = cr * cp;
+    attitude_.x = sr * cp;
+    attitude_.y = cr * sp;
+    attitude_.z = -sr * sp;
+}
+
+bool AttitudeFilter::update(const ImuSample& sample) {
+    if (!isFinite(sample)) {
+        return false;
+    }
+    if (!initialized_) {
+        level(sample.accel);
+        timestamp_ns_ = sample.timestamp_ns;
+        initialized_ = true;
+        return true;
+    }
+    if (sample.timestamp_ns < timestamp_ns_) {
+        return false;
+    }
+
+    const uint64_t gap_ns = sample.timestamp_ns - timestamp_ns_;
+    timestamp_ns_ = sample.timestamp_ns;
+    if (gap_ns == 0 || gap_ns > config_.max_gap_ns) {
+        // Nothing to integrate, or a dropout: hold the attitude rather than
+        // integrating one rate over the whole gap
+        return true;
+    }
+    const float dt = static_cast<float>(gap_ns) * 1e-9f;
+
+    float rate[3] = {sample.gyro[0], sample.gyro[1], sample.gyro[2]};
+
+    const float ax = sample.accel[0];
+    const float ay = sample.accel[1];
+    const float az = sample.accel[2];
+    const float norm_sq = ax * ax + ay * ay + az * az;
+    const float g_sq = STANDARD_GRAVITY * STANDARD_GRAVITY;
+    const float low = (1.0f - config_.accel_rejection) * (1.0f - config_.accel_rejection) * g_sq;
+    const float high = (1.0f + config_.accel_rejection) * (1.0f + config_.accel_rejection) * g_sq;
+    if (norm_sq > low && norm_sq < high) {
+        const float inv_norm = 1.0f / std::sqrt(norm_sq);
+        const Quaternion& q = attitude_;
+        // Estimated "up" in the body frame: third row of R
+        const float vx = 2.0f * (q.x * q.z - q.w * q.y);
+        const float vy = 2.0f * (q.w * q.x + q.y * q.z);
+        const float vz = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+        // Error: measured x estimated
+        const float ex = (ay * vz - az * vy) * inv_norm;
+        const float ey = (az * vx - ax * vz) * inv_norm;
+        const float ez = (ax * vy - ay * vx) * inv_norm;
+        if (config_.ki > 0.0f) {
+            bias_[0] += config_.ki * ex * dt;
+            bias_[1] += config_.ki * ey * dt;
+            bias_[2] += config_.ki * ez * dt;
+        }
+        rate[0] += config_.kp * ex;
+        rate[1] += config_.kp * ey;
+        rate[2] += config_.kp * ez;
+    }
+    // First-order low-pass, alpha = dt / (tau + dt)
+    const float alpha = config_.prediction_cutoff_hz > 0.0f
+        ? dt / (1.0f / (2.0f * PI * config_.prediction_cutoff_hz) + dt)
+        : 1.0f;
+    for (int i = 0; i < 3; ++i) {
+        rate[i] += bias_[i];
+        rate_[i] += alpha * (sample.gyro[i] + bias_[i] - rate_[i]);
+    }
+
+    integrate(attitude_, rate, dt);
+    return true;
+}
+
+Quaternion AttitudeFilter::predict(uint64_t time_ns) const {
+    Quaternion q = attitude_;
+    if (!initialized_ || time_ns <= timestamp_ns_) {
+        return q;
+    }
+    float dt = static_cast<float>(time_ns - timestamp_ns_) * 1e-9f;
+    if (dt > config_.max_prediction_s) {
+        dt = config_.max_prediction_s;
+    }
+    integrate(q, rate_, dt);
+    return q;
+}
+
+void AttitudeFilter::getEuler(float& roll, float& pitch, float& yaw) const {
+    const Quaternion& q = attitude_;
+    roll = std::atan2(2.0f * (q.w * q.x + q.y * q.z), 1.0f - 2.0f * (q.x * q.x + q.y * q.y)) * RAD_TO_DEG;
+    float s = 2.0f * (q.w * q.y - q.z * q.x);
+    s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+    pitch = std::asin(s) * RAD_TO_DEG;
+    yaw = getYaw() * RAD_TO_DEG;
+}
+
+float AttitudeFilter::getYaw() const {
+    const Quaternion& q = attitude_;
+    return std::atan2(2.0f * (q.w * q.z + q.x * q.y), 1.0f - 2.0f * (q.y * q.y + q.z * q.z));
+}
@@ -0,0 +1,121 @@
+#include "CommandQueue.h"
+
+#ifdef PICO_BUILD
+#include "pico/time.h"
+#else
+#include <chrono>
+#endif
+
+CommandQueue::CommandQueue(uint64_t max_age_ns)
+    : max_age_ns_(max_age_ns),
+      newest_ns_(0),
+      submitted_(0),
+      applied_(0),
+      superseded_(0),
+      stale_(0),
+      last_latency_ns_(0),
+      max_latency_ns_(0),
+      total_latency_ns_(0),
+      last_age_ns_(0) {
+}
+
+uint64_t CommandQueue::now() {
+#ifdef PICO_BUILD
+    return time_us_64() * 1000;
+#else
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void CommandQueue::submit(float pan_angle, float tilt_angle, uint64_t timestamp_ns) {
+    GimbalCommand command;
+    command.pan_angle = pan_angle;
+    command.tilt_angle = tilt_angle;
+    command.enqueue_ns = now();
+    command.timestamp_ns = timestamp_ns != 0 ? timestamp_ns : command.enqueue_ns;
+
+    // Full: evict the oldest entry, which the consumer would discard anyway
+    while (!queue_.push(command)) {
+        if (queue_.consume([](const GimbalCommand&) {})) {
+            superseded_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool CommandQueue::takeLatest(uint64_t now_ns, GimbalCommand& command) {
+    bool found = false;
+    uint64_t superseded = 0;
+    uint64_t stale = 0;
+
+    GimbalCommand next;
+    while (queue_.pop(next)) {
+        bool too_old = max_age_ns_ != 0 && now_ns > next.timestamp_ns && now_ns - next.timestamp_ns > max_age_ns_;
+        if (too_old || next.timestamp_ns <= newest_ns_) {
+            ++stale;
+        } else if (found && next.timestamp_ns <= command.timestamp_ns) {
+            ++superseded;
+        } else {
+            superseded += found ? 1 : 0;
+            command = next;
+            found = true;
+        }
+    }
+
+    if (found) {
+        newest_ns_ = command.timestamp_ns;
+    }
+    if (superseded > 0) {
+        superseded_.fetch_add(superseded, std::memory_order_relaxed);
+    }
+    if (stale > 0) {
+        stale_.fetch_add(stale, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+void CommandQueue::advance(uint64_t timestamp_ns) {
+    if (timestamp_ns > newest_ns_) {
+        newest_ns_ = timestamp_ns;
+    }
+}
+
+void CommandQueue::recordApplied(const GimbalCommand& command, uint64_t applied_ns) {
+    uint64_t latency = applied_ns > command.enqueue_ns ? applied_ns - command.enqueue_ns : 0;
+    uint64_t age = applied_ns > command.timestamp_ns ? applied_ns - command.timestamp_ns : 0;
+
+    applied_.fetch_add(1, std::memory_order_relaxed);
+    last_latency_ns_.store(latency, std::memory_order_relaxed);
+    total_latency_ns_.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > max_latency_ns_.load(std::memory_order_relaxed)) {
+        max_latency_ns_.store(latency, std::memory_order_relaxed);
+    }
+    last_age_ns_.store(age, std::memory_order_relaxed);
+}
+
+CommandQueueStats CommandQueue::getStats() const {
+    CommandQueueStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.applied = applied_.load(std::memory_order_relaxed);
+    stats.superseded = superseded_.load(std::memory_order_relaxed);
+    stats.stale = stale_.load(std::memory_order_relaxed);
+    stats.last_latency_ns = last_latency_ns_.load(std::memory_order_relaxed);
+    stats.max_latency_ns = max_latency_ns_.load(std::memory_order_relaxed);
+    stats.mean_latency_ns = stats.applied > 0
+        ? static_cast<double>(total_latency_ns_.load(std::memory_order_relaxed)) / static_cast<double>(stats.applied)
+        : 0.0;
+    stats.last_age_ns = last_age_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CommandQueue::resetStats() {
+    submitted_.store(0, std::memory_order_relaxed);
+    applied_.store(0, std::memory_order_relaxed);
+    superseded_.store(0, std::memory_order_relaxed);
+    stale_.store(0, std::memory_order_relaxed);
+    last_latency_ns_.store(0, std::memory_order_relaxed);
+    max_latency_ns_.store(0, std::memory_order_relaxed);
+    total_latency_ns_.store(0, std::memory_order_relaxed);
+    last_age_ns_.store(0, std::memory_order_relaxed);
+}
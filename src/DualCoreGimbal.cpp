@@ -0,0 +1,231 @@
+#include "DualCoreGimbal.h"
+#include "GimbalLog.h"
+
+#ifdef PICO_BUILD
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/multicore.h"
+#include "pico/time.h"
+#else
+#include <chrono>
+#endif
+
+namespace {
+
+/// Single-writer counter update: a load and a store, no read-modify-write
+inline void bump(std::atomic<uint32_t>& counter, uint32_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline void raiseMax(std::atomic<uint32_t>& maximum, uint64_t value) {
+    uint32_t clamped = value < UINT32_MAX ? static_cast<uint32_t>(value) : UINT32_MAX;
+    if (clamped > maximum.load(std::memory_order_relaxed)) {
+        maximum.store(clamped, std::memory_order_relaxed);
+    }
+}
+
+#ifdef PICO_BUILD
+/// Word core1 pushes on the SIO FIFO once its loop has exited
+constexpr uint32_t CORE1_EXITED = 0x67696D62;   // "gimb"
+
+/// Set by the alarm interrupt (on core1), cleared by the loop before each wait
+volatile bool alarm_fired = false;
+
+void onAlarm(uint alarm_num) {
+    (void)alarm_num;
+    alarm_fired = true;
+}
+#endif
+
+} // namespace
+
+DualCoreGimbal::DualCoreGimbal(Gimbal& gimbal, uint32_t frequency_hz)
+    : gimbal_(gimbal),
+      period_us_(1000000 / (frequency_hz > 0 ? frequency_hz : gimbal.getFrameRate())),
+      next_sequence_(0),
+      running_(false),
+      stop_requested_(false),
+      frames_(0),
+      commands_(0),
+      superseded_(0),
+      updates_(0),
+      failures_(0),
+      ring_full_(0),
+      missed_frames_(0),
+      max_late_us_(0),
+      max_latency_us_(0),
+      last_sequence_(0),
+      last_error_(0) {
+}
+
+DualCoreGimbal::~DualCoreGimbal() {
+    stop();
+}
+
+bool DualCoreGimbal::start() {
+    if (running_.load()) {
+        return false;
+    }
+    if (!gimbal_.isInitialized()) {
+        GIMBAL_LOG_ERROR("DualCoreGimbal: gimbal not initialized");
+        return false;
+    }
+
+    stop_requested_.store(false);
+    running_.store(true);
+#ifdef PICO_BUILD
+    multicore_launch_core1(&DualCoreGimbal::core1Entry);
+    multicore_fifo_push_blocking(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this)));
+#else
+    thread_ = std::thread(&DualCoreGimbal::loop, this);
+#endif
+    GIMBAL_LOG_INFO("DualCoreGimbal: loop started at %u us per frame", static_cast<unsigned>(period_us_));
+    return true;
+}
+
+void DualCoreGimbal::stop() {
+    if (!running_.load()) {
+        return;
+    }
+    stop_requested_.store(true, std::memory_order_release);
+#ifdef PICO_BUILD
+    // The loop notices the flag at its next alarm
+    while (multicore_fifo_pop_blocking() != CORE1_EXITED) {
+    }
+    multicore_reset_core1();
+#else
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#endif
+    running_.store(false);
+}
+
+bool DualCoreGimbal::isRunning() const {
+    return running_.load();
+}
+
+bool DualCoreGimbal::setTarget(float pan_angle, float tilt_angle) {
+    CoreCommand command;
+    command.pan_angle = pan_angle;
+    command.tilt_angle = tilt_angle;
+    command.sequence = ++next_sequence_;
+    command.issued_us = static_cast<uint32_t>(nowMicros());
+    if (!ring_.push(command)) {
+        bump(ring_full_);
+        return false;
+    }
+    return true;
+}
+
+DualCoreStats DualCoreGimbal::getStats() const {
+    DualCoreStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.commands = commands_.load(std::memory_order_relaxed);
+    stats.superseded = superseded_.load(std::memory_order_relaxed);
+    stats.updates = updates_.load(std::memory_order_relaxed);
+    stats.failures = failures_.load(std::memory_order_relaxed);
+    stats.ring_full = ring_full_.load(std::memory_order_relaxed);
+    stats.missed_frames = missed_frames_.load(std::memory_order_relaxed);
+    stats.max_late_us = max_late_us_.load(std::memory_order_relaxed);
+    stats.max_latency_us = max_latency_us_.load(std::memory_order_relaxed);
+    stats.last_sequence = last_sequence_.load(std::memory_order_relaxed);
+    stats.last_error = last_error_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DualCoreGimbal::runFrame(uint64_t deadline_us, uint64_t now_us) {
+    bump(frames_);
+    raiseMax(max_late_us_, now_us > deadline_us ? now_us - deadline_us : 0);
+
+    // Latest command wins: each pin gets at most one write per frame
+    CoreCommand command;
+    CoreCommand target{};
+    uint32_t taken = 0;
+    while (ring_.pop(command)) {
+        target = command;
+        ++taken;
+    }
+    if (taken == 0) {
+        return;
+    }
+    bump(commands_, taken);
+    if (taken > 1) {
+        bump(superseded_, taken - 1);
+    }
+
+    GimbalStatus status = gimbal_.setTipAngle(target.pan_angle, target.tilt_angle);
+    if (!status) {
+        bump(failures_);
+        last_error_.store(static_cast<uint32_t>(status.error()), std::memory_order_relaxed);
+        return;
+    }
+    bump(updates_);
+    last_sequence_.store(target.sequence, std::memory_order_relaxed);
+    // 32-bit difference: correct across the wrap of issued_us
+    raiseMax(max_latency_us_, static_cast<uint32_t>(nowMicros()) - target.issued_us);
+}
+
+uint64_t DualCoreGimbal::nowMicros() {
+#ifdef PICO_BUILD
+    return time_us_64();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void DualCoreGimbal::loop() {
+#ifdef PICO_BUILD
+    // Claimed from core1, so the alarm interrupt is serviced on core1
+    int alarm = hardware_alarm_claim_unused(false);
+    if (alarm < 0) {
+        last_error_.store(static_cast<uint32_t>(GimbalError::DeviceUnavailable), std::memory_order_relaxed);
+        return;
+    }
+    hardware_alarm_set_callback(static_cast<uint>(alarm), onAlarm);
+#endif
+
+    uint64_t deadline = nowMicros() + period_us_;
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+#ifdef PICO_BUILD
+        alarm_fired = false;
+        // true: the deadline has already passed, run the frame now
+        if (!hardware_alarm_set_target(static_cast<uint>(alarm), from_us_since_boot(deadline))) {
+            while (!alarm_fired) {
+                __wfe();
+            }
+        }
+#else
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::microseconds(deadline)));
+#endif
+        runFrame(deadline, nowMicros());
+
+        // Absolute deadlines: skip the ones an overrun already passed
+        // instead of bunching frames
+        deadline += period_us_;
+        uint64_t now = nowMicros();
+        if (now >= deadline) {
+            uint64_t missed = (now - deadline) / period_us_ + 1;
+            bump(missed_frames_, static_cast<uint32_t>(missed));
+            deadline += missed * period_us_;
+        }
+    }
+
+#ifdef PICO_BUILD
+    hardware_alarm_set_callback(static_cast<uint>(alarm), nullptr);
+    hardware_alarm_unclaim(static_cast<uint>(alarm));
+#endif
+}
+
+#ifdef PICO_BUILD
+void DualCoreGimbal::core1Entry() {
+    DualCoreGimbal* self = reinterpret_cast<DualCoreGimbal*>(static_cast<uintptr_t>(multicore_fifo_pop_blocking()));
+    self->loop();
+    multicore_fifo_push_blocking(CORE1_EXITED);
+    // Parked until core0 resets this core
+    while (true) {
+        __wfe();
+    }
+}
+#endif
@@ -1,165 +1,282 @@
 #include "Gimbal.h"
-#include <algorithm>
-#include <cmath>
-#include <iostream>
+#include "GimbalConfig.h"
+#include "GimbalLog.h"
+
+// Core write masks are recorded as-is
+static_assert(GIMBAL_AXIS_PAN == TelemetryRing::WROTE_PAN && GIMBAL_AXIS_TILT == TelemetryRing::WROTE_TILT,
+              "axis bits must match the telemetry write bits");
 
 Gimbal::Gimbal(PWMController* pwm_controller, uint32_t pan_pin, uint32_t tilt_pin)
-    : pwm_controller_(pwm_controller),
-      pan_pin_(pan_pin),
-      tilt_pin_(tilt_pin),
-      current_pan_angle_(0.0f),
-      current_tilt_angle_(0.0f),
-      initialized_(false) {
+    : Gimbal(std::shared_ptr<PWMController>(pwm_controller), pan_pin, tilt_pin) {
 }
 
 Gimbal::Gimbal(std::shared_ptr<PWMController> pwm_controller, uint32_t pan_pin, uint32_t tilt_pin)
-    : pwm_controller_(pwm_controller),
-      pan_pin_(pan_pin),
-      tilt_pin_(tilt_pin),
-      current_pan_angle_(0.0f),
-      current_tilt_angle_(0.0f),
-      initialized_(false) {
+    : core_(DynamicBackend(std::move(pwm_controller), pan_pin, tilt_pin),
+            ServoCalibration::fromConfig(), ServoCalibration::fromConfig()),
+#ifndef PICO_BUILD
+      calibration_version_(0),
+#endif
+      writes_issued_(0),
+      writes_suppressed_(0) {
+#ifndef PICO_BUILD
+    // Seed the mailbox, so getCalibration() never has to read core_
+    calibration_mailbox_.store(GimbalCalibration{core_.getPanCalibration(), core_.getTiltCalibration()});
+    calibration_version_ = calibration_mailbox_.version();
+#endif
 }
 
 Gimbal::~Gimbal() {
-    if (initialized_) {
+    if (core_.isInitialized()) {
         shutdown();
     }
 }
 
-bool Gimbal::init() {
-    if (initialized_) {
-        std::cout << "Gimbal already initialized" << std::endl;
-        return true;
+GimbalStatus Gimbal::init() {
+    if (core_.isInitialized()) {
+        GIMBAL_LOG_INFO("Gimbal already initialized");
+        return GimbalStatus::success();
     }
 
-    if (!pwm_controller_) {
-        std::cerr << "PWM controller not set" << std::endl;
-        return false;
+    const DynamicBackend& backend = core_.backend();
+    if (!backend.controller()) {
+        GIMBAL_LOG_ERROR("PWM controller not set");
+        return errors_.record(GimbalStatus(GimbalError::DeviceUnavailable));
     }
 
-    std::cout << "Initializing gimbal on pins: pan=" << pan_pin_ 
-              << ", tilt=" << tilt_pin_ 
-              << " (Platform: " << pwm_controller_->getPlatformName() << ")" << std::endl;
-
-    // Initialize PWM on both pins
-    if (!pwm_controller_->initPin(pan_pin_, PWM_FREQUENCY)) {
-        std::cerr << "Failed to initialize pan servo PWM" << std::endl;
-        return false;
+    GIMBAL_LOG_INFO("Initializing gimbal on pins: pan=%u, tilt=%u (Platform: %s)",
+                    static_cast<unsigned>(backend.panPin()), static_cast<unsigned>(backend.tiltPin()),
+                    backend.controller()->getPlatformName());
+
+    // Initialize PWM on both pins and center the gimbal
+    refreshCalibration();
+    GimbalStatus status = core_.init();
+    bool centered = core_.getLastWrites() != 0;
+    if (centered) {
+        TelemetryRecord record{};
+        recordCommand(record, status, true);
     }
-
-    if (!pwm_controller_->initPin(tilt_pin_, PWM_FREQUENCY)) {
-        std::cerr << "Failed to initialize tilt servo PWM" << std::endl;
-        return false;
+    if (!status) {
+        if (centered) {
+            GIMBAL_LOG_ERROR("Failed to center servos (%s)", gimbalErrorName(status.error()));
+        } else {
+            GIMBAL_LOG_ERROR("Failed to initialize %s servo PWM (%s)",
+                             status.pin() == backend.tiltPin() ? "tilt" : "pan", gimbalErrorName(status.error()));
+        }
+        return errors_.record(status);
     }
 
-    // Center gimbal
-    if (!setPWM(pan_pin_, MID_PULSE_WIDTH)) {
-        std::cerr << "Failed to initialize pan servo" << std::endl;
-        return false;
+    GIMBAL_LOG_INFO("Gimbal initialized successfully");
+    return GimbalStatus::success();
+}
+
+GimbalStatus Gimbal::setFrameRate(uint32_t pan_hz, uint32_t tilt_hz, ServoModel pan_model, ServoModel tilt_model) {
+    const DynamicBackend& backend = core_.backend();
+    if (core_.isInitialized()) {
+        GIMBAL_LOG_ERROR("Frame rate must be set before init()");
+        return errors_.record(GimbalStatus(GimbalError::InvalidArgument));
+    }
+    if (!isFrameRateSupported(pan_model, pan_hz)) {
+        GIMBAL_LOG_ERROR("%s pan servo is not rated for %u Hz", getServoProfile(pan_model).name,
+                         static_cast<unsigned>(pan_hz));
+        return errors_.record(GimbalStatus(GimbalError::InvalidArgument, backend.panPin()),
+                              static_cast<float>(pan_hz));
+    }
+    if (!isFrameRateSupported(tilt_model, tilt_hz)) {
+        GIMBAL_LOG_ERROR("%s tilt servo is not rated for %u Hz", getServoProfile(tilt_model).name,
+                         static_cast<unsigned>(tilt_hz));
+        return errors_.record(GimbalStatus(GimbalError::InvalidArgument, backend.tiltPin()),
+                              static_cast<float>(tilt_hz));
     }
 
-    if (!setPWM(tilt_pin_, MID_PULSE_WIDTH)) {
-        std::cerr << "Failed to initialize tilt servo" << std::endl;
-        return false;
+    // The calibration checked against the period is the one init() will use
+    refreshCalibration();
+    GimbalStatus status = core_.setFrameRate(pan_hz, tilt_hz);
+    if (!status) {
+        bool tilt = status.pin() == backend.tiltPin();
+        GIMBAL_LOG_ERROR("%s frame rate %u Hz is out of range or shorter than its pulses", tilt ? "Tilt" : "Pan",
+                         static_cast<unsigned>(tilt ? tilt_hz : pan_hz));
+        return errors_.record(status, static_cast<float>(tilt ? tilt_hz : pan_hz));
     }
 
-    current_pan_angle_ = 0.0f;
-    current_tilt_angle_ = 0.0f;
-    initialized_ = true;
+    GIMBAL_LOG_INFO("Frame rate set - Pan: %u Hz, Tilt: %u Hz", static_cast<unsigned>(pan_hz),
+                    static_cast<unsigned>(tilt_hz));
+    return GimbalStatus::success();
+}
+
+GimbalStatus Gimbal::setFrameRate(uint32_t pan_hz, uint32_t tilt_hz) {
+    return setFrameRate(pan_hz, tilt_hz, ServoModel::GIMBAL_CALIBRATION_SERVO, ServoModel::GIMBAL_CALIBRATION_SERVO);
+}
+
+uint32_t Gimbal::getPanFrameRate() const {
+    return core_.getPanFrameRate();
+}
+
+uint32_t Gimbal::getTiltFrameRate() const {
+    return core_.getTiltFrameRate();
+}
 
-    std::cout << "Gimbal initialized successfully" << std::endl;
-    return true;
+uint32_t Gimbal::getFrameRate() const {
+    uint32_t pan = core_.getPanFrameRate();
+    uint32_t tilt = core_.getTiltFrameRate();
+    return pan > tilt ? pan : tilt;
 }
 
 void Gimbal::shutdown() {
-    if (!initialized_) {
+    if (!core_.isInitialized()) {
         return;
     }
 
-    if (pwm_controller_) {
-        pwm_controller_->shutdownPin(pan_pin_);
-        pwm_controller_->shutdownPin(tilt_pin_);
-    }
-
-    std::cout << "Shutting down gimbal" << std::endl;
-    initialized_ = false;
+    core_.shutdown();
+    GIMBAL_LOG_INFO("Shutting down gimbal");
 }
 
-bool Gimbal::setTipAngle(float pan_angle, float tilt_angle) {
-    if (!initialized_) {
-        std::cerr << "Gimbal not initialized" << std::endl;
-        return false;
+GimbalStatus Gimbal::setTipAngle(float pan_angle, float tilt_angle) {
+    TelemetryRecord record{};
+    record.pan_angle = pan_angle;
+    record.tilt_angle = tilt_angle;
+
+    // Failures are counted, not logged: this path must stay cheap even
+    // when every command fails
+    refreshCalibration();
+    GimbalStatus status = core_.setTipAngle(pan_angle, tilt_angle);
+    bool filtered = status || (status.error() != GimbalError::NotInitialized &&
+                               status.error() != GimbalError::InvalidAngle);
+    recordCommand(record, status, filtered);
+    if (!status) {
+        float value = 0.0f;
+        if (status.error() == GimbalError::InvalidAngle) {
+            value = status.pin() == core_.backend().panPin() ? pan_angle : tilt_angle;
+        }
+        return errors_.record(status, value);
     }
 
-    // Validate angles
-    if (!isValidAngle(pan_angle) || !isValidAngle(tilt_angle)) {
-        std::cerr << "Invalid angle values. Pan: " << pan_angle 
-                  << ", Tilt: " << tilt_angle 
-                  << " (valid range: " << MIN_ANGLE << " to " << MAX_ANGLE << ")" << std::endl;
-        return false;
-    }
+    GIMBAL_LOG_DEBUG("Gimbal angles set - Pan: %.2f°, Tilt: %.2f°", core_.getPanAngle(), core_.getTiltAngle());
 
-    // Convert angles to PWM pulse widths
-    uint32_t pan_pulse = angleToPulseWidth(pan_angle);
-    uint32_t tilt_pulse = angleToPulseWidth(tilt_angle);
+    return GimbalStatus::success();
+}
 
-    // Apply PWM signals to servos
-    if (!setPWM(pan_pin_, pan_pulse)) {
-        std::cerr << "Failed to set pan servo" << std::endl;
-        return false;
+void Gimbal::recordCommand(TelemetryRecord& record, GimbalStatus status, bool filtered) {
+    if (filtered) {
+        uint8_t writes = core_.getLastWrites();
+        uint64_t count = static_cast<uint64_t>((writes & GIMBAL_AXIS_PAN) != 0) +
+                         static_cast<uint64_t>((writes & GIMBAL_AXIS_TILT) != 0);
+        if (count < 2) {
+            writes_suppressed_.store(writes_suppressed_.load(std::memory_order_relaxed) + (2 - count),
+                                     std::memory_order_relaxed);
+        }
+        if (count > 0) {
+            writes_issued_.store(writes_issued_.load(std::memory_order_relaxed) + count,
+                                 std::memory_order_relaxed);
+            // The call's start doubles as the record's timestamp (ticks are not free)
+            uint64_t elapsed = core_.backend().lastCallTicks();
+            record.timestamp_ns = core_.backend().lastCallStart();
+            record.driver_ns = elapsed < UINT32_MAX ? static_cast<uint32_t>(elapsed) : UINT32_MAX;
+            record.writes = writes;
+        }
     }
-
-    if (!setPWM(tilt_pin_, tilt_pulse)) {
-        std::cerr << "Failed to set tilt servo" << std::endl;
-        return false;
+    if (record.timestamp_ns == 0) {
+        // Nothing was written: stamp the command itself
+        record.timestamp_ns = TelemetryRing::ticks();
     }
-
-    current_pan_angle_ = pan_angle;
-    current_tilt_angle_ = tilt_angle;
-
-    std::cout << "Gimbal angles set - Pan: " << pan_angle 
-              << "°, Tilt: " << tilt_angle << "°" << std::endl;
-
-    return true;
+    record.pan_pulse_us = core_.getPanPulse();
+    record.tilt_pulse_us = core_.getTiltPulse();
+    record.error = static_cast<uint8_t>(status.error());
+    telemetry_.record(record);
 }
 
 float Gimbal::getPanAngle() const {
-    return current_pan_angle_;
+    return core_.getPanAngle();
 }
 
 float Gimbal::getTiltAngle() const {
-    return current_tilt_angle_;
+    return core_.getTiltAngle();
 }
 
 bool Gimbal::isInitialized() const {
-    return initialized_;
+    return core_.isInitialized();
+}
+
+void Gimbal::setDeadzone(float degrees) {
+    core_.setDeadzone(degrees);
 }
 
-uint32_t Gimbal::angleToPulseWidth(float angle) const {
-    // Clamp angle to valid range
-    angle = std::clamp(angle, MIN_ANGLE, MAX_ANGLE);
+float Gimbal::getDeadzone() const {
+    return core_.getDeadzone();
+}
 
-    // Map angle [-90, 90] to pulse width [1000, 2000] microseconds
-    // Formula: pulse = MID_PULSE_WIDTH + (angle / MAX_ANGLE) * (MAX_PULSE_WIDTH - MID_PULSE_WIDTH)
-    uint32_t pulse_width = static_cast<uint32_t>(
-        MID_PULSE_WIDTH + (angle / MAX_ANGLE) * (MAX_PULSE_WIDTH - MID_PULSE_WIDTH)
-    );
+GimbalWriteStats Gimbal::getWriteStats() const {
+    GimbalWriteStats stats;
+    stats.issued = writes_issued_.load(std::memory_order_relaxed);
+    stats.suppressed = writes_suppressed_.load(std::memory_order_relaxed);
+    return stats;
+}
 
-    return pulse_width;
+void Gimbal::resetWriteStats() {
+    writes_issued_.store(0, std::memory_order_relaxed);
+    writes_suppressed_.store(0, std::memory_order_relaxed);
 }
 
-bool Gimbal::isValidAngle(float angle) const {
-    return angle >= MIN_ANGLE && angle <= MAX_ANGLE;
+const GimbalErrorStats& Gimbal::getErrorStats() const {
+    return errors_;
 }
 
-bool Gimbal::setPWM(uint32_t pin, uint32_t pulse_width) {
-    if (!pwm_controller_) {
-        return false;
+void Gimbal::resetErrorStats() {
+    errors_.reset();
+}
+
+const TelemetryRing& Gimbal::getTelemetryRing() const {
+    return telemetry_;
+}
+
+GimbalStatus Gimbal::setCalibration(const GimbalCalibration& calibration) {
+    // Frame rates are fixed once initialized, so a table the backend would
+    // reject on every write is refused here and never reaches the mailbox
+    GimbalStatus status = core_.checkCalibration(calibration.pan, calibration.tilt);
+    if (!status) {
+        bool tilt = status.pin() == core_.backend().tiltPin();
+        uint32_t hz = tilt ? core_.getTiltFrameRate() : core_.getPanFrameRate();
+        GIMBAL_LOG_ERROR("%s calibration does not fit its %u Hz frame", tilt ? "Tilt" : "Pan",
+                         static_cast<unsigned>(hz));
+        return errors_.record(status, static_cast<float>(hz));
     }
+#ifdef PICO_BUILD
+    core_.setCalibration(calibration.pan, calibration.tilt);
+#else
+    calibration_mailbox_.store(calibration);
+#endif
+    return GimbalStatus::success();
+}
 
-    // Period = 1000000 microseconds / 50 Hz = 20000 microseconds
-    uint32_t period_us = 1000000 / PWM_FREQUENCY;
-    
-    return pwm_controller_->setPulseWidth(pin, pulse_width, period_us);
+GimbalCalibration Gimbal::getCalibration() const {
+#ifdef PICO_BUILD
+    return GimbalCalibration{core_.getPanCalibration(), core_.getTiltCalibration()};
+#else
+    // core_ belongs to the commanding thread; the mailbox is safe to read
+    GimbalCalibration calibration;
+    calibration_mailbox_.load(calibration);
+    return calibration;
+#endif
+}
+
+#ifndef PICO_BUILD
+bool Gimbal::loadCalibration(const char* path) {
+    // Parsed and tabulated here, on the caller's thread
+    GimbalCalibration calibration;
+    if (!loadCalibrationFile(path, calibration)) {
+        return false;
+    }
+    return static_cast<bool>(setCalibration(calibration));
+}
+#endif
+
+void Gimbal::refreshCalibration() {
+#ifndef PICO_BUILD
+    // One acquire load per command; the copy only happens after a reload.
+    // setCalibration() checked the table, so the core accepts it
+    if (calibration_mailbox_.version() != calibration_version_) {
+        GimbalCalibration calibration;
+        calibration_version_ = calibration_mailbox_.load(calibration);
+        errors_.record(core_.setCalibration(calibration.pan, calibration.tilt));
+    }
+#endif
 }
@@ -0,0 +1,259 @@
+#include "GimbalArray.h"
+#include "GimbalConfig.h"
+#include "GimbalLog.h"
+#include <algorithm>
+#include <cmath>
+
+GimbalArray::GimbalArray(std::shared_ptr<PWMController> pwm_controller)
+    : pwm_controller_(pwm_controller),
+      deadzone_(GIMBAL_ANGLE_DEADZONE),
+      writes_issued_(0),
+      writes_suppressed_(0),
+      initialized_(false) {
+}
+
+GimbalArray::GimbalArray(PWMController* pwm_controller)
+    : GimbalArray(std::shared_ptr<PWMController>(pwm_controller)) {
+}
+
+GimbalArray::~GimbalArray() {
+    if (initialized_) {
+        shutdown();
+    }
+}
+
+AxisCalibration AxisCalibration::forServo(ServoModel model) {
+    ServoCalibration curve = ServoCalibration::forModel(model);
+    AxisCalibration calibration;
+    calibration.min_angle = curve.getMinAngle();
+    calibration.max_angle = curve.getMaxAngle();
+    calibration.min_pulse_us = static_cast<uint32_t>(curve.evaluate(calibration.min_angle) + 0.5f);
+    calibration.max_pulse_us = static_cast<uint32_t>(curve.evaluate(calibration.max_angle) + 0.5f);
+    calibration.model = model;
+    calibration.frequency_hz = getServoProfile(model).max_frequency_hz;
+    return calibration;
+}
+
+int GimbalArray::addAxis(uint32_t pin, const AxisCalibration& calibration) {
+    if (initialized_) {
+        return -1;
+    }
+    if (calibration.max_angle <= calibration.min_angle) {
+        errors_.record(GimbalStatus(GimbalError::InvalidArgument, pin), calibration.max_angle);
+        return -1;
+    }
+    // Same checks as Gimbal::setFrameRate(): backend range, servo rating,
+    // and both end stops inside the frame
+    const uint32_t frequency = calibration.frequency_hz;
+    const uint32_t longest_pulse = std::max(calibration.min_pulse_us, calibration.max_pulse_us);
+    if (frequency < Gimbal::MIN_PWM_FREQUENCY || frequency > Gimbal::MAX_PWM_FREQUENCY ||
+        !isFrameRateSupported(calibration.model, frequency) || longest_pulse >= 1000000 / frequency) {
+        GIMBAL_LOG_ERROR("GimbalArray: %u Hz is out of range for the %s servo on pin %u",
+                         static_cast<unsigned>(frequency), getServoProfile(calibration.model).name,
+                         static_cast<unsigned>(pin));
+        errors_.record(GimbalStatus(GimbalError::InvalidArgument, pin), static_cast<float>(frequency));
+        return -1;
+    }
+
+    float span = calibration.max_angle - calibration.min_angle;
+    float scale = (static_cast<float>(calibration.max_pulse_us) - static_cast<float>(calibration.min_pulse_us)) / span;
+
+    pins_.push_back(pin);
+    min_angle_.push_back(calibration.min_angle);
+    max_angle_.push_back(calibration.max_angle);
+    pulse_offset_.push_back(static_cast<float>(calibration.min_pulse_us) - calibration.min_angle * scale);
+    pulse_scale_.push_back(scale);
+    frequency_.push_back(frequency);
+    period_us_.push_back(1000000 / frequency);
+    return static_cast<int>(pins_.size() - 1);
+}
+
+int GimbalArray::addHead(uint32_t pan_pin, uint32_t tilt_pin) {
+    int pan_axis = addAxis(pan_pin);
+    if (pan_axis < 0 || addAxis(tilt_pin) < 0) {
+        return -1;
+    }
+    return pan_axis;
+}
+
+GimbalStatus GimbalArray::init() {
+    if (initialized_) {
+        GIMBAL_LOG_INFO("GimbalArray already initialized");
+        return GimbalStatus::success();
+    }
+    if (!pwm_controller_) {
+        GIMBAL_LOG_ERROR("GimbalArray: PWM controller not set");
+        return errors_.record(GimbalStatus(GimbalError::DeviceUnavailable));
+    }
+    if (pins_.empty()) {
+        GIMBAL_LOG_ERROR("GimbalArray: no axes");
+        return errors_.record(GimbalStatus(GimbalError::InvalidArgument));
+    }
+
+    GIMBAL_LOG_INFO("Initializing gimbal array: %u axes (Platform: %s)",
+                    static_cast<unsigned>(pins_.size()), pwm_controller_->getPlatformName());
+
+    for (size_t i = 0; i < pins_.size(); ++i) {
+        GimbalStatus status = pwm_controller_->initPin(pins_[i], frequency_[i]);
+        if (!status) {
+            GIMBAL_LOG_ERROR("GimbalArray: failed to initialize PWM on pin %u (%s)", static_cast<unsigned>(pins_[i]),
+                             gimbalErrorName(status.error()));
+            for (size_t j = 0; j < i; ++j) {
+                pwm_controller_->shutdownPin(pins_[j]);
+            }
+            return errors_.record(status);
+        }
+    }
+
+    // Center every axis (0 degrees, or the nearest end of its range);
+    // pulses start unknown so the first update writes all of them
+    size_t n = pins_.size();
+    target_.assign(n, 0.0f);
+    for (size_t i = 0; i < n; ++i) {
+        target_[i] = std::min(std::max(0.0f, min_angle_[i]), max_angle_[i]);
+    }
+    current_ = target_;
+    pulse_.assign(n, 0);
+    next_pulse_.assign(n, 0);
+    commands_.resize(n);
+
+    initialized_ = true;
+    GimbalStatus status = update();
+    if (!status) {
+        // update() has recorded the failure
+        GIMBAL_LOG_ERROR("GimbalArray: failed to center servos (%s)", gimbalErrorName(status.error()));
+        shutdown();
+        return status;
+    }
+
+    GIMBAL_LOG_INFO("Gimbal array initialized successfully");
+    return GimbalStatus::success();
+}
+
+void GimbalArray::shutdown() {
+    if (!initialized_) {
+        return;
+    }
+
+    if (pwm_controller_) {
+        for (uint32_t pin : pins_) {
+            pwm_controller_->shutdownPin(pin);
+        }
+    }
+
+    GIMBAL_LOG_INFO("Shutting down gimbal array");
+    std::fill(pulse_.begin(), pulse_.end(), 0);
+    initialized_ = false;
+}
+
+GimbalStatus GimbalArray::setTarget(size_t axis, float angle) {
+    // Failures are counted, not logged: this path runs every frame
+    if (!initialized_) {
+        return errors_.record(GimbalStatus(GimbalError::NotInitialized));
+    }
+    if (axis >= pins_.size()) {
+        return errors_.record(GimbalStatus(GimbalError::InvalidArgument), static_cast<float>(axis));
+    }
+    // Written this way round, NaN is rejected as well
+    if (!(angle >= min_angle_[axis] && angle <= max_angle_[axis])) {
+        return errors_.record(GimbalStatus(GimbalError::InvalidAngle, pins_[axis]), angle);
+    }
+    target_[axis] = angle;
+    return GimbalStatus::success();
+}
+
+GimbalStatus GimbalArray::setTargets(size_t first, const float* angles, size_t count) {
+    GimbalStatus result;
+    for (size_t i = 0; i < count; ++i) {
+        GimbalStatus status = setTarget(first + i, angles[i]);
+        if (!status && result) {
+            result = status;
+        }
+    }
+    return result;
+}
+
+GimbalStatus GimbalArray::setHead(size_t pan_axis, float pan_angle, float tilt_angle) {
+    GimbalStatus pan = setTarget(pan_axis, pan_angle);
+    GimbalStatus tilt = setTarget(pan_axis + 1, tilt_angle);
+    return pan ? tilt : pan;
+}
+
+void GimbalArray::convertAll() {
+    // Branch-free over plain arrays so the loop vectorizes
+    const size_t n = pins_.size();
+    const float* target = target_.data();
+    const float* min_angle = min_angle_.data();
+    const float* max_angle = max_angle_.data();
+    const float* offset = pulse_offset_.data();
+    const float* scale = pulse_scale_.data();
+    float* current = current_.data();
+    uint32_t* next = next_pulse_.data();
+    const float deadzone = deadzone_;
+
+    for (size_t i = 0; i < n; ++i) {
+        float angle = target[i] < min_angle[i] ? min_angle[i] : target[i];
+        angle = angle > max_angle[i] ? max_angle[i] : angle;
+        // Hold the axis unless the request leaves the deadzone
+        angle = std::fabs(angle - current[i]) < deadzone ? current[i] : angle;
+        current[i] = angle;
+        next[i] = static_cast<uint32_t>(static_cast<int32_t>(offset[i] + angle * scale[i] + 0.5f));
+    }
+}
+
+GimbalStatus GimbalArray::update() {
+    if (!initialized_) {
+        return errors_.record(GimbalStatus(GimbalError::NotInitialized));
+    }
+
+    convertAll();
+
+    // Compact the changed axes into one batch
+    const size_t n = pins_.size();
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (next_pulse_[i] != pulse_[i]) {
+            commands_[count++] = PulseCommand{pins_[i], next_pulse_[i], period_us_[i]};
+        }
+    }
+
+    writes_suppressed_ += n - count;
+    if (count == 0) {
+        return GimbalStatus::success();
+    }
+
+    writes_issued_ += count;
+    // Failures are counted by the controller; nothing is logged per frame
+    GimbalStatus status = pwm_controller_->setPulseWidths(commands_.data(), count);
+    for (size_t i = 0; i < n; ++i) {
+        // Output state unknown after a failed write: force the next one
+        if (next_pulse_[i] != pulse_[i]) {
+            pulse_[i] = status ? next_pulse_[i] : 0;
+        }
+    }
+    return status ? status : errors_.record(status);
+}
+
+float GimbalArray::getAngle(size_t axis) const {
+    return axis < current_.size() ? current_[axis] : 0.0f;
+}
+
+uint32_t GimbalArray::getPulseWidth(size_t axis) const {
+    return axis < pulse_.size() ? pulse_[axis] : 0;
+}
+
+void GimbalArray::setDeadzone(float degrees) {
+    deadzone_ = degrees > 0.0f ? degrees : 0.0f;
+}
+
+GimbalWriteStats GimbalArray::getWriteStats() const {
+    GimbalWriteStats stats;
+    stats.issued = writes_issued_;
+    stats.suppressed = writes_suppressed_;
+    return stats;
+}
+
+void GimbalArray::resetWriteStats() {
+    writes_issued_ = 0;
+    writes_suppressed_ = 0;
+}
@@ -0,0 +1,309 @@
+#include "GimbalController.h"
+#include "GimbalLog.h"
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+namespace {
+
+constexpr int64_t NANOS_PER_SECOND = 1000000000;
+
+int64_t toNanos(const timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * NANOS_PER_SECOND + ts.tv_nsec;
+}
+
+timespec fromNanos(int64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / NANOS_PER_SECOND);
+    ts.tv_nsec = static_cast<long>(ns % NANOS_PER_SECOND);
+    return ts;
+}
+
+int64_t monotonicNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return toNanos(ts);
+}
+
+/// Clamp to the servo range: a prediction may lead a target past the end stops
+float clampAngle(float angle) {
+    if (angle > Gimbal::Core::MAX_ANGLE) {
+        return Gimbal::Core::MAX_ANGLE;
+    }
+    return angle < Gimbal::Core::MIN_ANGLE ? Gimbal::Core::MIN_ANGLE : angle;
+}
+
+} // namespace
+
+GimbalController::GimbalController(Gimbal& gimbal, const GimbalControllerConfig& config)
+    : gimbal_(gimbal),
+      config_(config),
+      frequency_hz_(0),
+      mailbox_(config.mailbox ? config.mailbox : &own_mailbox_),
+      commands_(config.max_command_age_ns),
+      predictor_(config.predictor),
+      arrival_time_ns_(0),
+      running_(false),
+      frames_(0),
+      updates_(0),
+      failures_(0),
+      deadline_misses_(0),
+      last_jitter_ns_(0),
+      max_jitter_ns_(0),
+      total_jitter_ns_(0),
+      realtime_(false) {
+}
+
+GimbalController::~GimbalController() {
+    stop();
+}
+
+bool GimbalController::start() {
+    if (running_.load()) {
+        return true;
+    }
+    if (!gimbal_.isInitialized()) {
+        GIMBAL_LOG_ERROR("GimbalController: gimbal not initialized");
+        return false;
+    }
+    // One tick per frame of the faster axis: a slower loop would leave
+    // high-refresh servos waiting on the loop instead of the PWM frame
+    frequency_hz_ = config_.frequency_hz > 0 ? config_.frequency_hz : gimbal_.getFrameRate();
+    if (frequency_hz_ == 0) {
+        GIMBAL_LOG_ERROR("GimbalController: invalid loop frequency");
+        return false;
+    }
+
+    profile_.setLimits(config_.pan_limits, config_.tilt_limits);
+    profile_.reset(gimbal_.getPanAngle(), gimbal_.getTiltAngle());
+    predictor_.reset();
+
+    running_.store(true);
+    thread_ = std::thread(&GimbalController::run, this);
+    return true;
+}
+
+void GimbalController::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool GimbalController::isRunning() const {
+    return running_.load();
+}
+
+void GimbalController::setTarget(float pan_angle, float tilt_angle) {
+    Setpoint setpoint;
+    setpoint.pan_angle = pan_angle;
+    setpoint.tilt_angle = tilt_angle;
+    setpoint.timestamp_ns = static_cast<uint64_t>(monotonicNanos());
+    mailbox_->store(setpoint);
+}
+
+void GimbalController::submit(float pan_angle, float tilt_angle, uint64_t timestamp_ns) {
+    commands_.submit(pan_angle, tilt_angle, timestamp_ns);
+}
+
+CommandQueueStats GimbalController::getCommandStats() const {
+    return commands_.getStats();
+}
+
+uint64_t GimbalController::getArrivalTime() const {
+    return arrival_time_ns_.load(std::memory_order_relaxed);
+}
+
+GimbalControllerStats GimbalController::getStats() const {
+    GimbalControllerStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.updates = updates_.load(std::memory_order_relaxed);
+    stats.failures = failures_.load(std::memory_order_relaxed);
+    stats.deadline_misses = deadline_misses_.load(std::memory_order_relaxed);
+    stats.last_jitter_ns = last_jitter_ns_.load(std::memory_order_relaxed);
+    stats.max_jitter_ns = max_jitter_ns_.load(std::memory_order_relaxed);
+    stats.mean_jitter_ns = stats.frames > 0
+        ? static_cast<double>(total_jitter_ns_.load(std::memory_order_relaxed)) / static_cast<double>(stats.frames)
+        : 0.0;
+    stats.realtime = realtime_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void GimbalController::configureThread() {
+    if (config_.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config_.cpu, &cpus);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (rc != 0) {
+            GIMBAL_LOG_WARNING("GimbalController: cannot pin loop to CPU %d (%s)", config_.cpu, std::strerror(rc));
+        }
+    }
+
+    if (config_.realtime_priority > 0) {
+        sched_param param{};
+        param.sched_priority = config_.realtime_priority;
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc == 0) {
+            realtime_.store(true);
+        } else {
+            // Typically EPERM without CAP_SYS_NICE / rtprio limits: keep running best-effort
+            GIMBAL_LOG_WARNING("GimbalController: SCHED_FIFO not permitted (%s), using default policy",
+                               std::strerror(rc));
+        }
+    }
+}
+
+void GimbalController::run() {
+    configureThread();
+
+    const int64_t period_ns = NANOS_PER_SECOND / frequency_hz_;
+    uint32_t applied_version = 0;
+    uint64_t setpoint_ns = 0;
+    uint64_t applied_ns = 0;
+    GimbalError last_error = GimbalError::None;
+    bool moving = false;
+    bool predicting = false;
+    float world_pan = gimbal_.getPanAngle();
+    float world_tilt = gimbal_.getTiltAngle();
+    int64_t deadline = monotonicNanos() + period_ns;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        timespec wake = fromNanos(deadline);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR) {
+        }
+
+        int64_t jitter = monotonicNanos() - deadline;
+        last_jitter_ns_.store(jitter, std::memory_order_relaxed);
+        total_jitter_ns_.fetch_add(jitter, std::memory_order_relaxed);
+        if (jitter > max_jitter_ns_.load(std::memory_order_relaxed)) {
+            max_jitter_ns_.store(jitter, std::memory_order_relaxed);
+        }
+
+        bool command = false;
+        float pan_angle = 0.0f;
+        float tilt_angle = 0.0f;
+
+        // Newest of the mailbox setpoint and the queued commands wins
+        bool have_target = false;
+        Setpoint setpoint{};
+        uint32_t version = 0;
+        if (mailbox_->version() != applied_version && mailbox_->tryLoad(setpoint, version)) {
+            applied_version = version;
+            commands_.advance(setpoint.timestamp_ns);
+            have_target = true;
+            // A direct setpoint overrides the tracked target
+            predictor_.reset();
+            predicting = false;
+        }
+
+        GimbalCommand queued;
+        bool have_queued = commands_.takeLatest(static_cast<uint64_t>(deadline), queued);
+        if (have_queued && config_.predict_targets) {
+            // Queued commands are measurements; command the prediction below
+            predicting = predictor_.update(queued.pan_angle, queued.tilt_angle, queued.timestamp_ns) || predicting;
+        } else if (have_queued) {
+            setpoint.pan_angle = queued.pan_angle;
+            setpoint.tilt_angle = queued.tilt_angle;
+            setpoint.timestamp_ns = queued.timestamp_ns;
+            have_target = true;
+        }
+
+        // Follow the prediction every frame until the track goes stale; a
+        // motion profile replans from its current velocity and acceleration,
+        // so retargeting it every frame stays within the axis limits
+        if (predicting) {
+            uint64_t command_ns = static_cast<uint64_t>(deadline);
+            predictor_.predict(command_ns, setpoint.pan_angle, setpoint.tilt_angle);
+            // Telemetry reports the measurement the prediction extends
+            setpoint.timestamp_ns = predictor_.getLastTimestamp();
+            if (!config_.stabilizer) {
+                // World-frame targets are clamped by the stabilizer instead
+                setpoint.pan_angle = clampAngle(setpoint.pan_angle);
+                setpoint.tilt_angle = clampAngle(setpoint.tilt_angle);
+            }
+            predicting = !predictor_.isHorizonExceeded(command_ns);
+            have_target = true;
+        }
+
+        if (have_target) {
+            setpoint_ns = setpoint.timestamp_ns;
+            if (profile_.isLimited()) {
+                // Trajectory time runs on the frame deadlines, not the
+                // jittery wake-up times
+                profile_.setTarget(setpoint.pan_angle, setpoint.tilt_angle, static_cast<uint64_t>(deadline) / 1000);
+                arrival_time_ns_.store(profile_.getArrivalTime() * 1000, std::memory_order_relaxed);
+                moving = true;
+            } else {
+                pan_angle = setpoint.pan_angle;
+                tilt_angle = setpoint.tilt_angle;
+                command = true;
+                arrival_time_ns_.store(static_cast<uint64_t>(deadline), std::memory_order_relaxed);
+            }
+        }
+
+        if (moving) {
+            uint64_t now_us = static_cast<uint64_t>(deadline) / 1000;
+            profile_.sample(now_us, pan_angle, tilt_angle);
+            moving = !profile_.isSettled(now_us);
+            command = true;
+        }
+
+        if (config_.stabilizer) {
+            // The angles above are world-frame; the mount moves under a
+            // fixed target, so the servo angles are re-solved every frame
+            if (command) {
+                world_pan = pan_angle;
+                world_tilt = tilt_angle;
+            }
+            config_.stabilizer->update();
+            config_.stabilizer->toServoAngles(world_pan, world_tilt, static_cast<uint64_t>(deadline), pan_angle,
+                                              tilt_angle);
+            command = true;
+        }
+
+        if (command) {
+            GimbalStatus status = gimbal_.setTipAngle(pan_angle, tilt_angle);
+            if (status) {
+                updates_.fetch_add(1, std::memory_order_relaxed);
+                applied_ns = static_cast<uint64_t>(monotonicNanos());
+                if (have_queued) {
+                    commands_.recordApplied(queued, applied_ns);
+                }
+            } else {
+                failures_.fetch_add(1, std::memory_order_relaxed);
+                last_error = status.error();
+            }
+        }
+        frames_.fetch_add(1, std::memory_order_relaxed);
+
+        if (config_.telemetry) {
+            GimbalTelemetry telemetry;
+            telemetry.pan_angle = gimbal_.getPanAngle();
+            telemetry.tilt_angle = gimbal_.getTiltAngle();
+            telemetry.setpoint_timestamp_ns = setpoint_ns;
+            telemetry.applied_ns = applied_ns;
+            telemetry.frame_ns = static_cast<uint64_t>(deadline);
+            telemetry.frames = frames_.load(std::memory_order_relaxed);
+            telemetry.updates = updates_.load(std::memory_order_relaxed);
+            telemetry.failures = failures_.load(std::memory_order_relaxed);
+            telemetry.last_error = static_cast<uint32_t>(last_error);
+            telemetry.reserved = 0;
+            config_.telemetry->store(telemetry);
+        }
+
+        // Next frame; if this tick overran one or more frames, skip them
+        // instead of bursting to catch up
+        deadline += period_ns;
+        int64_t now = monotonicNanos();
+        if (now > deadline) {
+            int64_t missed = (now - deadline) / period_ns + 1;
+            deadline_misses_.fetch_add(static_cast<uint64_t>(missed), std::memory_order_relaxed);
+            deadline += missed * period_ns;
+        }
+    }
+}
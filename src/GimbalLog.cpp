@@ -0,0 +1,134 @@
+#include "GimbalLog.h"
+#include "BoundedQueue.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+#ifdef PICO_BUILD
+#include "pico/time.h"
+#else
+#include <chrono>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace {
+
+/**
+ * Bounded multi-producer ring: records are formatted straight into their
+ * queue cell and handed to the sink in place, so neither side takes a lock
+ * or copies a message.
+ */
+struct LogRing {
+    BoundedQueue<LogRecord, GIMBAL_LOG_RING_CAPACITY> records;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<LogSink> sink{nullptr};
+    std::atomic<void*> sink_context{nullptr};
+};
+
+LogRing& ring() {
+    static LogRing instance;
+    return instance;
+}
+
+uint64_t nowMicros() {
+#ifdef PICO_BUILD
+    return time_us_64();
+#else
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void defaultSink(const LogRecord& record, void* /*context*/) {
+    FILE* stream = (record.level <= LogLevel::Warning) ? stderr : stdout;
+    std::fputs(record.message, stream);
+    std::fputc('\n', stream);
+}
+
+} // namespace
+
+void GimbalLog::write(LogLevel level, const char* format, ...) {
+    LogRing& r = ring();
+
+    va_list args;
+    va_start(args, format);
+    bool queued = r.records.emplace([&](LogRecord& record) {
+        record.timestamp_us = nowMicros();
+        record.level = level;
+        std::vsnprintf(record.message, sizeof(record.message), format, args);
+    });
+    va_end(args);
+
+    if (!queued) {
+        // Ring full: drop rather than block the caller
+        r.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t GimbalLog::drain() {
+    LogRing& r = ring();
+    LogSink sink = r.sink.load(std::memory_order_acquire);
+    void* context = r.sink_context.load(std::memory_order_acquire);
+    if (!sink) {
+        sink = defaultSink;
+    }
+
+    size_t count = 0;
+    while (r.records.consume([&](const LogRecord& record) { sink(record, context); })) {
+        ++count;
+    }
+
+    if (count > 0 && sink == defaultSink) {
+        std::fflush(stdout);
+    }
+    return count;
+}
+
+void GimbalLog::setSink(LogSink sink, void* context) {
+    LogRing& r = ring();
+    r.sink_context.store(context, std::memory_order_release);
+    r.sink.store(sink, std::memory_order_release);
+}
+
+uint64_t GimbalLog::droppedCount() {
+    return ring().dropped.load(std::memory_order_relaxed);
+}
+
+#ifndef PICO_BUILD
+namespace {
+
+std::mutex drain_thread_mutex;
+std::thread drain_thread;
+std::atomic<bool> drain_thread_running{false};
+
+} // namespace
+
+bool GimbalLog::startDrainThread(uint32_t interval_ms) {
+    std::lock_guard<std::mutex> lock(drain_thread_mutex);
+    if (drain_thread_running.load()) {
+        return true;
+    }
+
+    drain_thread_running.store(true);
+    drain_thread = std::thread([interval_ms]() {
+        while (drain_thread_running.load(std::memory_order_relaxed)) {
+            GimbalLog::drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        }
+        GimbalLog::drain();
+    });
+    return true;
+}
+
+void GimbalLog::stopDrainThread() {
+    std::lock_guard<std::mutex> lock(drain_thread_mutex);
+    if (!drain_thread_running.exchange(false)) {
+        return;
+    }
+    if (drain_thread.joinable()) {
+        drain_thread.join();
+    }
+}
+#endif
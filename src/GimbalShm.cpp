@@ -0,0 +1,145 @@
+#include "GimbalShm.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// The block is shared between processes: the atomics must not fall back to
+// process-local locks
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared seqlock needs lock-free 32-bit atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared seqlock needs lock-free 64-bit atomics");
+
+namespace {
+
+/// Attempts before getTelemetry() gives up on a block stuck mid-store
+constexpr int TELEMETRY_READ_ATTEMPTS = 64;
+
+} // namespace
+
+GimbalShm::GimbalShm() : block_(nullptr), owner_(false), name_{} {}
+
+GimbalShm::~GimbalShm() {
+    close();
+}
+
+GimbalStatus GimbalShm::create(const char* name) {
+    close();
+    if (!name || std::strlen(name) >= sizeof(name_)) {
+        return GimbalStatus(GimbalError::InvalidArgument);
+    }
+
+    // Start from a fresh segment: a stale one may still be locked by a
+    // client that died mid-store
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, errno);
+    }
+    if (ftruncate(fd, sizeof(GimbalShmBlock)) != 0) {
+        int error = errno;
+        ::close(fd);
+        shm_unlink(name);
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, error);
+    }
+    void* memory = mmap(nullptr, sizeof(GimbalShmBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(name);
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, error);
+    }
+
+    block_ = new (memory) GimbalShmBlock();
+    block_->version = GimbalShmBlock::VERSION;
+    block_->size = sizeof(GimbalShmBlock);
+    block_->daemon_pid = static_cast<uint32_t>(getpid());
+    // Clients check the magic first: publish it after the rest of the block
+    block_->magic.store(GimbalShmBlock::MAGIC, std::memory_order_release);
+
+    owner_ = true;
+    std::snprintf(name_, sizeof(name_), "%s", name);
+    return GimbalStatus::success();
+}
+
+GimbalStatus GimbalShm::open(const char* name) {
+    close();
+    if (!name) {
+        return GimbalStatus(GimbalError::InvalidArgument);
+    }
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, errno);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(GimbalShmBlock)) {
+        ::close(fd);
+        return GimbalStatus(GimbalError::InvalidArgument);
+    }
+    void* memory = mmap(nullptr, sizeof(GimbalShmBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, error);
+    }
+
+    GimbalShmBlock* block = static_cast<GimbalShmBlock*>(memory);
+    uint32_t magic = block->magic.load(std::memory_order_acquire);
+    if (magic != GimbalShmBlock::MAGIC || block->version != GimbalShmBlock::VERSION ||
+        block->size != sizeof(GimbalShmBlock)) {
+        munmap(memory, sizeof(GimbalShmBlock));
+        return GimbalStatus(GimbalError::InvalidArgument);
+    }
+
+    block_ = block;
+    owner_ = false;
+    return GimbalStatus::success();
+}
+
+void GimbalShm::close() {
+    if (!block_) {
+        return;
+    }
+    munmap(block_, sizeof(GimbalShmBlock));
+    block_ = nullptr;
+    if (owner_) {
+        shm_unlink(name_);
+        owner_ = false;
+    }
+}
+
+bool GimbalShm::setTarget(float pan_angle, float tilt_angle, uint64_t timestamp_ns) {
+    if (!block_) {
+        return false;
+    }
+    Setpoint setpoint;
+    setpoint.pan_angle = pan_angle;
+    setpoint.tilt_angle = tilt_angle;
+    setpoint.timestamp_ns = timestamp_ns != 0 ? timestamp_ns : now();
+    block_->setpoint.store(setpoint);
+    return true;
+}
+
+bool GimbalShm::getTelemetry(GimbalTelemetry& telemetry) const {
+    if (!block_) {
+        return false;
+    }
+    uint32_t version = 0;
+    for (int attempt = 0; attempt < TELEMETRY_READ_ATTEMPTS; ++attempt) {
+        if (block_->telemetry.tryLoad(telemetry, version)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t GimbalShm::now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+}
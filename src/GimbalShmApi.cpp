@@ -0,0 +1,53 @@
+#include "GimbalShmApi.h"
+#include "GimbalShm.h"
+#include <new>
+
+struct gimbal_shm {
+    GimbalShm shm;
+};
+
+extern "C" {
+
+gimbal_shm* gimbal_shm_open(const char* name) {
+    gimbal_shm* handle = new (std::nothrow) gimbal_shm;
+    if (!handle) {
+        return nullptr;
+    }
+    if (!handle->shm.open(name ? name : GIMBAL_SHM_DEFAULT_NAME)) {
+        delete handle;
+        return nullptr;
+    }
+    return handle;
+}
+
+void gimbal_shm_close(gimbal_shm* shm) {
+    delete shm;
+}
+
+int gimbal_shm_set_target(gimbal_shm* shm, float pan_angle, float tilt_angle, uint64_t timestamp_ns) {
+    return (shm && shm->shm.setTarget(pan_angle, tilt_angle, timestamp_ns)) ? 0 : -1;
+}
+
+int gimbal_shm_read_telemetry(const gimbal_shm* shm, gimbal_shm_telemetry* telemetry) {
+    GimbalTelemetry snapshot;
+    if (!shm || !telemetry || !shm->shm.getTelemetry(snapshot)) {
+        return -1;
+    }
+    telemetry->pan_angle = snapshot.pan_angle;
+    telemetry->tilt_angle = snapshot.tilt_angle;
+    telemetry->setpoint_timestamp_ns = snapshot.setpoint_timestamp_ns;
+    telemetry->applied_ns = snapshot.applied_ns;
+    telemetry->frame_ns = snapshot.frame_ns;
+    telemetry->frames = snapshot.frames;
+    telemetry->updates = snapshot.updates;
+    telemetry->failures = snapshot.failures;
+    telemetry->last_error = snapshot.last_error;
+    telemetry->reserved = 0;
+    return 0;
+}
+
+uint64_t gimbal_shm_now_ns(void) {
+    return GimbalShm::now();
+}
+
+} // extern "C"
@@ -0,0 +1,85 @@
+#include "GimbalStatus.h"
+
+#ifdef PICO_BUILD
+#include "pico/time.h"
+#else
+#include <time.h>
+#endif
+
+namespace {
+
+uint64_t nowNanos() {
+#ifdef PICO_BUILD
+    return time_us_64() * 1000;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+} // namespace
+
+const char* gimbalErrorName(GimbalError error) {
+    switch (error) {
+    case GimbalError::None: return "none";
+    case GimbalError::NotInitialized: return "not initialized";
+    case GimbalError::InvalidAngle: return "invalid angle";
+    case GimbalError::InvalidArgument: return "invalid argument";
+    case GimbalError::PinNotInitialized: return "pin not initialized";
+    case GimbalError::PinUnavailable: return "pin unavailable";
+    case GimbalError::DeviceUnavailable: return "device unavailable";
+    case GimbalError::IoError: return "I/O error";
+    case GimbalError::Count: break;
+    }
+    return "unknown";
+}
+
+GimbalErrorStats::GimbalErrorStats() : total_(0) {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+GimbalStatus GimbalErrorStats::record(GimbalStatus status, float value) {
+    size_t kind = static_cast<size_t>(status.error());
+    if (status.ok() || kind >= KINDS) {
+        return status;
+    }
+
+    counts_[kind].fetch_add(1, std::memory_order_relaxed);
+    GimbalErrorRecord record;
+    record.error = status.error();
+    record.pin = status.pin();
+    record.detail = status.detail();
+    record.value = value;
+    record.timestamp_ns = nowNanos();
+    record.sequence = total_.fetch_add(1, std::memory_order_relaxed) + 1;
+    last_.store(record);
+    return status;
+}
+
+uint64_t GimbalErrorStats::count(GimbalError error) const {
+    size_t kind = static_cast<size_t>(error);
+    return kind < KINDS ? counts_[kind].load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t GimbalErrorStats::total() const {
+    return total_.load(std::memory_order_relaxed);
+}
+
+bool GimbalErrorStats::getLastError(GimbalErrorRecord& record) const {
+    if (total_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    last_.load(record);
+    return record.error != GimbalError::None;
+}
+
+void GimbalErrorStats::reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    total_.store(0, std::memory_order_relaxed);
+    last_.store(GimbalErrorRecord{GimbalError::None, GimbalStatus::NO_PIN, 0, 0.0f, 0, 0});
+}
@@ -0,0 +1,516 @@
+#include "GimbalUdp.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+/// Poll timeout of the server thread: bounds how long stop() waits
+constexpr int THREAD_POLL_MS = 100;
+
+/// Attempts at reading a telemetry snapshot before acking without one
+constexpr int TELEMETRY_READ_ATTEMPTS = 4;
+
+uint64_t monotonicNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/// Serial number comparison (RFC 1982): a is newer than b, across wrap-around
+bool isNewer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+bool sameSender(const sockaddr_in& a, const sockaddr_in& b) {
+    return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+uint32_t saturate32(uint64_t value) {
+    return value < UINT32_MAX ? static_cast<uint32_t>(value) : UINT32_MAX;
+}
+
+template <typename T>
+void bump(std::atomic<T>& counter, T amount) {
+    if (amount != 0) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+GimbalUdpServer::GimbalUdpServer(SetpointMailbox& mailbox, const TelemetryMailbox* telemetry)
+    : mailbox_(&mailbox),
+      telemetry_(telemetry),
+      fd_(-1),
+      port_(0),
+      resync_ns_(0),
+      synced_(false),
+      last_sequence_(0),
+      last_accept_ns_(0),
+      echo_timestamp_ns_(0),
+      messages_{},
+      vectors_{},
+      senders_{},
+      slots_{},
+      ack_messages_{},
+      ack_vectors_{},
+      ack_peers_{},
+      acks_{},
+      running_(false),
+      batches_(0),
+      received_(0),
+      accepted_(0),
+      superseded_(0),
+      stale_(0),
+      invalid_(0),
+      published_(0),
+      acks_sent_(0),
+      ack_errors_(0),
+      stats_sequence_(0) {
+}
+
+GimbalUdpServer::~GimbalUdpServer() {
+    close();
+}
+
+GimbalStatus GimbalUdpServer::open(const GimbalUdpConfig& config) {
+    close();
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config.port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (config.bind_address && inet_pton(AF_INET, config.bind_address, &address.sin_addr) != 1) {
+        return GimbalStatus(GimbalError::InvalidArgument);
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, errno);
+    }
+    if (config.receive_buffer_bytes > 0) {
+        // Best effort: the kernel caps it at net.core.rmem_max
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config.receive_buffer_bytes, sizeof(config.receive_buffer_bytes));
+    }
+    socklen_t length = sizeof(address);
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        int error = errno;
+        ::close(fd);
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, error);
+    }
+
+    // Point every receive and ack slot at its buffers once
+    for (size_t i = 0; i < BATCH; ++i) {
+        vectors_[i].iov_base = slots_[i].data;
+        vectors_[i].iov_len = sizeof(slots_[i].data);
+        ack_vectors_[i].iov_base = &acks_[i];
+        ack_vectors_[i].iov_len = sizeof(GimbalUdpAck);
+        ack_messages_[i].msg_hdr = msghdr{};
+        ack_messages_[i].msg_hdr.msg_name = &ack_peers_[i];
+        ack_messages_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        ack_messages_[i].msg_hdr.msg_iov = &ack_vectors_[i];
+        ack_messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    fd_ = fd;
+    port_ = ntohs(address.sin_port);
+    resync_ns_ = config.resync_ns;
+    synced_ = false;
+    return GimbalStatus::success();
+}
+
+void GimbalUdpServer::close() {
+    stop();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    port_ = 0;
+}
+
+int GimbalUdpServer::poll(int timeout_ms) {
+    if (fd_ < 0) {
+        return -1;
+    }
+    if (timeout_ms != 0) {
+        pollfd descriptor{fd_, POLLIN, 0};
+        int ready = ::poll(&descriptor, 1, timeout_ms);
+        if (ready < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+        if (ready == 0) {
+            return 0;
+        }
+    }
+
+    // Drain: full batches mean more may be queued
+    int total = 0;
+    for (;;) {
+        // recvmmsg() overwrites the name and payload lengths
+        for (size_t i = 0; i < BATCH; ++i) {
+            msghdr& header = messages_[i].msg_hdr;
+            header.msg_name = &senders_[i];
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov = &vectors_[i];
+            header.msg_iovlen = 1;
+            header.msg_control = nullptr;
+            header.msg_controllen = 0;
+            header.msg_flags = 0;
+        }
+        int count = recvmmsg(fd_, messages_, BATCH, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            return total > 0 ? total : -1;
+        }
+        if (count == 0) {
+            break;
+        }
+        processBatch(count, monotonicNanos());
+        total += count;
+        if (static_cast<size_t>(count) < BATCH) {
+            break;
+        }
+    }
+    return total;
+}
+
+void GimbalUdpServer::processBatch(int count, uint64_t now_ns) {
+    uint64_t received = 0;
+    uint64_t accepted = 0;
+    uint64_t stale = 0;
+    uint64_t invalid = 0;
+    GimbalUdpCommand newest{};
+    size_t peers = 0;
+
+    // A sender that went quiet for resync_ns may have restarted its count
+    if (synced_ && resync_ns_ != 0 && now_ns - last_accept_ns_ > resync_ns_) {
+        synced_ = false;
+    }
+
+    GimbalUdpCommand command;
+    for (int i = 0; i < count; ++i) {
+        const mmsghdr& message = messages_[i];
+        if ((message.msg_hdr.msg_flags & MSG_TRUNC) ||
+            !decode(slots_[i].data, message.msg_len, command)) {
+            ++invalid;
+            continue;
+        }
+        ++received;
+
+        // RESET is not honoured while synced: a late copy of a session's first
+        // datagram, or another sender's, would rewind the sequence. A restarted
+        // sender is picked up once resync_ns passes without a newer datagram
+        if (!synced_ || isNewer(command.sequence, last_sequence_)) {
+            synced_ = true;
+            last_sequence_ = command.sequence;
+            newest = command;
+            ++accepted;
+        } else {
+            ++stale;
+        }
+
+        if (command.flags & GIMBAL_UDP_FLAG_ACK) {
+            // Coalesce per sender: one ack answers all its datagrams in the batch
+            size_t peer = 0;
+            while (peer < peers && !sameSender(ack_peers_[peer], senders_[i])) {
+                ++peer;
+            }
+            if (peer == peers) {
+                ack_peers_[peers++] = senders_[i];
+                acks_[peer].batch = 0;
+            }
+            ++acks_[peer].batch;
+        }
+    }
+
+    if (accepted > 0) {
+        // Only the newest setpoint of the burst reaches the loop
+        last_accept_ns_ = now_ns;
+        echo_timestamp_ns_ = newest.timestamp_ns;
+        latest_.store(newest);
+
+        Setpoint setpoint;
+        setpoint.pan_angle = newest.angles[0];
+        setpoint.tilt_angle = newest.angles[1];
+        setpoint.timestamp_ns = now_ns;
+        if (newest.axis_count < 2) {
+            // Pan-only command: keep the current tilt target
+            Setpoint previous{};
+            if (mailbox_->version() != 0) {
+                mailbox_->load(previous);
+            }
+            setpoint.tilt_angle = previous.tilt_angle;
+        }
+        mailbox_->store(setpoint);
+        bump(published_, uint64_t{1});
+        stats_sequence_.store(last_sequence_, std::memory_order_relaxed);
+    }
+
+    bump(batches_, uint64_t{1});
+    bump(received_, received);
+    bump(accepted_, accepted);
+    bump(superseded_, accepted > 0 ? accepted - 1 : 0);
+    bump(stale_, stale);
+    bump(invalid_, invalid);
+
+    if (peers == 0) {
+        return;
+    }
+    for (size_t peer = 0; peer < peers; ++peer) {
+        fillAck(acks_[peer], acks_[peer].batch, now_ns);
+        ack_messages_[peer].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+    int sent = sendmmsg(fd_, ack_messages_, static_cast<unsigned int>(peers), MSG_DONTWAIT);
+    uint64_t delivered = sent > 0 ? static_cast<uint64_t>(sent) : 0;
+    bump(acks_sent_, delivered);
+    bump(ack_errors_, static_cast<uint64_t>(peers) - delivered);
+}
+
+void GimbalUdpServer::fillAck(GimbalUdpAck& ack, uint16_t batch, uint64_t now_ns) const {
+    ack = GimbalUdpAck{};
+    ack.magic = GimbalUdpAck::MAGIC;
+    ack.version = GIMBAL_UDP_VERSION;
+    ack.batch = batch;
+    ack.sequence = last_sequence_;
+    ack.echo_timestamp_ns = echo_timestamp_ns_;
+    ack.received = static_cast<uint32_t>(received_.load(std::memory_order_relaxed));
+    ack.stale = static_cast<uint32_t>(stale_.load(std::memory_order_relaxed));
+    ack.invalid = static_cast<uint32_t>(invalid_.load(std::memory_order_relaxed));
+
+    if (!telemetry_) {
+        return;
+    }
+    GimbalTelemetry state;
+    uint32_t version;
+    for (int attempt = 0; attempt < TELEMETRY_READ_ATTEMPTS; ++attempt) {
+        if (telemetry_->tryLoad(state, version)) {
+            if (version == 0) {
+                return;   // Nothing published yet
+            }
+            ack.flags |= GIMBAL_UDP_ACK_TELEMETRY;
+            ack.last_error = state.last_error;
+            ack.applied_age_us = state.applied_ns != 0 && now_ns > state.applied_ns
+                ? saturate32((now_ns - state.applied_ns) / 1000)
+                : 0;
+            ack.pan_angle = state.pan_angle;
+            ack.tilt_angle = state.tilt_angle;
+            ack.frames = state.frames;
+            return;
+        }
+    }
+}
+
+bool GimbalUdpServer::decode(const void* data, size_t size, GimbalUdpCommand& command) {
+    if (size != sizeof(GimbalUdpCommand)) {
+        return false;
+    }
+    std::memcpy(&command, data, sizeof(command));
+    if (command.magic != GimbalUdpCommand::MAGIC || command.version != GIMBAL_UDP_VERSION ||
+        command.axis_count == 0 || command.axis_count > GIMBAL_UDP_MAX_AXES) {
+        return false;
+    }
+    for (uint8_t axis = 0; axis < command.axis_count; ++axis) {
+        if (!std::isfinite(command.angles[axis])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GimbalUdpServer::start() {
+    if (running_.load()) {
+        return true;
+    }
+    if (fd_ < 0) {
+        return false;
+    }
+    running_.store(true);
+    thread_ = std::thread(&GimbalUdpServer::run, this);
+    return true;
+}
+
+void GimbalUdpServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void GimbalUdpServer::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (poll(THREAD_POLL_MS) < 0) {
+            // Socket failure: back off instead of spinning on it
+            struct timespec pause = {0, THREAD_POLL_MS * 1000000L};
+            nanosleep(&pause, nullptr);
+        }
+    }
+}
+
+bool GimbalUdpServer::getLatest(GimbalUdpCommand& command) const {
+    if (latest_.version() == 0) {
+        return false;
+    }
+    latest_.load(command);
+    return true;
+}
+
+GimbalUdpStats GimbalUdpServer::getStats() const {
+    GimbalUdpStats stats;
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.received = received_.load(std::memory_order_relaxed);
+    stats.accepted = accepted_.load(std::memory_order_relaxed);
+    stats.superseded = superseded_.load(std::memory_order_relaxed);
+    stats.stale = stale_.load(std::memory_order_relaxed);
+    stats.invalid = invalid_.load(std::memory_order_relaxed);
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.acks_sent = acks_sent_.load(std::memory_order_relaxed);
+    stats.ack_errors = ack_errors_.load(std::memory_order_relaxed);
+    stats.last_sequence = stats_sequence_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+GimbalUdpClient::GimbalUdpClient() : fd_(-1), next_sequence_(0), reset_sent_(false) {}
+
+GimbalUdpClient::~GimbalUdpClient() {
+    close();
+}
+
+GimbalStatus GimbalUdpClient::open(const char* host, uint16_t port) {
+    close();
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (!host || inet_pton(AF_INET, host, &address.sin_addr) != 1) {
+        return GimbalStatus(GimbalError::InvalidArgument);
+    }
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, errno);
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        int error = errno;
+        ::close(fd);
+        return GimbalStatus(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, error);
+    }
+    fd_ = fd;
+    reset_sent_ = false;
+    return GimbalStatus::success();
+}
+
+void GimbalUdpClient::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void GimbalUdpClient::prepare(GimbalUdpCommand& command, const float* angles, uint8_t axis_count, uint8_t flags) {
+    command = GimbalUdpCommand{};
+    command.magic = GimbalUdpCommand::MAGIC;
+    command.version = GIMBAL_UDP_VERSION;
+    command.flags = flags;
+    if (!reset_sent_) {
+        command.flags |= GIMBAL_UDP_FLAG_RESET;
+        reset_sent_ = true;
+    }
+    command.axis_count = axis_count < GIMBAL_UDP_MAX_AXES ? axis_count : GIMBAL_UDP_MAX_AXES;
+    command.sequence = next_sequence_++;
+    command.timestamp_ns = now();
+    for (uint8_t axis = 0; axis < command.axis_count; ++axis) {
+        command.angles[axis] = angles[axis];
+    }
+}
+
+bool GimbalUdpClient::setTarget(float pan_angle, float tilt_angle, uint8_t flags) {
+    const float angles[2] = {pan_angle, tilt_angle};
+    GimbalUdpCommand command;
+    prepare(command, angles, 2, flags);
+    return sendBatch(&command, 1) == 1;
+}
+
+int GimbalUdpClient::sendBatch(const GimbalUdpCommand* commands, size_t count) {
+    if (fd_ < 0) {
+        return -1;
+    }
+    mmsghdr messages[GIMBAL_UDP_BATCH];
+    iovec vectors[GIMBAL_UDP_BATCH];
+    size_t sent = 0;
+    while (sent < count) {
+        size_t chunk = count - sent < GIMBAL_UDP_BATCH ? count - sent : GIMBAL_UDP_BATCH;
+        for (size_t i = 0; i < chunk; ++i) {
+            vectors[i].iov_base = const_cast<GimbalUdpCommand*>(&commands[sent + i]);
+            vectors[i].iov_len = sizeof(GimbalUdpCommand);
+            messages[i].msg_hdr = msghdr{};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int result = sendmmsg(fd_, messages, static_cast<unsigned int>(chunk), 0);
+        if (result <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return sent > 0 || count == 0 ? static_cast<int>(sent) : -1;
+}
+
+int GimbalUdpClient::receiveAcks(GimbalUdpAck* acks, size_t max, int timeout_ms) {
+    if (fd_ < 0) {
+        return -1;
+    }
+    if (timeout_ms != 0) {
+        pollfd descriptor{fd_, POLLIN, 0};
+        int ready = ::poll(&descriptor, 1, timeout_ms);
+        if (ready <= 0) {
+            return ready < 0 && errno != EINTR ? -1 : 0;
+        }
+    }
+
+    mmsghdr messages[GIMBAL_UDP_BATCH];
+    iovec vectors[GIMBAL_UDP_BATCH];
+    size_t stored = 0;
+    while (stored < max) {
+        size_t chunk = max - stored < GIMBAL_UDP_BATCH ? max - stored : GIMBAL_UDP_BATCH;
+        for (size_t i = 0; i < chunk; ++i) {
+            vectors[i].iov_base = &acks[stored + i];
+            vectors[i].iov_len = sizeof(GimbalUdpAck);
+            messages[i].msg_hdr = msghdr{};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int count = recvmmsg(fd_, messages, static_cast<unsigned int>(chunk), MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            break;
+        }
+        // Compact: keep only well-formed acks
+        size_t valid = stored;
+        for (int i = 0; i < count; ++i) {
+            const GimbalUdpAck& ack = acks[stored + static_cast<size_t>(i)];
+            if (messages[i].msg_len == sizeof(GimbalUdpAck) && !(messages[i].msg_hdr.msg_flags & MSG_TRUNC) &&
+                ack.magic == GimbalUdpAck::MAGIC && ack.version == GIMBAL_UDP_VERSION) {
+                if (valid != stored + static_cast<size_t>(i)) {
+                    acks[valid] = ack;
+                }
+                ++valid;
+            }
+        }
+        stored = valid;
+        if (static_cast<size_t>(count) < chunk) {
+            break;
+        }
+    }
+    return static_cast<int>(stored);
+}
+
+uint64_t GimbalUdpClient::now() {
+    return monotonicNanos();
+}
@@ -0,0 +1,171 @@
+#include "ImuSource.h"
+#include "GimbalLog.h"
+#include <cstring>
+
+#ifdef PICO_BUILD
+#include "pico/time.h"
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'G', 'I', 'M', 'U'};
+
+} // namespace
+
+ImuReplaySource::ImuReplaySource()
+    : samples_(nullptr), count_(0), duration_ns_(0), cursor_(0), start_ns_(0), mapping_(nullptr), mapping_size_(0) {
+}
+
+ImuReplaySource::~ImuReplaySource() {
+    close();
+}
+
+bool ImuReplaySource::attach(const void* data, size_t size) {
+    close();
+
+    if (!data || size < sizeof(ImuReplayHeader) || reinterpret_cast<uintptr_t>(data) % alignof(ImuSample) != 0) {
+        return false;
+    }
+    const ImuReplayHeader* header = static_cast<const ImuReplayHeader*>(data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->record_size != sizeof(ImuSample) || header->count == 0) {
+        GIMBAL_LOG_ERROR("IMU replay: not a version %u replay image", static_cast<unsigned>(VERSION));
+        return false;
+    }
+    if (header->count > (size - sizeof(ImuReplayHeader)) / sizeof(ImuSample)) {
+        GIMBAL_LOG_ERROR("IMU replay: truncated (%llu samples declared)",
+                         static_cast<unsigned long long>(header->count));
+        return false;
+    }
+
+    samples_ = reinterpret_cast<const ImuSample*>(header + 1);
+    count_ = static_cast<size_t>(header->count);
+    duration_ns_ = header->duration_ns;
+    return true;
+}
+
+void ImuReplaySource::close() {
+#ifndef PICO_BUILD
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+#endif
+    samples_ = nullptr;
+    count_ = 0;
+    duration_ns_ = 0;
+    cursor_ = 0;
+    start_ns_ = 0;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+}
+
+void ImuReplaySource::start(uint64_t now_ns) {
+    cursor_ = 0;
+    start_ns_ = now_ns;
+}
+
+size_t ImuReplaySource::read(ImuSample* samples, size_t max) {
+    return readUntil(samples, max, now());
+}
+
+size_t ImuReplaySource::readUntil(ImuSample* samples, size_t max, uint64_t now_ns) {
+    if (!samples_ || now_ns < start_ns_) {
+        return 0;
+    }
+    const uint64_t first_ns = samples_[0].timestamp_ns;
+    const uint64_t due_ns = first_ns + (now_ns - start_ns_);
+    size_t count = 0;
+    while (count < max && cursor_ < count_ && samples_[cursor_].timestamp_ns <= due_ns) {
+        samples[count] = samples_[cursor_];
+        samples[count].timestamp_ns = samples_[cursor_].timestamp_ns - first_ns + start_ns_;
+        ++cursor_;
+        ++count;
+    }
+    return count;
+}
+
+uint64_t ImuReplaySource::now() {
+#ifdef PICO_BUILD
+    return time_us_64() * 1000;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+#ifndef PICO_BUILD
+bool ImuReplaySource::open(const char* path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        GIMBAL_LOG_ERROR("IMU replay: cannot open %s", path);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ImuReplayHeader))) {
+        GIMBAL_LOG_ERROR("IMU replay: %s is too small", path);
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        GIMBAL_LOG_ERROR("IMU replay: cannot map %s", path);
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    if (!attach(mapping, size)) {
+        munmap(mapping, size);
+        return false;
+    }
+    mapping_ = mapping;
+    mapping_size_ = size;
+    GIMBAL_LOG_INFO("IMU replay: mapped %s (%llu samples, %.3f s)", path,
+                    static_cast<unsigned long long>(count_), static_cast<double>(duration_ns_) / 1e9);
+    return true;
+}
+
+bool ImuReplaySource::write(const char* path, const ImuSample* samples, size_t count) {
+    if (!samples || count == 0) {
+        return false;
+    }
+    for (size_t i = 1; i < count; ++i) {
+        if (samples[i].timestamp_ns < samples[i - 1].timestamp_ns) {
+            GIMBAL_LOG_ERROR("IMU replay: sample %u goes back in time", static_cast<unsigned>(i));
+            return false;
+        }
+    }
+
+    ImuReplayHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.record_size = sizeof(ImuSample);
+    header.count = count;
+    header.duration_ns = samples[count - 1].timestamp_ns - samples[0].timestamp_ns;
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        GIMBAL_LOG_ERROR("IMU replay: cannot create %s", path);
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(samples, sizeof(ImuSample), count, file) == count;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        GIMBAL_LOG_ERROR("IMU replay: failed to write %s", path);
+    }
+    return ok;
+}
+#endif
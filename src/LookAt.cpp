@@ -0,0 +1,238 @@
+#include "LookAt.h"
+#include "Gimbal.h"
+#include <cmath>
+#include <limits>
+
+// Built with -fno-math-errno -fno-trapping-math (see CMakeLists.txt): without
+// them GCC keeps sqrt() and the selects below as branches and does not
+// vectorize the batch loops. Neither flag changes a finite result.
+
+namespace {
+
+constexpr float DEG_TO_RAD = 0.017453292f;
+constexpr float RAD_TO_DEG = 57.29578f;
+constexpr float HALF_PI = 1.57079637f;
+constexpr float PI = 3.14159274f;
+
+/// Costs computed per pass of selectTarget() when the caller keeps none
+constexpr size_t COST_CHUNK = 64;
+
+/**
+ * atan2 from a minimax polynomial of atan on [0, 1] (max error 2e-6 rad),
+ * folded into the other octants with selects. Branch-free, so loops
+ * calling it vectorize.
+ */
+inline float approxAtan2(float y, float x) {
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float big = ax > ay ? ax : ay;
+    const float small = ax > ay ? ay : ax;
+    const float a = small / (big > 1e-30f ? big : 1e-30f);
+    const float s = a * a;
+    float r = (((((-0.01172120f * s + 0.05265332f) * s - 0.11643287f) * s + 0.19354346f) * s - 0.33262347f) * s +
+               0.99997726f) * a;
+    r = ay > ax ? HALF_PI - r : r;
+    r = x < 0.0f ? PI - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+inline bool inRange(float angle) {
+    return angle >= Gimbal::Core::MIN_ANGLE && angle <= Gimbal::Core::MAX_ANGLE;
+}
+
+/// Clamp to the servo range; false if the angle was outside it (or NaN)
+bool clampAngle(float& angle) {
+    if (inRange(angle)) {
+        return true;
+    }
+    angle = angle > Gimbal::Core::MAX_ANGLE ? Gimbal::Core::MAX_ANGLE : Gimbal::Core::MIN_ANGLE;
+    return false;
+}
+
+} // namespace
+
+CameraIntrinsics CameraIntrinsics::fromFieldOfView(uint32_t width, uint32_t height, float horizontal_fov_deg) {
+    CameraIntrinsics camera;
+    camera.fx = 0.5f * static_cast<float>(width) / std::tan(0.5f * horizontal_fov_deg * DEG_TO_RAD);
+    camera.fy = camera.fx;
+    camera.cx = 0.5f * static_cast<float>(width);
+    camera.cy = 0.5f * static_cast<float>(height);
+    return camera;
+}
+
+LookAt::LookAt(const LookAtConfig& config) {
+    configure(config);
+}
+
+void LookAt::configure(const LookAtConfig& config) {
+    config_ = config;
+    const GimbalKinematics& k = config_.kinematics;
+    inv_fx_ = 1.0f / config_.camera.fx;
+    inv_fy_ = 1.0f / config_.camera.fy;
+
+    // Base -> reference is yaw (about z), then pitch (nose up), then roll
+    // (about x); its transpose takes reference vectors into the base frame
+    const double yaw = k.mount_yaw * DEG_TO_RAD;
+    const double pitch = k.mount_pitch * DEG_TO_RAD;
+    const double roll = k.mount_roll * DEG_TO_RAD;
+    const double c_yaw = std::cos(yaw), s_yaw = std::sin(yaw);
+    const double c_pitch = std::cos(pitch), s_pitch = std::sin(pitch);
+    const double c_roll = std::cos(roll), s_roll = std::sin(roll);
+    const double to_reference[9] = {
+        c_yaw * c_pitch, -s_yaw * c_roll - c_yaw * s_pitch * s_roll, s_yaw * s_roll - c_yaw * s_pitch * c_roll,
+        s_yaw * c_pitch, c_yaw * c_roll - s_yaw * s_pitch * s_roll,  -c_yaw * s_roll - s_yaw * s_pitch * c_roll,
+        s_pitch,         c_pitch * s_roll,                           c_pitch * c_roll,
+    };
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            to_base_[row * 3 + col] = static_cast<float>(to_reference[col * 3 + row]);
+        }
+    }
+
+    lateral_ = k.tilt_offset[1] + k.camera_offset[1];
+    inv_pan_speed_ = config_.pan_speed_dps > 0.0f ? 1.0f / config_.pan_speed_dps : 0.0f;
+    inv_tilt_speed_ = config_.tilt_speed_dps > 0.0f ? 1.0f / config_.tilt_speed_dps : 0.0f;
+}
+
+void LookAt::pixelsToAngles(const float* u, const float* v, size_t count, float pan_now, float tilt_now, float* pan,
+                            float* tilt) const {
+    const GimbalKinematics& k = config_.kinematics;
+    const float tilt_rad = (tilt_now - k.tilt_trim) * DEG_TO_RAD;
+    const float ct = std::cos(tilt_rad);
+    const float st = std::sin(tilt_rad);
+    const float cx = config_.camera.cx;
+    const float cy = config_.camera.cy;
+
+    for (size_t i = 0; i < count; ++i) {
+        // Ray through the pixel in the camera frame (x along the optical axis), tilted
+        const float left = (cx - u[i]) * inv_fx_;
+        const float up = (cy - v[i]) * inv_fy_;
+        const float x = ct - st * up;
+        const float z = st + ct * up;
+        pan[i] = pan_now + approxAtan2(left, x) * RAD_TO_DEG;
+        tilt[i] = approxAtan2(z, std::sqrt(x * x + left * left)) * RAD_TO_DEG + k.tilt_trim;
+    }
+}
+
+void LookAt::pointsToAngles(const float* x, const float* y, const float* z, size_t count, float* pan,
+                            float* tilt) const {
+    const GimbalKinematics& k = config_.kinematics;
+    // Locals, so stores to pan/tilt cannot alias the geometry
+    float m[9];
+    for (int j = 0; j < 9; ++j) {
+        m[j] = to_base_[j];
+    }
+    const float ox = k.mount_position[0];
+    const float oy = k.mount_position[1];
+    const float oz = k.mount_position[2];
+    const float lateral_sq = lateral_ * lateral_;
+    const float tx = k.tilt_offset[0];
+    const float tz = k.tilt_offset[2];
+    const float height = k.camera_offset[2];
+    const float height_sq = height * height;
+    const float lateral = lateral_;
+    const float pan_trim = k.pan_trim;
+    const float tilt_trim = k.tilt_trim;
+
+    for (size_t i = 0; i < count; ++i) {
+        const float rx = x[i] - ox;
+        const float ry = y[i] - oy;
+        const float rz = z[i] - oz;
+        const float px = m[0] * rx + m[1] * ry + m[2] * rz;
+        const float py = m[3] * rx + m[4] * ry + m[5] * rz;
+        const float pz = m[6] * rx + m[7] * ry + m[8] * rz;
+
+        // Pan: the optical axis runs at `lateral_` from the panned x-z plane,
+        // so pan = bearing - asin(lateral / range); forward = range along that plane
+        const float forward = std::sqrt(px * px + py * py - lateral_sq);
+        const float pan_rad = approxAtan2(py, px) - approxAtan2(lateral, forward);
+
+        // Tilt: same construction in the panned x-z plane around the tilt axis
+        const float dx = forward - tx;
+        const float dz = pz - tz;
+        const float along = std::sqrt(dx * dx + dz * dz - height_sq);
+        const float tilt_rad = approxAtan2(dz, dx) - approxAtan2(height, along);
+
+        pan[i] = pan_rad * RAD_TO_DEG + pan_trim;
+        tilt[i] = tilt_rad * RAD_TO_DEG + tilt_trim;
+    }
+}
+
+bool LookAt::pixelToAngles(float u, float v, float pan_now, float tilt_now, float& pan, float& tilt) const {
+    const GimbalKinematics& k = config_.kinematics;
+    const float tilt_rad = (tilt_now - k.tilt_trim) * DEG_TO_RAD;
+    const float left = (config_.camera.cx - u) * inv_fx_;
+    const float up = (config_.camera.cy - v) * inv_fy_;
+    const float x = std::cos(tilt_rad) - std::sin(tilt_rad) * up;
+    const float z = std::sin(tilt_rad) + std::cos(tilt_rad) * up;
+    pan = pan_now + std::atan2(left, x) * RAD_TO_DEG;
+    tilt = std::atan2(z, std::sqrt(x * x + left * left)) * RAD_TO_DEG + k.tilt_trim;
+    bool pan_ok = clampAngle(pan);
+    bool tilt_ok = clampAngle(tilt);
+    return pan_ok && tilt_ok;
+}
+
+bool LookAt::pointToAngles(float x, float y, float z, float& pan, float& tilt) const {
+    const GimbalKinematics& k = config_.kinematics;
+    const float* m = to_base_;
+    const float rx = x - k.mount_position[0];
+    const float ry = y - k.mount_position[1];
+    const float rz = z - k.mount_position[2];
+    const float px = m[0] * rx + m[1] * ry + m[2] * rz;
+    const float py = m[3] * rx + m[4] * ry + m[5] * rz;
+    const float pz = m[6] * rx + m[7] * ry + m[8] * rz;
+
+    // No solution when the point is closer to an axis than the optical axis is
+    const float forward_sq = px * px + py * py - lateral_ * lateral_;
+    const float forward = std::sqrt(forward_sq > 0.0f ? forward_sq : 0.0f);
+    const float dx = forward - k.tilt_offset[0];
+    const float dz = pz - k.tilt_offset[2];
+    const float height = k.camera_offset[2];
+    const float along_sq = dx * dx + dz * dz - height * height;
+    if (!(forward_sq > 0.0f) || !(along_sq > 0.0f)) {
+        pan = k.pan_trim;
+        tilt = k.tilt_trim;
+        clampAngle(pan);
+        clampAngle(tilt);
+        return false;
+    }
+    pan = (std::atan2(py, px) - std::atan2(lateral_, forward)) * RAD_TO_DEG + k.pan_trim;
+    tilt = (std::atan2(dz, dx) - std::atan2(height, std::sqrt(along_sq))) * RAD_TO_DEG + k.tilt_trim;
+    bool pan_ok = clampAngle(pan);
+    bool tilt_ok = clampAngle(tilt);
+    return pan_ok && tilt_ok;
+}
+
+void LookAt::slewCosts(const float* pan, const float* tilt, size_t count, float pan_now, float tilt_now,
+                       float* seconds) const {
+    const float unreachable = std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        const float pan_time = std::fabs(pan[i] - pan_now) * inv_pan_speed_;
+        const float tilt_time = std::fabs(tilt[i] - tilt_now) * inv_tilt_speed_;
+        const float time = pan_time > tilt_time ? pan_time : tilt_time;
+        seconds[i] = inRange(pan[i]) && inRange(tilt[i]) ? time : unreachable;
+    }
+}
+
+size_t LookAt::selectTarget(const float* pan, const float* tilt, const float* bias, size_t count, float pan_now,
+                            float tilt_now, float* seconds) const {
+    float chunk[COST_CHUNK];
+    size_t best = NO_TARGET;
+    float best_cost = std::numeric_limits<float>::infinity();
+    for (size_t start = 0; start < count; start += COST_CHUNK) {
+        const size_t n = count - start < COST_CHUNK ? count - start : COST_CHUNK;
+        float* costs = seconds ? seconds + start : chunk;
+        slewCosts(pan + start, tilt + start, n, pan_now, tilt_now, costs);
+        for (size_t i = 0; i < n; ++i) {
+            if (bias) {
+                costs[i] += bias[start + i];
+            }
+            // Infinite and NaN costs never compare lower
+            if (costs[i] < best_cost) {
+                best_cost = costs[i];
+                best = start + i;
+            }
+        }
+    }
+    return best;
+}
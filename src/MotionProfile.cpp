@@ -0,0 +1,323 @@
+#include "MotionProfile.h"
+#include <cmath>
+
+namespace {
+
+/// Bisection steps on the cruise velocity (float resolution after ~24)
+constexpr int BISECTION_STEPS = 32;
+
+/**
+ * Tighten a normalized (path-space) limit with one axis' limit.
+ * 0 means unlimited on both input and output.
+ */
+float pathLimit(float current, float axis_limit, float distance) {
+    if (axis_limit <= 0.0f || distance <= 0.0f) {
+        return current;
+    }
+    float limit = axis_limit / distance;
+    return (current <= 0.0f || limit < current) ? limit : current;
+}
+
+/// Constant-jerk piece; acceleration is its initial value
+struct Piece {
+    float duration;
+    float acceleration;
+    float jerk;
+};
+
+/**
+ * Move shape of one axis: velocity change to the cruise velocity (pieces
+ * 0-2), cruise (3), velocity change to rest (4-6)
+ */
+struct Shape {
+    Piece pieces[7];
+    float cruise_velocity;
+};
+
+/**
+ * Take velocity v0 and acceleration a0 to velocity v1 at zero acceleration
+ * in the least time: ramp the acceleration towards the limit, hold it,
+ * ramp it back to zero. Limits of 0 are unlimited (the acceleration or the
+ * velocity steps).
+ */
+void velocityChange(float v0, float a0, float v1, float max_acceleration, float max_jerk, Piece pieces[3]) {
+    for (int i = 0; i < 3; ++i) {
+        pieces[i] = Piece{0.0f, 0.0f, 0.0f};
+    }
+    if (max_acceleration <= 0.0f) {
+        return;
+    }
+    if (max_jerk <= 0.0f) {
+        pieces[1] = Piece{std::fabs(v1 - v0) / max_acceleration, v1 >= v0 ? max_acceleration : -max_acceleration, 0.0f};
+        return;
+    }
+
+    // Work in the direction of the change: ramping a0 straight back to zero
+    // ends at v_stop, so the acceleration must swing towards v1 from there
+    const float j = max_jerk;
+    const float v_stop = v0 + 0.5f * a0 * std::fabs(a0) / j;
+    const float dir = v1 >= v_stop ? 1.0f : -1.0f;
+    const float a_start = dir * a0;
+    const float dv = dir * (v1 - v0);
+
+    // Peak without a hold: ramps alone cover dv
+    float peak_sq = j * dv + 0.5f * a_start * a_start;
+    float peak = std::sqrt(peak_sq > 0.0f ? peak_sq : 0.0f);
+    float hold = 0.0f;
+    if (peak > max_acceleration) {
+        peak = max_acceleration;
+        float ramps = 0.5f * (peak + a_start) * std::fabs(peak - a_start) / j + 0.5f * peak * peak / j;
+        hold = (dv - ramps) / peak;
+        hold = hold > 0.0f ? hold : 0.0f;
+    }
+    pieces[0] = Piece{std::fabs(peak - a_start) / j, a0, peak >= a_start ? dir * j : -dir * j};
+    pieces[1] = Piece{hold, dir * peak, 0.0f};
+    pieces[2] = Piece{peak / j, dir * peak, -dir * j};
+}
+
+/// Advance position and velocity over count pieces
+void integrate(const Piece* pieces, int count, float& position, float& velocity) {
+    for (int i = 0; i < count; ++i) {
+        const float d = pieces[i].duration;
+        const float a = pieces[i].acceleration;
+        const float j = pieces[i].jerk;
+        position += d * (velocity + d * (0.5f * a + d * j / 6.0f));
+        velocity += d * (a + 0.5f * d * j);
+    }
+}
+
+/// Shape through a cruise at cruise_velocity with no cruise time; returns the distance covered
+float buildShape(Shape& shape, float v0, float a0, float cruise_velocity, const AxisLimits& limits) {
+    velocityChange(v0, a0, cruise_velocity, limits.max_acceleration, limits.max_jerk, shape.pieces);
+    shape.pieces[3] = Piece{0.0f, 0.0f, 0.0f};
+    velocityChange(cruise_velocity, 0.0f, 0.0f, limits.max_acceleration, limits.max_jerk, shape.pieces + 4);
+    shape.cruise_velocity = cruise_velocity;
+
+    float position = 0.0f;
+    float velocity = v0;
+    integrate(shape.pieces, 3, position, velocity);
+    velocity = cruise_velocity;
+    integrate(shape.pieces + 4, 3, position, velocity);
+    return position;
+}
+
+float shapeDuration(const Shape& shape) {
+    float duration = 0.0f;
+    for (const Piece& piece : shape.pieces) {
+        duration += piece.duration;
+    }
+    return duration;
+}
+
+} // namespace
+
+MotionProfile::MotionProfile()
+    : pan_limits_{0.0f, 0.0f, 0.0f},
+      tilt_limits_{0.0f, 0.0f, 0.0f},
+      pan_{},
+      tilt_{},
+      start_us_(0) {
+}
+
+void MotionProfile::setLimits(const AxisLimits& pan, const AxisLimits& tilt) {
+    pan_limits_ = pan;
+    tilt_limits_ = tilt;
+}
+
+bool MotionProfile::isLimited() const {
+    return pan_limits_.max_velocity > 0.0f || tilt_limits_.max_velocity > 0.0f;
+}
+
+void MotionProfile::reset(float pan_angle, float tilt_angle) {
+    pan_.target = pan_angle;
+    pan_.duration = 0.0f;
+    tilt_.target = tilt_angle;
+    tilt_.duration = 0.0f;
+}
+
+void MotionProfile::setTarget(float pan_angle, float tilt_angle, uint64_t now_us) {
+    const AxisState pan_now = stateAt(pan_, now_us);
+    const AxisState tilt_now = stateAt(tilt_, now_us);
+    start_us_ = now_us;
+
+    const float pan_distance = std::fabs(pan_angle - pan_now.position);
+    const float tilt_distance = std::fabs(tilt_angle - tilt_now.position);
+
+    // Scale each axis' limits into path space (s per second^n) and keep the
+    // tightest: the slowest axis sets the pace, so both arrive together
+    float velocity = pathLimit(0.0f, pan_limits_.max_velocity, pan_distance);
+    velocity = pathLimit(velocity, tilt_limits_.max_velocity, tilt_distance);
+    float acceleration = pathLimit(0.0f, pan_limits_.max_acceleration, pan_distance);
+    acceleration = pathLimit(acceleration, tilt_limits_.max_acceleration, tilt_distance);
+    float jerk = pathLimit(0.0f, pan_limits_.max_jerk, pan_distance);
+    jerk = pathLimit(jerk, tilt_limits_.max_jerk, tilt_distance);
+
+    AxisLimits pan_path = {velocity * pan_distance, acceleration * pan_distance, jerk * pan_distance};
+    AxisLimits tilt_path = {velocity * tilt_distance, acceleration * tilt_distance, jerk * tilt_distance};
+
+    const bool at_rest = pan_now.velocity == 0.0f && pan_now.acceleration == 0.0f && tilt_now.velocity == 0.0f &&
+                         tilt_now.acceleration == 0.0f;
+    if (at_rest) {
+        // Path-scaled limits give both axes the same normalized profile,
+        // so the move runs on the straight line
+        plan(pan_, pan_now, pan_angle, pan_path);
+        plan(tilt_, tilt_now, tilt_angle, tilt_path);
+        return;
+    }
+
+    // In motion the axes start from different states: each keeps its own
+    // limits (an unlimited axis follows the path pace), then the one that
+    // would arrive first is slowed down to the other's arrival
+    AxisLimits pan_own = pan_limits_;
+    if (pan_own.max_velocity <= 0.0f) {
+        pan_own = pan_path;
+    }
+    AxisLimits tilt_own = tilt_limits_;
+    if (tilt_own.max_velocity <= 0.0f) {
+        tilt_own = tilt_path;
+    }
+    plan(pan_, pan_now, pan_angle, pan_own);
+    plan(tilt_, tilt_now, tilt_angle, tilt_own);
+    if (pan_.duration < tilt_.duration) {
+        stretch(pan_, pan_now, pan_own, tilt_.duration);
+    } else if (tilt_.duration < pan_.duration) {
+        stretch(tilt_, tilt_now, tilt_own, pan_.duration);
+    }
+}
+
+void MotionProfile::plan(AxisPlan& plan, const AxisState& from, float target, const AxisLimits& limits) {
+    plan.target = target;
+    plan.duration = 0.0f;
+    const float distance = target - from.position;
+    const float v_max = limits.max_velocity;
+    if (v_max <= 0.0f || (distance == 0.0f && from.velocity == 0.0f && from.acceleration == 0.0f)) {
+        // Unlimited, or nothing to do: step
+        return;
+    }
+
+    // Cruise at full speed if even the fastest shape falls short of the
+    // target (either direction); otherwise find the peak velocity whose
+    // shape ends on it. The distance grows with the cruise velocity.
+    Shape shape;
+    float cruise_time = 0.0f;
+    const float forward = buildShape(shape, from.velocity, from.acceleration, v_max, limits);
+    const float backward = buildShape(shape, from.velocity, from.acceleration, -v_max, limits);
+    float cruise_velocity;
+    if (distance >= forward) {
+        cruise_velocity = v_max;
+        cruise_time = (distance - forward) / v_max;
+    } else if (distance <= backward) {
+        cruise_velocity = -v_max;
+        cruise_time = (backward - distance) / v_max;
+    } else {
+        float low = -v_max;
+        float high = v_max;
+        for (int i = 0; i < BISECTION_STEPS; ++i) {
+            float mid = 0.5f * (low + high);
+            if (buildShape(shape, from.velocity, from.acceleration, mid, limits) < distance) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        cruise_velocity = 0.5f * (low + high);
+    }
+    build(plan, from, limits, cruise_velocity, cruise_time);
+}
+
+void MotionProfile::stretch(AxisPlan& plan, const AxisState& from, const AxisLimits& limits, float duration) {
+    if (plan.duration <= 0.0f || plan.cruise_velocity == 0.0f) {
+        return;
+    }
+    // Lower the cruise speed (same direction) until the move takes the
+    // requested duration; a slower cruise always takes longer, but below
+    // some speed the shape may no longer fit in the distance
+    const float distance = plan.target - from.position;
+    const float dir = plan.cruise_velocity > 0.0f ? 1.0f : -1.0f;
+    Shape shape;
+    float low = 0.0f;
+    float high = std::fabs(plan.cruise_velocity);
+    float low_cruise_time = 0.0f;
+    for (int i = 0; i < BISECTION_STEPS; ++i) {
+        float mid = 0.5f * (low + high);
+        float cruise_time = (distance - buildShape(shape, from.velocity, from.acceleration, dir * mid, limits)) /
+                            (dir * mid);
+        if (cruise_time >= 0.0f && shapeDuration(shape) + cruise_time >= duration) {
+            low = mid;
+            low_cruise_time = cruise_time;
+        } else {
+            high = mid;
+        }
+    }
+    if (low <= 0.0f) {
+        return;  // Cannot be slowed down enough: arrive first
+    }
+
+    build(plan, from, limits, dir * low, low_cruise_time);
+}
+
+void MotionProfile::build(AxisPlan& plan, const AxisState& from, const AxisLimits& limits, float cruise_velocity,
+                          float cruise_time) {
+    Shape shape;
+    buildShape(shape, from.velocity, from.acceleration, cruise_velocity, limits);
+    shape.pieces[3].duration = cruise_time;
+
+    float t = 0.0f;
+    float p = from.position;
+    float v = from.velocity;
+    for (int i = 0; i < SEGMENTS; ++i) {
+        const Piece& piece = shape.pieces[i];
+        if (i == 3) {
+            v = cruise_velocity;  // Cruise starts exactly at the cruise velocity
+        }
+        plan.segments[i] = Segment{t, p, v, piece.acceleration, piece.jerk};
+        integrate(&piece, 1, p, v);
+        t += piece.duration;
+    }
+    plan.duration = t;
+    plan.cruise_velocity = cruise_velocity;
+}
+
+MotionProfile::AxisState MotionProfile::evaluate(const AxisPlan& plan, float t) {
+    if (plan.duration <= 0.0f || t >= plan.duration) {
+        return AxisState{plan.target, 0.0f, 0.0f};
+    }
+    if (t <= 0.0f) {
+        const Segment& first = plan.segments[0];
+        return AxisState{first.position, first.velocity, first.acceleration};
+    }
+
+    int i = SEGMENTS - 1;
+    while (i > 0 && t < plan.segments[i].start) {
+        --i;
+    }
+    const Segment& seg = plan.segments[i];
+    float dt = t - seg.start;
+    return AxisState{
+        seg.position + dt * (seg.velocity + dt * (0.5f * seg.acceleration + dt * seg.jerk / 6.0f)),
+        seg.velocity + dt * (seg.acceleration + 0.5f * dt * seg.jerk),
+        seg.acceleration + dt * seg.jerk,
+    };
+}
+
+MotionProfile::AxisState MotionProfile::stateAt(const AxisPlan& plan, uint64_t now_us) const {
+    float t = now_us < start_us_ ? 0.0f : static_cast<float>(now_us - start_us_) * 1e-6f;
+    return evaluate(plan, t);
+}
+
+void MotionProfile::sample(uint64_t now_us, float& pan_angle, float& tilt_angle) const {
+    pan_angle = stateAt(pan_, now_us).position;
+    tilt_angle = stateAt(tilt_, now_us).position;
+}
+
+uint64_t MotionProfile::getArrivalTime() const {
+    return start_us_ + static_cast<uint64_t>(getDuration() * 1e6f);
+}
+
+float MotionProfile::getDuration() const {
+    return pan_.duration > tilt_.duration ? pan_.duration : tilt_.duration;
+}
+
+bool MotionProfile::isSettled(uint64_t now_us) const {
+    return getDuration() <= 0.0f || now_us >= getArrivalTime();
+}
@@ -1,6 +1,5 @@
 #include "PWMControllerPico.h"
-#include <iostream>
-#include <cmath>
+#include "GimbalLog.h"
 
 // Platform-specific includes - only compile on Pico
 #ifdef PICO_BUILD
@@ -9,48 +8,124 @@
 #include "hardware/clocks.h"
 #endif
 
-PWMControllerPico::PWMControllerPico() : initialized_(false) {
+PWMControllerPico::PWMControllerPico() : initialized_(false), slices_{} {
+    for (auto& level : last_level_) {
+        level = -1;
+    }
+    for (auto& active : pin_active_) {
+        active = false;
+    }
 }
 
 PWMControllerPico::~PWMControllerPico() {
     // Cleanup handled by pico-sdk
 }
 
-bool PWMControllerPico::initPin(uint32_t pin, uint32_t frequency) {
+uint32_t PWMControllerPico::sliceOf(uint32_t pin) {
+#ifdef PICO_BUILD
+    return pwm_gpio_to_slice_num(pin);
+#else
+    return (pin >> 1) % MAX_SLICES;
+#endif
+}
+
+const PicoPWMConfig* PWMControllerPico::getSliceConfig(uint32_t pin) const {
+    if (pin >= MAX_PINS || !pin_active_[pin]) {
+        return nullptr;
+    }
+    return &slices_[sliceOf(pin)];
+}
+
+bool PWMControllerPico::configureSlice(uint32_t slice, uint32_t frequency) {
+    PicoPWMConfig& config = slices_[slice];
+    if (config.frequency == frequency) {
+        return true;
+    }
+
 #ifdef PICO_BUILD
-    // Initialize GPIO as PWM
-    gpio_set_function(pin, GPIO_FUNC_PWM);
-    
-    // Get PWM slice for this pin
-    uint slice_num = pwm_gpio_to_slice_num(pin);
-    
-    // Calculate clock divider for desired frequency
-    // Formula: PWM frequency = clock_speed / (wrap * divider)
-    // Default clock speed is 125 MHz
     uint32_t clock_speed = clock_get_hz(clk_sys);
-    float divider = (float)clock_speed / (frequency * 65536.0f);  // 65536 is max wrap value
-    
-    if (divider < 1.0f) {
-        divider = 1.0f;
+#else
+    uint32_t clock_speed = SIM_SYS_CLOCK_HZ;
+#endif
+    PicoPWMConfig solved;
+    if (!solvePicoPWMConfig(clock_speed, frequency, solved)) {
+        GIMBAL_LOG_ERROR("PWMControllerPico: %u Hz is out of range for slice %u",
+                         static_cast<unsigned>(frequency), static_cast<unsigned>(slice));
+        return false;
     }
-    
-    pwm_set_clkdiv(slice_num, divider);
-    pwm_set_wrap(slice_num, 65535);  // Full range for 16-bit resolution
-    pwm_set_enabled(slice_num, true);
-    
-    std::cout << "PWMControllerPico: Initialized pin " << pin 
-              << " with frequency " << frequency << " Hz" << std::endl;
+    config = solved;
+
+    // Levels written for the old counter rate are meaningless now
+    for (uint32_t pin = 0; pin < MAX_PINS; ++pin) {
+        if (sliceOf(pin) == slice) {
+            last_level_[pin] = -1;
+        }
+    }
+
+#ifdef PICO_BUILD
+    pwm_set_clkdiv_int_frac(slice, config.div_int, config.div_frac);
+    pwm_set_wrap(slice, config.wrap);
+    pwm_set_enabled(slice, true);
+#endif
+
+    GIMBAL_LOG_DEBUG("PWMControllerPico: Slice %u divider %u+%u/16, wrap %u (%.4f Hz)",
+                     static_cast<unsigned>(slice), static_cast<unsigned>(config.div_int),
+                     static_cast<unsigned>(config.div_frac), static_cast<unsigned>(config.wrap),
+                     static_cast<double>(config.actual_frequency));
+    return true;
+}
+
+GimbalStatus PWMControllerPico::initPin(uint32_t pin, uint32_t frequency) {
+    if (pin >= MAX_PINS) {
+        return fail(GimbalError::PinUnavailable, pin);
+    }
+    if (!isValidFrequency(frequency)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+
+    // The other channel of the slice keeps running at the configured rate
+    uint32_t slice = sliceOf(pin);
+    uint32_t sibling = pin ^ 1u;
+    if (sibling < MAX_PINS && pin_active_[sibling] && slices_[slice].frequency != frequency) {
+        GIMBAL_LOG_ERROR("PWMControllerPico: pin %u shares slice %u with pin %u at %u Hz",
+                         static_cast<unsigned>(pin), static_cast<unsigned>(slice),
+                         static_cast<unsigned>(sibling), static_cast<unsigned>(slices_[slice].frequency));
+        return fail(GimbalError::PinUnavailable, pin);
+    }
+    if (!configureSlice(slice, frequency)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+    last_level_[pin] = -1;
+    pin_active_[pin] = true;
+
+#ifdef PICO_BUILD
+    // Initialize GPIO as PWM
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+
+    GIMBAL_LOG_INFO("PWMControllerPico: Initialized pin %u with frequency %u Hz",
+                    static_cast<unsigned>(pin), static_cast<unsigned>(frequency));
 #else
     // Simulation mode
-    std::cout << "PWMControllerPico: Initialized pin " << pin 
-              << " with frequency " << frequency << " Hz (simulation)" << std::endl;
+    GIMBAL_LOG_INFO("PWMControllerPico: Initialized pin %u with frequency %u Hz (simulation)",
+                    static_cast<unsigned>(pin), static_cast<unsigned>(frequency));
 #endif
     
-    return true;
+    return GimbalStatus::success();
 }
 
-bool PWMControllerPico::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
-    uint16_t pwm_level = calculatePWMLevel(pulse_width_us, period_us);
+GimbalStatus PWMControllerPico::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    if (pin >= MAX_PINS || !pin_active_[pin]) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+
+    uint16_t pwm_level;
+    if (!calculatePWMLevel(pin, pulse_width_us, period_us, pwm_level)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+    if (last_level_[pin] == pwm_level) {
+        return GimbalStatus::success();
+    }
+    last_level_[pin] = pwm_level;
 
 #ifdef PICO_BUILD
     // Get PWM channel for this pin
@@ -60,41 +135,134 @@ bool PWMControllerPico::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uin
     // Set PWM level
     pwm_set_chan_level(slice_num, channel, pwm_level);
     
-    std::cout << "PWMControllerPico: Set pin " << pin << " level: " 
-              << pwm_level << "/65535 (pulse: " << pulse_width_us << " µs)" << std::endl;
+    GIMBAL_LOG_DEBUG("PWMControllerPico: Set pin %u level: %u/%u (pulse: %u µs)",
+                     static_cast<unsigned>(pin), static_cast<unsigned>(pwm_level),
+                     static_cast<unsigned>(slices_[slice_num].wrap), static_cast<unsigned>(pulse_width_us));
 #else
     // Simulation mode
-    std::cout << "PWMControllerPico: Set pin " << pin << " pulse width: " 
-              << pulse_width_us << " µs (level: " << pwm_level << "/65535) (simulation)" << std::endl;
+    GIMBAL_LOG_DEBUG("PWMControllerPico: Set pin %u pulse width: %u µs (level: %u/%u) (simulation)",
+                     static_cast<unsigned>(pin), static_cast<unsigned>(pulse_width_us),
+                     static_cast<unsigned>(pwm_level), static_cast<unsigned>(slices_[sliceOf(pin)].wrap));
 #endif
     
-    return true;
+    return GimbalStatus::success();
 }
 
-bool PWMControllerPico::shutdownPin(uint32_t pin) {
+GimbalStatus PWMControllerPico::setPulseWidths(const PulseCommand* commands, size_t count) {
+#ifdef PICO_BUILD
+    // Both channels of a slice share one compare (CC) register. Merge all
+    // updates per slice and store each register once, so channel A and B
+    // latch together at the next counter wrap.
+    uint32_t cc[NUM_PWM_SLICES];
+    uint32_t touched = 0;
+    GimbalStatus result;
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pin = commands[i].pin;
+        uint16_t pwm_level;
+        GimbalStatus status;
+        if (pin >= MAX_PINS || !pin_active_[pin]) {
+            status = fail(GimbalError::PinNotInitialized, pin);
+        } else if (!calculatePWMLevel(pin, commands[i].pulse_width_us, commands[i].period_us, pwm_level)) {
+            status = fail(GimbalError::InvalidArgument, pin);
+        }
+        if (!status) {
+            if (result) {
+                result = status;
+            }
+            continue;
+        }
+        if (last_level_[pin] == pwm_level) {
+            continue;
+        }
+        last_level_[pin] = pwm_level;
+
+        uint slice_num = pwm_gpio_to_slice_num(pin);
+        if (!(touched & (1u << slice_num))) {
+            cc[slice_num] = pwm_hw->slice[slice_num].cc;
+            touched |= 1u << slice_num;
+        }
+        if (pwm_gpio_to_channel(pin) == PWM_CHAN_A) {
+            cc[slice_num] = (cc[slice_num] & ~PWM_CH0_CC_A_BITS) |
+                            (static_cast<uint32_t>(pwm_level) << PWM_CH0_CC_A_LSB);
+        } else {
+            cc[slice_num] = (cc[slice_num] & ~PWM_CH0_CC_B_BITS) |
+                            (static_cast<uint32_t>(pwm_level) << PWM_CH0_CC_B_LSB);
+        }
+    }
+
+    for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; ++slice_num) {
+        if (touched & (1u << slice_num)) {
+            pwm_hw->slice[slice_num].cc = cc[slice_num];
+        }
+    }
+
+    return result;
+#else
+    return PWMController::setPulseWidths(commands, count);
+#endif
+}
+
+GimbalStatus PWMControllerPico::shutdownPin(uint32_t pin) {
+    if (pin >= MAX_PINS) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+    last_level_[pin] = -1;
+    pin_active_[pin] = false;
+
+    // Keep the slice running while its other channel is in use
+    uint32_t sibling = pin ^ 1u;
+    bool slice_in_use = sibling < MAX_PINS && pin_active_[sibling];
+    if (!slice_in_use) {
+        slices_[sliceOf(pin)].frequency = 0;
+    }
+
 #ifdef PICO_BUILD
     uint slice_num = pwm_gpio_to_slice_num(pin);
     uint channel = pwm_gpio_to_channel(pin);
     
     pwm_set_chan_level(slice_num, channel, 0);
-    pwm_set_enabled(slice_num, false);
+    if (!slice_in_use) {
+        pwm_set_enabled(slice_num, false);
+    }
     
-    std::cout << "PWMControllerPico: Shutdown pin " << pin << std::endl;
+    GIMBAL_LOG_INFO("PWMControllerPico: Shutdown pin %u", static_cast<unsigned>(pin));
 #else
     // Simulation mode
-    std::cout << "PWMControllerPico: Shutdown pin " << pin << " (simulation)" << std::endl;
+    GIMBAL_LOG_INFO("PWMControllerPico: Shutdown pin %u (simulation)", static_cast<unsigned>(pin));
 #endif
     
-    return true;
+    return GimbalStatus::success();
 }
 
-uint16_t PWMControllerPico::calculatePWMLevel(uint32_t pulse_width_us, uint32_t period_us) const {
-    // Convert pulse width to PWM level (0-65535)
-    // PWM level = (pulse_width / period) * 65535
-    if (period_us == 0) {
-        return 0;
+bool PWMControllerPico::calculatePWMLevel(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us,
+                                          uint16_t& level) {
+    if (!isValidFrame(pulse_width_us, period_us)) {
+        return false;
     }
-    
-    float ratio = (float)pulse_width_us / (float)period_us;
-    return static_cast<uint16_t>(ratio * 65535.0f);
+
+    // A different period reprograms the slice, which is shared by both its
+    // channels: refuse it while the other channel runs at the current rate
+    uint32_t slice = sliceOf(pin);
+    PicoPWMConfig& config = slices_[slice];
+    uint32_t frequency = (1000000u + period_us / 2) / period_us;
+    if (frequency != config.frequency) {
+        uint32_t sibling = pin ^ 1u;
+        if (sibling < MAX_PINS && pin_active_[sibling]) {
+            return false;
+        }
+        if (!configureSlice(slice, frequency)) {
+            return false;
+        }
+    }
+
+    // Convert with the slice's real counter rate: level = pulse * ticks/µs
+#ifdef GIMBAL_FIXED_POINT
+    // pulse < period and level <= 65536, so the product stays below 2^28
+    uint32_t counts = (pulse_width_us * config.counts_per_us_q12 + 2048u) >> 12;
+#else
+    uint32_t counts = static_cast<uint32_t>(static_cast<float>(pulse_width_us) * config.counts_per_us + 0.5f);
+#endif
+    level = static_cast<uint16_t>(counts > config.wrap ? config.wrap : counts);
+    return true;
 }
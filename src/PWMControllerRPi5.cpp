@@ -1,84 +1,131 @@
 #include "PWMControllerRPi5.h"
-#include <iostream>
+#include "GimbalLog.h"
 #include <lgpio.h>
 
-PWMControllerRPi5::PWMControllerRPi5() : chip_(-1) {}
+PWMControllerRPi5::PWMControllerRPi5() : chip_(-1), pins_{} {}
 
 PWMControllerRPi5::~PWMControllerRPi5() {
     shutdownLgpio();
 }
 
-bool PWMControllerRPi5::initLgpio() {
-    chip_ = lgGpiochipOpen(0);
-    if (chip_ < 0) {
-        std::cerr << "Failed to open gpiochip0" << std::endl;
-        return false;
+GimbalStatus PWMControllerRPi5::initLgpio() {
+    int handle = lgGpiochipOpen(0);
+    if (handle < 0) {
+        GIMBAL_LOG_ERROR("Failed to open gpiochip0 (%s)", lguErrorText(handle));
+        return fail(GimbalError::DeviceUnavailable, GimbalStatus::NO_PIN, handle);
     }
-    std::cout << "PWMControllerRPi5: gpiochip0 opened" << std::endl;
-    return true;
+    chip_ = handle;
+    GIMBAL_LOG_INFO("PWMControllerRPi5: gpiochip0 opened");
+    return GimbalStatus::success();
 }
 
 void PWMControllerRPi5::shutdownLgpio() {
-    for (auto pin : claimed_pins_) {
-        // Stop PWM and free pin
-        lgTxPwm(chip_, pin, 50.0f, 0.0f, 0, 0);
-        lgGpioFree(chip_, pin);
+    for (uint32_t pin = 0; pin < MAX_PINS; ++pin) {
+        if (pins_[pin].claimed) {
+            // Stop PWM and free pin
+            lgTxPwm(chip_, pin, 50.0f, 0.0f, 0, 0);
+            lgGpioFree(chip_, pin);
+        }
+        pins_[pin] = PinState{};
     }
-    claimed_pins_.clear();
-    pin_frequency_.clear();
     if (chip_ >= 0) {
         lgGpiochipClose(chip_);
         chip_ = -1;
     }
-    std::cout << "PWMControllerRPi5: gpiochip0 closed" << std::endl;
+    GIMBAL_LOG_INFO("PWMControllerRPi5: gpiochip0 closed");
 }
 
-bool PWMControllerRPi5::initPin(uint32_t pin, uint32_t frequency) {
+GimbalStatus PWMControllerRPi5::initPin(uint32_t pin, uint32_t frequency) {
+    if (pin >= MAX_PINS) {
+        return fail(GimbalError::PinUnavailable, pin);
+    }
+    if (!isValidFrequency(frequency)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
     if (chip_ < 0) {
-        if (!initLgpio()) {
-            return false;
+        GimbalStatus status = initLgpio();
+        if (!status) {
+            return status;
         }
     }
-    if (claimed_pins_.count(pin)) {
-        pin_frequency_[pin] = frequency;
-        return true;
+    PinState& state = pins_[pin];
+    if (!state.claimed) {
+        int rc = lgGpioClaimOutput(chip_, 0, pin, 0);
+        if (rc < 0) {
+            GIMBAL_LOG_ERROR("Failed to claim GPIO %u as output (%s)", static_cast<unsigned>(pin), lguErrorText(rc));
+            return fail(GimbalError::PinUnavailable, pin, rc);
+        }
+        GIMBAL_LOG_INFO("PWMControllerRPi5: Initialized pin %u at %u Hz",
+                        static_cast<unsigned>(pin), static_cast<unsigned>(frequency));
     }
-    if (lgGpioClaimOutput(chip_, 0, pin, 0) < 0) {
-        std::cerr << "Failed to claim GPIO " << pin << " as output" << std::endl;
-        return false;
+    state = PinState{};
+    state.frequency = static_cast<float>(frequency);
+    state.claimed = true;
+    return GimbalStatus::success();
+}
+
+GimbalStatus PWMControllerRPi5::writePulse(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    PinState& state = pins_[pin];
+    if (state.pulse_width_us == pulse_width_us && state.period_us == period_us) {
+        // Unchanged: lgTxPwm would only restart the software PWM thread
+        return GimbalStatus::success();
     }
-    claimed_pins_.insert(pin);
-    pin_frequency_[pin] = frequency;
-    std::cout << "PWMControllerRPi5: Initialized pin " << pin << " at " << frequency << " Hz" << std::endl;
-    return true;
+    if (state.period_us != period_us) {
+        // The period sets the frame rate lgTxPwm runs at, not just the duty scale
+        state.frequency = 1000000.0f / static_cast<float>(period_us);
+        state.duty_per_us = 100.0f / static_cast<float>(period_us);
+        state.period_us = period_us;
+    }
+    float duty = static_cast<float>(pulse_width_us) * state.duty_per_us;
+    int rc = lgTxPwm(chip_, pin, state.frequency, duty, 0, 0);
+    if (rc < 0) {
+        state.pulse_width_us = 0;
+        return fail(GimbalError::IoError, pin, rc);
+    }
+    state.pulse_width_us = pulse_width_us;
+    return GimbalStatus::success();
 }
 
-bool PWMControllerRPi5::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
-    if (chip_ < 0 || !claimed_pins_.count(pin)) {
-        std::cerr << "Pin " << pin << " not initialized" << std::endl;
-        return false;
+GimbalStatus PWMControllerRPi5::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    if (chip_ < 0 || !isClaimed(pin)) {
+        return fail(GimbalError::PinNotInitialized, pin);
     }
-    auto itf = pin_frequency_.find(pin);
-    if (itf == pin_frequency_.end()) {
-        std::cerr << "Frequency not set for pin " << pin << std::endl;
-        return false;
+    if (!isValidFrame(pulse_width_us, period_us)) {
+        return fail(GimbalError::InvalidArgument, pin);
     }
-    double duty = (static_cast<double>(pulse_width_us) / static_cast<double>(period_us)) * 100.0;
-    if (lgTxPwm(chip_, pin, static_cast<float>(itf->second), static_cast<float>(duty), 0, 0) < 0) {
-        std::cerr << "Failed to set PWM on pin " << pin << std::endl;
-        return false;
+    return writePulse(pin, pulse_width_us, period_us);
+}
+
+GimbalStatus PWMControllerRPi5::setPulseWidths(const PulseCommand* commands, size_t count) {
+    // Same contract as the base class: every command is attempted and the
+    // first failure returned, so one bad pin does not freeze the others.
+    // The lgpio calls are issued back to back, without a virtual call each;
+    // failures are reported as setPulseWidth() reports them.
+    GimbalStatus result;
+    for (size_t i = 0; i < count; ++i) {
+        const PulseCommand& command = commands[i];
+        GimbalStatus status;
+        if (chip_ < 0 || !isClaimed(command.pin)) {
+            status = fail(GimbalError::PinNotInitialized, command.pin);
+        } else if (!isValidFrame(command.pulse_width_us, command.period_us)) {
+            status = fail(GimbalError::InvalidArgument, command.pin);
+        } else {
+            status = writePulse(command.pin, command.pulse_width_us, command.period_us);
+        }
+        if (!status && result) {
+            result = status;
+        }
     }
-    return true;
+    return result;
 }
 
-bool PWMControllerRPi5::shutdownPin(uint32_t pin) {
-    if (!claimed_pins_.count(pin)) {
-        return false;
+GimbalStatus PWMControllerRPi5::shutdownPin(uint32_t pin) {
+    if (!isClaimed(pin)) {
+        return fail(GimbalError::PinNotInitialized, pin);
     }
     lgTxPwm(chip_, pin, 50.0f, 0.0f, 0, 0);
     lgGpioFree(chip_, pin);
-    claimed_pins_.erase(pin);
-    pin_frequency_.erase(pin);
-    std::cout << "PWMControllerRPi5: Shutdown pin " << pin << std::endl;
-    return true;
+    pins_[pin] = PinState{};
+    GIMBAL_LOG_INFO("PWMControllerRPi5: Shutdown pin %u", static_cast<unsigned>(pin));
+    return GimbalStatus::success();
 }
@@ -0,0 +1,186 @@
+#include "PWMControllerServoSim.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float TWO_PI = 6.28318530718f;
+
+} // namespace
+
+PWMControllerServoSim::PWMControllerServoSim() : pins_{}, now_ns_(0) {
+    const ServoCalibration calibration = ServoCalibration::fromConfig();
+    for (uint32_t pin = 0; pin < MAX_PINS; ++pin) {
+        attachServo(pin, ServoModel::GIMBAL_CALIBRATION_SERVO, calibration);
+    }
+}
+
+GimbalStatus PWMControllerServoSim::initPin(uint32_t pin, uint32_t frequency) {
+    if (pin >= MAX_PINS) {
+        return fail(GimbalError::PinUnavailable, pin);
+    }
+    if (!isValidFrequency(frequency)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+    PinState& state = pins_[pin];
+    state.initialized = true;
+    state.period_ns = 1000000000ull / frequency;
+    state.next_frame_ns = now_ns_;
+    state.pulse_width_us = 0;
+    return GimbalStatus::success();
+}
+
+GimbalStatus PWMControllerServoSim::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    if (pin >= MAX_PINS || !pins_[pin].initialized) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+    if (!isValidFrame(pulse_width_us, period_us)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+    // The servo sees the new frame length from its next frame on
+    pins_[pin].pulse_width_us = pulse_width_us;
+    pins_[pin].period_ns = static_cast<uint64_t>(period_us) * 1000;
+    return GimbalStatus::success();
+}
+
+GimbalStatus PWMControllerServoSim::shutdownPin(uint32_t pin) {
+    if (pin >= MAX_PINS || !pins_[pin].initialized) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+    // Without pulses the servo stops driving; the horn stays where it is
+    PinState& state = pins_[pin];
+    state.initialized = false;
+    state.pulse_width_us = 0;
+    state.latched_us = 0;
+    state.target = state.angle;
+    state.velocity = 0.0f;
+    return GimbalStatus::success();
+}
+
+bool PWMControllerServoSim::attachServo(uint32_t pin, ServoModel model, const ServoCalibration& calibration) {
+    if (pin >= MAX_PINS) {
+        return false;
+    }
+    PinState& state = pins_[pin];
+    state.model = model;
+    state.calibration = calibration;
+    state.latched_us = 0;
+    state.latches = 0;
+    state.target = 0.0f;
+    state.angle = 0.0f;
+    state.velocity = 0.0f;
+    return true;
+}
+
+bool PWMControllerServoSim::attachServo(uint32_t pin, ServoModel model) {
+    return attachServo(pin, model, ServoCalibration::forModel(model));
+}
+
+void PWMControllerServoSim::setServoAngle(uint32_t pin, float angle) {
+    if (pin >= MAX_PINS) {
+        return;
+    }
+    PinState& state = pins_[pin];
+    state.angle = std::min(std::max(angle, state.calibration.getMinAngle()), state.calibration.getMaxAngle());
+    state.target = state.angle;
+    state.velocity = 0.0f;
+}
+
+void PWMControllerServoSim::advance(uint64_t duration_ns) {
+    const uint64_t end_ns = now_ns_ + duration_ns;
+    for (PinState& state : pins_) {
+        if (state.initialized) {
+            advancePin(state, end_ns);
+        }
+    }
+    now_ns_ = end_ns;
+}
+
+float PWMControllerServoSim::getServoAngle(uint32_t pin) const {
+    return pin < MAX_PINS ? pins_[pin].angle : 0.0f;
+}
+
+float PWMControllerServoSim::getServoVelocity(uint32_t pin) const {
+    return pin < MAX_PINS ? pins_[pin].velocity : 0.0f;
+}
+
+float PWMControllerServoSim::getServoTarget(uint32_t pin) const {
+    return pin < MAX_PINS ? pins_[pin].target : 0.0f;
+}
+
+uint32_t PWMControllerServoSim::getPulseWidth(uint32_t pin) const {
+    return pin < MAX_PINS ? pins_[pin].pulse_width_us : 0;
+}
+
+uint64_t PWMControllerServoSim::getLatchCount(uint32_t pin) const {
+    return pin < MAX_PINS ? pins_[pin].latches : 0;
+}
+
+void PWMControllerServoSim::advancePin(PinState& state, uint64_t end_ns) {
+    uint64_t t = now_ns_;
+    while (t < end_ns) {
+        if (state.next_frame_ns <= t) {
+            latch(state);
+            state.next_frame_ns += state.period_ns;
+        }
+        // Integrate up to the next frame boundary so latches land on time
+        uint64_t step_end = std::min(std::min(end_ns, state.next_frame_ns), t + STEP_NS);
+        integrate(state, static_cast<float>(step_end - t) * 1e-9f);
+        t = step_end;
+    }
+}
+
+void PWMControllerServoSim::latch(PinState& state) {
+    uint32_t pulse = state.pulse_width_us;
+    if (pulse == 0) {
+        return;
+    }
+    uint32_t change = pulse > state.latched_us ? pulse - state.latched_us : state.latched_us - pulse;
+    const ServoProfile& profile = getServoProfile(state.model);
+    if (state.latched_us != 0 && change < profile.deadband_us) {
+        return;
+    }
+    state.latched_us = pulse;
+    state.target = toAngle(state.calibration, static_cast<float>(pulse));
+    ++state.latches;
+}
+
+void PWMControllerServoSim::integrate(PinState& state, float dt) {
+    if (state.latched_us == 0) {
+        return;
+    }
+    const ServoProfile& profile = getServoProfile(state.model);
+    const float omega = TWO_PI * profile.natural_frequency_hz;
+
+    // Semi-implicit Euler: stable while omega * dt << 1 (0.01 at 15 Hz, 100 µs)
+    float acceleration = omega * omega * (state.target - state.angle) - 2.0f * profile.damping_ratio * omega * state.velocity;
+    state.velocity += acceleration * dt;
+    state.velocity = std::min(std::max(state.velocity, -profile.max_speed_dps), profile.max_speed_dps);
+    state.angle += state.velocity * dt;
+
+    const float min_angle = state.calibration.getMinAngle();
+    const float max_angle = state.calibration.getMaxAngle();
+    if (state.angle < min_angle || state.angle > max_angle) {
+        state.angle = std::min(std::max(state.angle, min_angle), max_angle);
+        state.velocity = 0.0f;
+    }
+}
+
+float PWMControllerServoSim::toAngle(const ServoCalibration& calibration, float pulse_width_us) {
+    // Inverse of the piecewise-linear curve; pulses beyond the ends hit the end stops
+    size_t count = calibration.getPointCount();
+    const CalibrationPoint& first = calibration.getPoint(0);
+    const CalibrationPoint& last = calibration.getPoint(count - 1);
+    bool rising = last.pulse_us >= first.pulse_us;
+    for (size_t i = 1; i < count; ++i) {
+        const CalibrationPoint& a = calibration.getPoint(i - 1);
+        const CalibrationPoint& b = calibration.getPoint(i);
+        float low = std::min(a.pulse_us, b.pulse_us);
+        float high = std::max(a.pulse_us, b.pulse_us);
+        if (pulse_width_us >= low && pulse_width_us <= high && high > low) {
+            return a.angle + (b.angle - a.angle) * (pulse_width_us - a.pulse_us) / (b.pulse_us - a.pulse_us);
+        }
+    }
+    bool below = rising ? pulse_width_us < first.pulse_us : pulse_width_us > first.pulse_us;
+    return below ? first.angle : last.angle;
+}
@@ -0,0 +1,154 @@
+#include "PWMControllerSim.h"
+#include <cerrno>
+#include <chrono>
+
+namespace {
+
+uint64_t nowNanos() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+PWMControllerSim::PWMControllerSim(size_t record_capacity)
+    : records_(record_capacity > 0 ? record_capacity : 1),
+      total_calls_(0),
+      pins_{},
+      write_latency_ns_(0),
+      failure_threshold_(0),
+      rng_state_(1) {
+}
+
+GimbalStatus PWMControllerSim::initPin(uint32_t pin, uint32_t frequency) {
+    GimbalStatus status;
+    if (pin >= MAX_PINS) {
+        status = fail(GimbalError::PinUnavailable, pin);
+    } else if (!isValidFrequency(frequency)) {
+        status = fail(GimbalError::InvalidArgument, pin);
+    } else {
+        pins_[pin].initialized = true;
+        pins_[pin].frequency = frequency;
+        pins_[pin].pulse_width_us = 0;
+    }
+    record(SimCallType::InitPin, status.ok(), pin, frequency, 0, nowNanos());
+    return status;
+}
+
+GimbalStatus PWMControllerSim::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    uint64_t start = nowNanos();
+    GimbalStatus status = writePulse(pin, pulse_width_us, period_us);
+    waitLatency(start);
+    record(SimCallType::SetPulseWidth, status.ok(), pin, pulse_width_us, period_us, start);
+    return status;
+}
+
+GimbalStatus PWMControllerSim::setPulseWidths(const PulseCommand* commands, size_t count) {
+    // All commands of a batch share one timestamp: they land in the same frame
+    uint64_t start = nowNanos();
+    GimbalStatus result;
+    for (size_t i = 0; i < count; ++i) {
+        const PulseCommand& command = commands[i];
+        GimbalStatus status = writePulse(command.pin, command.pulse_width_us, command.period_us);
+        record(SimCallType::SetPulseWidth, status.ok(), command.pin, command.pulse_width_us, command.period_us, start);
+        if (result && !status) {
+            result = status;
+        }
+    }
+    waitLatency(start);
+    return result;
+}
+
+GimbalStatus PWMControllerSim::shutdownPin(uint32_t pin) {
+    GimbalStatus status;
+    if (pin < MAX_PINS && pins_[pin].initialized) {
+        pins_[pin] = PinState{};
+    } else {
+        status = fail(GimbalError::PinNotInitialized, pin);
+    }
+    record(SimCallType::ShutdownPin, status.ok(), pin, 0, 0, nowNanos());
+    return status;
+}
+
+void PWMControllerSim::setWriteLatency(uint32_t latency_ns) {
+    write_latency_ns_ = latency_ns;
+}
+
+void PWMControllerSim::setFailureRate(double probability, uint64_t seed) {
+    if (probability <= 0.0) {
+        failure_threshold_ = 0;
+    } else if (probability >= 1.0) {
+        failure_threshold_ = UINT64_MAX;
+    } else {
+        failure_threshold_ = static_cast<uint64_t>(probability * 18446744073709551615.0);
+    }
+    rng_state_ = seed != 0 ? seed : 1;
+}
+
+size_t PWMControllerSim::getRecordCount() const {
+    return total_calls_ < records_.size() ? static_cast<size_t>(total_calls_) : records_.size();
+}
+
+const SimCallRecord& PWMControllerSim::getRecord(size_t index) const {
+    size_t oldest = total_calls_ < records_.size() ? 0 : static_cast<size_t>(total_calls_ % records_.size());
+    return records_[(oldest + index) % records_.size()];
+}
+
+void PWMControllerSim::clearRecords() {
+    total_calls_ = 0;
+}
+
+uint32_t PWMControllerSim::getPulseWidth(uint32_t pin) const {
+    return pin < MAX_PINS ? pins_[pin].pulse_width_us : 0;
+}
+
+bool PWMControllerSim::isPinInitialized(uint32_t pin) const {
+    return pin < MAX_PINS && pins_[pin].initialized;
+}
+
+void PWMControllerSim::record(SimCallType type, bool success, uint32_t pin, uint32_t value,
+                              uint32_t period_us, uint64_t timestamp_ns) {
+    SimCallRecord& r = records_[static_cast<size_t>(total_calls_ % records_.size())];
+    r.timestamp_ns = timestamp_ns;
+    r.type = type;
+    r.success = success;
+    r.pin = pin;
+    r.value = value;
+    r.period_us = period_us;
+    ++total_calls_;
+}
+
+GimbalStatus PWMControllerSim::writePulse(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    if (pin >= MAX_PINS || !pins_[pin].initialized) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+    if (!isValidFrame(pulse_width_us, period_us)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+    if (injectFailure()) {
+        return fail(GimbalError::IoError, pin, EIO);
+    }
+    pins_[pin].pulse_width_us = pulse_width_us;
+    return GimbalStatus::success();
+}
+
+void PWMControllerSim::waitLatency(uint64_t start_ns) const {
+    if (write_latency_ns_ == 0) {
+        return;
+    }
+    while (nowNanos() - start_ns < write_latency_ns_) {
+        // Busy-wait: sleeping would add scheduler jitter to the measurement
+    }
+}
+
+bool PWMControllerSim::injectFailure() {
+    if (failure_threshold_ == 0) {
+        return false;
+    }
+    // xorshift64: cheap, deterministic for a given seed
+    rng_state_ ^= rng_state_ << 13;
+    rng_state_ ^= rng_state_ >> 7;
+    rng_state_ ^= rng_state_ << 17;
+    return rng_state_ <= failure_threshold_;
+}
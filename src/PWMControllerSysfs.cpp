@@ -0,0 +1,241 @@
+#include "PWMControllerSysfs.h"
+#include "GimbalLog.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * Format an unsigned value as decimal into buffer (no terminator).
+ * @return Number of characters written
+ */
+size_t formatDecimal(uint32_t value, char* buffer) {
+    char digits[10];
+    size_t n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    for (size_t i = 0; i < n; ++i) {
+        buffer[i] = digits[n - 1 - i];
+    }
+    return n;
+}
+
+bool writeValue(int fd, uint32_t value) {
+    char buffer[12];
+    size_t length = formatDecimal(value, buffer);
+    buffer[length++] = '\n';
+    return pwrite(fd, buffer, length, 0) == static_cast<ssize_t>(length);
+}
+
+bool writeFile(const std::string& path, const char* text) {
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    size_t length = std::strlen(text);
+    bool ok = write(fd, text, length) == static_cast<ssize_t>(length);
+    close(fd);
+    return ok;
+}
+
+bool pathExists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+} // namespace
+
+PWMControllerSysfs::PWMControllerSysfs(const std::string& chip_path)
+    : chip_path_(chip_path), pins_{} {
+    for (auto& state : pins_) {
+        state.duty_fd = -1;
+        state.period_fd = -1;
+    }
+    // RP1 PWM0 channels on the Raspberry Pi 5 header
+    mapPin(12, 0);
+    mapPin(13, 1);
+    mapPin(18, 2);
+    mapPin(19, 3);
+}
+
+PWMControllerSysfs::~PWMControllerSysfs() {
+    for (uint32_t pin = 0; pin < MAX_PINS; ++pin) {
+        if (pins_[pin].active) {
+            shutdownPin(pin);
+        }
+    }
+}
+
+bool PWMControllerSysfs::mapPin(uint32_t pin, uint32_t channel) {
+    if (pin >= MAX_PINS || pins_[pin].active) {
+        return false;
+    }
+    // One channel drives one pin: a second mapping would share its waveform
+    for (uint32_t other = 0; other < MAX_PINS; ++other) {
+        if (other != pin && pins_[other].mapped && pins_[other].channel == channel) {
+            GIMBAL_LOG_ERROR("PWMControllerSysfs: channel %u already mapped to pin %u",
+                             static_cast<unsigned>(channel), static_cast<unsigned>(other));
+            return false;
+        }
+    }
+    pins_[pin].mapped = true;
+    pins_[pin].channel = channel;
+    return true;
+}
+
+bool PWMControllerSysfs::unmapPin(uint32_t pin) {
+    if (pin >= MAX_PINS || pins_[pin].active) {
+        return false;
+    }
+    pins_[pin].mapped = false;
+    return true;
+}
+
+std::string PWMControllerSysfs::channelPath(uint32_t channel) const {
+    return chip_path_ + "/pwm" + std::to_string(channel);
+}
+
+bool PWMControllerSysfs::exportChannel(uint32_t channel) {
+    std::string path = channelPath(channel);
+    if (pathExists(path)) {
+        return true;
+    }
+    if (!writeFile(chip_path_ + "/export", std::to_string(channel).c_str())) {
+        GIMBAL_LOG_ERROR("PWMControllerSysfs: cannot export channel %u (%s)",
+                         static_cast<unsigned>(channel), std::strerror(errno));
+        return false;
+    }
+    // udev applies permissions to the new directory asynchronously
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (access((path + "/duty_cycle").c_str(), W_OK) == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    GIMBAL_LOG_ERROR("PWMControllerSysfs: channel %u did not appear", static_cast<unsigned>(channel));
+    return false;
+}
+
+bool PWMControllerSysfs::writePeriod(ChannelState& state, uint32_t period_ns) {
+    // The kernel rejects a period shorter than the current duty cycle
+    if (state.duty_ns > period_ns) {
+        if (!writeValue(state.duty_fd, 0)) {
+            return false;
+        }
+        state.duty_ns = 0;
+    }
+    if (!writeValue(state.period_fd, period_ns)) {
+        return false;
+    }
+    state.period_ns = period_ns;
+    return true;
+}
+
+void PWMControllerSysfs::closeChannel(ChannelState& state) {
+    if (state.duty_fd >= 0) {
+        close(state.duty_fd);
+        state.duty_fd = -1;
+    }
+    if (state.period_fd >= 0) {
+        close(state.period_fd);
+        state.period_fd = -1;
+    }
+    state.active = false;
+}
+
+GimbalStatus PWMControllerSysfs::initPin(uint32_t pin, uint32_t frequency) {
+    if (pin >= MAX_PINS || !pins_[pin].mapped) {
+        GIMBAL_LOG_ERROR("PWMControllerSysfs: GPIO %u has no hardware PWM channel", static_cast<unsigned>(pin));
+        return fail(GimbalError::PinUnavailable, pin);
+    }
+    if (!isValidFrequency(frequency)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+
+    ChannelState& state = pins_[pin];
+    uint32_t period_ns = 1000000000u / frequency;
+
+    if (state.active) {
+        return writePeriod(state, period_ns) ? GimbalStatus::success() : fail(GimbalError::IoError, pin, errno);
+    }
+    if (!exportChannel(state.channel)) {
+        return fail(GimbalError::DeviceUnavailable, pin, errno);
+    }
+
+    std::string path = channelPath(state.channel);
+    state.duty_fd = open((path + "/duty_cycle").c_str(), O_WRONLY | O_CLOEXEC);
+    state.period_fd = open((path + "/period").c_str(), O_WRONLY | O_CLOEXEC);
+    if (state.duty_fd < 0 || state.period_fd < 0) {
+        int error = errno;
+        GIMBAL_LOG_ERROR("PWMControllerSysfs: cannot open %s (%s)", path.c_str(), std::strerror(error));
+        closeChannel(state);
+        return fail(GimbalError::DeviceUnavailable, pin, error);
+    }
+
+    // Start from a known state: duty 0 first so any period is accepted
+    state.duty_ns = 0;
+    if (!writeValue(state.duty_fd, 0) || !writePeriod(state, period_ns) ||
+        !writeFile(path + "/enable", "1")) {
+        int error = errno;
+        GIMBAL_LOG_ERROR("PWMControllerSysfs: cannot configure channel %u (%s)",
+                         static_cast<unsigned>(state.channel), std::strerror(error));
+        closeChannel(state);
+        return fail(GimbalError::IoError, pin, error);
+    }
+
+    state.active = true;
+    GIMBAL_LOG_INFO("PWMControllerSysfs: Initialized pin %u (pwm%u) at %u Hz",
+                    static_cast<unsigned>(pin), static_cast<unsigned>(state.channel),
+                    static_cast<unsigned>(frequency));
+    return GimbalStatus::success();
+}
+
+GimbalStatus PWMControllerSysfs::setPulseWidth(uint32_t pin, uint32_t pulse_width_us, uint32_t period_us) {
+    if (pin >= MAX_PINS || !pins_[pin].active) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+    if (!isValidFrame(pulse_width_us, period_us)) {
+        return fail(GimbalError::InvalidArgument, pin);
+    }
+
+    ChannelState& state = pins_[pin];
+    uint32_t period_ns = period_us * 1000u;
+    uint32_t duty_ns = pulse_width_us * 1000u;
+
+    if (period_ns != state.period_ns && !writePeriod(state, period_ns)) {
+        return fail(GimbalError::IoError, pin, errno);
+    }
+    if (duty_ns == state.duty_ns) {
+        return GimbalStatus::success();
+    }
+    if (!writeValue(state.duty_fd, duty_ns)) {
+        state.duty_ns = UINT32_MAX;  // Unknown: force the next write
+        return fail(GimbalError::IoError, pin, errno);
+    }
+    state.duty_ns = duty_ns;
+    return GimbalStatus::success();
+}
+
+GimbalStatus PWMControllerSysfs::shutdownPin(uint32_t pin) {
+    if (pin >= MAX_PINS || !pins_[pin].active) {
+        return fail(GimbalError::PinNotInitialized, pin);
+    }
+
+    ChannelState& state = pins_[pin];
+    std::string path = channelPath(state.channel);
+    writeFile(path + "/enable", "0");
+    closeChannel(state);
+    writeFile(chip_path_ + "/unexport", std::to_string(state.channel).c_str());
+    state.period_ns = 0;
+    state.duty_ns = 0;
+
+    GIMBAL_LOG_INFO("PWMControllerSysfs: Shutdown pin %u", static_cast<unsigned>(pin));
+    return GimbalStatus::success();
+}
@@ -0,0 +1,69 @@
+#include "PicoPWMConfig.h"
+
+namespace {
+
+constexpr uint32_t MIN_DIVIDER_16THS = 16;     // 1.0
+constexpr uint32_t MAX_DIVIDER_16THS = 4095;   // 255 + 15/16
+constexpr uint64_t MAX_COUNTS = 65536;         // wrap + 1 with a 16-bit TOP
+
+} // namespace
+
+bool solvePicoPWMConfig(uint32_t sys_clk_hz, uint32_t frequency, PicoPWMConfig& config) {
+    if (sys_clk_hz == 0 || frequency == 0) {
+        return false;
+    }
+
+    // Work in 1/16 counts: ideal counts per period = sys_clk * 16 / (div16 * f)
+    const uint64_t clock_16ths = static_cast<uint64_t>(sys_clk_hz) * 16;
+
+    uint32_t best_div16 = 0;
+    uint64_t best_counts = 0;
+    uint64_t best_error = 0;   // |clock_16ths - div16 * f * counts|, i.e. period error * f * div16
+    uint64_t best_scale = 1;   // div16 * f * counts of the best candidate, to compare relative errors
+
+    for (uint32_t div16 = MIN_DIVIDER_16THS; div16 <= MAX_DIVIDER_16THS; ++div16) {
+        uint64_t step = static_cast<uint64_t>(div16) * frequency;
+        uint64_t counts = (clock_16ths + step / 2) / step;
+        if (counts > MAX_COUNTS) {
+            continue;
+        }
+        if (counts < 2) {
+            break;   // Larger dividers only get coarser
+        }
+
+        uint64_t produced = step * counts;
+        uint64_t error = produced > clock_16ths ? produced - clock_16ths : clock_16ths - produced;
+
+        // Dividers are visited from finest to coarsest: take the first one
+        // that is close enough
+        if (error * 1000000 <= produced * PICO_PWM_MAX_PERIOD_ERROR_PPM) {
+            best_div16 = div16;
+            best_counts = counts;
+            break;
+        }
+        // Relative error comparison without division: e1/s1 < e2/s2
+        if (best_div16 == 0 || error * best_scale < best_error * produced) {
+            best_div16 = div16;
+            best_counts = counts;
+            best_error = error;
+            best_scale = produced;
+        }
+    }
+
+    if (best_div16 == 0) {
+        return false;
+    }
+
+    config.frequency = frequency;
+    config.div_int = static_cast<uint8_t>(best_div16 / 16);
+    config.div_frac = static_cast<uint8_t>(best_div16 % 16);
+    config.wrap = static_cast<uint16_t>(best_counts - 1);
+    config.actual_frequency = static_cast<float>(
+        static_cast<double>(clock_16ths) / (static_cast<double>(best_div16) * static_cast<double>(best_counts)));
+    // ticks per µs = sys_clk * 16 / (div16 * 1e6), in Q12
+    config.counts_per_us_q12 = static_cast<uint32_t>(
+        (clock_16ths * 4096 + static_cast<uint64_t>(best_div16) * 500000) / (static_cast<uint64_t>(best_div16) * 1000000));
+    config.counts_per_us = static_cast<float>(
+        static_cast<double>(clock_16ths) / (static_cast<double>(best_div16) * 1000000.0));
+    return true;
+}
@@ -0,0 +1,296 @@
+#include "ServoCalibration.h"
+#include "GimbalConfig.h"
+#include "GimbalLog.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/// Pulse widths are tabulated in 1/16 µs, so they must stay below 4096 µs
+constexpr float MAX_PULSE_US = 4000.0f;
+
+constexpr float TABLE_SCALE = 16.0f;
+
+} // namespace
+
+ServoCalibration::ServoCalibration()
+    : points_{}, count_(0), cells_per_degree_(0.0f), min_angle_q16_(0), span_q16_(0),
+      cells_per_degree_q14_(0), table_{} {
+    const CalibrationPoint standard[] = {{-90.0f, static_cast<float>(GIMBAL_MIN_PULSE_WIDTH)},
+                                         {0.0f, static_cast<float>(GIMBAL_MID_PULSE_WIDTH)},
+                                         {90.0f, static_cast<float>(GIMBAL_MAX_PULSE_WIDTH)}};
+    setPoints(standard, 3);
+}
+
+ServoCalibration ServoCalibration::forModel(ServoModel model) {
+    ServoCalibration calibration;
+    if (model == ServoModel::HS422) {
+        const CalibrationPoint wide[] = {{-90.0f, 900.0f}, {0.0f, 1500.0f}, {90.0f, 2100.0f}};
+        calibration.setPoints(wide, 3);
+    }
+    // MG90S, SG90, MG996R and DIGITAL use the standard GIMBAL_*_PULSE_WIDTH range
+    return calibration;
+}
+
+ServoCalibration ServoCalibration::fromConfig() {
+    ServoCalibration calibration = forModel(ServoModel::GIMBAL_CALIBRATION_SERVO);
+#if defined(GIMBAL_MIN_PULSE_WIDTH_CALIBRATED) || defined(GIMBAL_MID_PULSE_WIDTH_CALIBRATED) || \
+    defined(GIMBAL_MAX_PULSE_WIDTH_CALIBRATED)
+    CalibrationPoint points[] = {{-90.0f, calibration.evaluate(-90.0f)},
+                                 {0.0f, calibration.evaluate(0.0f)},
+                                 {90.0f, calibration.evaluate(90.0f)}};
+#ifdef GIMBAL_MIN_PULSE_WIDTH_CALIBRATED
+    points[0].pulse_us = static_cast<float>(GIMBAL_MIN_PULSE_WIDTH_CALIBRATED);
+#endif
+#ifdef GIMBAL_MID_PULSE_WIDTH_CALIBRATED
+    points[1].pulse_us = static_cast<float>(GIMBAL_MID_PULSE_WIDTH_CALIBRATED);
+#endif
+#ifdef GIMBAL_MAX_PULSE_WIDTH_CALIBRATED
+    points[2].pulse_us = static_cast<float>(GIMBAL_MAX_PULSE_WIDTH_CALIBRATED);
+#endif
+    calibration.setPoints(points, 3);
+#endif
+    return calibration;
+}
+
+bool ServoCalibration::setPoints(const CalibrationPoint* points, size_t count) {
+    if (!points || count < 2 || count > MAX_POINTS) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        // Negated comparisons reject NaN as well
+        if (!(points[i].pulse_us > 0.0f && points[i].pulse_us <= MAX_PULSE_US) ||
+            !(points[i].angle >= -180.0f && points[i].angle <= 180.0f)) {
+            return false;
+        }
+        if (i > 0 && !(points[i].angle > points[i - 1].angle)) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        points_[i] = points[i];
+    }
+    count_ = static_cast<uint32_t>(count);
+    buildTable();
+    return true;
+}
+
+void ServoCalibration::buildTable() {
+    const float min_angle = points_[0].angle;
+    const float span = points_[count_ - 1].angle - min_angle;
+    const float cells = static_cast<float>(TABLE_SIZE - 1);
+
+    cells_per_degree_ = cells / span;
+    min_angle_q16_ = static_cast<int32_t>(std::lround(min_angle * 65536.0f));
+    span_q16_ = static_cast<int32_t>(std::lround(span * 65536.0f));
+    cells_per_degree_q14_ = static_cast<int32_t>(std::lround(cells_per_degree_ * 16384.0f));
+
+    for (size_t i = 0; i < TABLE_SIZE; ++i) {
+        float angle = min_angle + static_cast<float>(i) / cells_per_degree_;
+        table_[i] = static_cast<uint16_t>(std::lround(evaluate(angle) * TABLE_SCALE));
+    }
+}
+
+float ServoCalibration::evaluate(float angle) const {
+    if (!(angle > points_[0].angle)) {
+        return points_[0].pulse_us;
+    }
+    if (angle >= points_[count_ - 1].angle) {
+        return points_[count_ - 1].pulse_us;
+    }
+
+    // Last point at or below the angle
+    size_t low = 0;
+    size_t high = count_ - 1;
+    while (high - low > 1) {
+        size_t mid = (low + high) / 2;
+        if (points_[mid].angle <= angle) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    const CalibrationPoint& a = points_[low];
+    const CalibrationPoint& b = points_[high];
+    return a.pulse_us + (b.pulse_us - a.pulse_us) * (angle - a.angle) / (b.angle - a.angle);
+}
+
+uint32_t ServoCalibration::toPulseWidth(float angle) const {
+    float x = (angle - points_[0].angle) * cells_per_degree_;
+    if (!(x > 0.0f)) {
+        x = 0.0f;
+    }
+    const float last_cell = static_cast<float>(TABLE_SIZE - 2);
+    int32_t index = x < last_cell ? static_cast<int32_t>(x) : static_cast<int32_t>(TABLE_SIZE - 2);
+    float frac = x - static_cast<float>(index);
+    if (frac > 1.0f) {
+        frac = 1.0f;
+    }
+
+    float low = static_cast<float>(table_[index]);
+    float high = static_cast<float>(table_[index + 1]);
+    return static_cast<uint32_t>(static_cast<int32_t>((low + (high - low) * frac) / TABLE_SCALE + 0.5f));
+}
+
+uint32_t ServoCalibration::toPulseWidthQ16(int32_t angle_q16) const {
+    int32_t offset = angle_q16 - min_angle_q16_;
+    if (offset < 0) {
+        offset = 0;
+    } else if (offset > span_q16_) {
+        offset = span_q16_;
+    }
+
+    // Q8 angle * Q14 cells/degree = Q22 table position; the product is at
+    // most ~(TABLE_SIZE - 1) << 22, so it fits in 31 bits for any span
+    int32_t position = (offset >> 8) * cells_per_degree_q14_;
+    int32_t index = position >> 22;
+    int32_t frac = (position >> 14) & 0xFF;
+    if (index >= static_cast<int32_t>(TABLE_SIZE - 1)) {
+        index = TABLE_SIZE - 2;
+        frac = 256;
+    }
+
+    // Q4 pulse * 256 + Q4 delta * Q8 fraction = Q12
+    int32_t low = table_[index];
+    int32_t high = table_[index + 1];
+    int32_t pulse_q12 = low * 256 + (high - low) * frac;
+    return static_cast<uint32_t>((pulse_q12 + 2048) >> 12);
+}
+
+#ifndef PICO_BUILD
+namespace {
+
+char* trim(char* text) {
+    while (*text == ' ' || *text == '\t') {
+        ++text;
+    }
+    char* end = text + std::strlen(text);
+    while (end > text && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) {
+        --end;
+    }
+    *end = '\0';
+    return text;
+}
+
+bool parseModel(const char* name, ServoModel& model) {
+    static const struct {
+        const char* name;
+        ServoModel model;
+    } MODELS[] = {
+        {"MG90S", ServoModel::MG90S},
+        {"SG90", ServoModel::SG90},
+        {"HS422", ServoModel::HS422},
+        {"MG996R", ServoModel::MG996R},
+        {"DIGITAL", ServoModel::DIGITAL},
+    };
+    for (const auto& entry : MODELS) {
+        if (std::strcmp(name, entry.name) == 0) {
+            model = entry.model;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Points collected for one section before they are applied
+struct AxisSection {
+    ServoCalibration* target;
+    CalibrationPoint points[ServoCalibration::MAX_POINTS];
+    size_t count;
+};
+
+bool finishSection(AxisSection& section) {
+    if (!section.target || section.count == 0) {
+        return true;
+    }
+    return section.target->setPoints(section.points, section.count);
+}
+
+} // namespace
+
+bool loadCalibrationFile(const char* path, GimbalCalibration& calibration) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        GIMBAL_LOG_ERROR("Calibration: cannot open %s", path);
+        return false;
+    }
+
+    // Parse into a copy so a bad file leaves the caller's calibration intact
+    GimbalCalibration result;
+    result.pan = ServoCalibration::fromConfig();
+    result.tilt = ServoCalibration::fromConfig();
+
+    AxisSection section{nullptr, {}, 0};
+    char buffer[160];
+    unsigned line_number = 0;
+    bool ok = true;
+
+    while (ok && std::fgets(buffer, sizeof(buffer), file)) {
+        ++line_number;
+        char* line = trim(buffer);
+        if (*line == '\0' || *line == '#' || *line == ';') {
+            continue;
+        }
+
+        if (*line == '[') {
+            ok = finishSection(section);
+            section.count = 0;
+            if (std::strcmp(line, "[pan]") == 0) {
+                section.target = &result.pan;
+            } else if (std::strcmp(line, "[tilt]") == 0) {
+                section.target = &result.tilt;
+            } else {
+                ok = false;
+            }
+            continue;
+        }
+
+        char* equals = std::strchr(line, '=');
+        if (!section.target || !equals) {
+            ok = false;
+            continue;
+        }
+        *equals = '\0';
+        char* key = trim(line);
+        char* value = trim(equals + 1);
+
+        if (std::strcmp(key, "model") == 0) {
+            ServoModel model;
+            ok = parseModel(value, model);
+            if (ok) {
+                *section.target = ServoCalibration::forModel(model);
+            }
+        } else if (std::strcmp(key, "point") == 0 && section.count < ServoCalibration::MAX_POINTS) {
+            char* end = nullptr;
+            CalibrationPoint& point = section.points[section.count];
+            point.angle = std::strtof(value, &end);
+            ok = end != value;
+            char* pulse_start = end;
+            point.pulse_us = std::strtof(pulse_start, &end);
+            ok = ok && end != pulse_start && *trim(end) == '\0';
+            ++section.count;
+        } else {
+            ok = false;
+        }
+    }
+    std::fclose(file);
+
+    if (ok) {
+        ok = finishSection(section);
+    }
+    if (!ok) {
+        GIMBAL_LOG_ERROR("Calibration: invalid entry in %s near line %u", path, line_number);
+        return false;
+    }
+
+    calibration = result;
+    GIMBAL_LOG_INFO("Calibration: loaded %s (pan %u points, tilt %u points)", path,
+                    static_cast<unsigned>(result.pan.getPointCount()),
+                    static_cast<unsigned>(result.tilt.getPointCount()));
+    return true;
+}
+#endif
@@ -0,0 +1,31 @@
+#include "ServoProfile.h"
+#include "GimbalConfig.h"
+#include <cstddef>
+
+namespace {
+
+/// Indexed by ServoModel. Speeds: 60 degrees in 0.10 s (MG90S, SG90),
+/// 0.21 s (HS-422), 0.19 s (MG996R), 0.08 s (typical digital servo)
+const ServoProfile PROFILES[] = {
+    {ServoModel::MG90S, "MG90S", ServoDrive::Analog, 50, 600.0f, 5, 8.0f, 0.6f},
+    {ServoModel::SG90, "SG90", ServoDrive::Analog, 50, 600.0f, 10, 7.0f, 0.5f},
+    {ServoModel::HS422, "HS422", ServoDrive::Analog, 50, 286.0f, 8, 6.0f, 0.7f},
+    {ServoModel::MG996R, "MG996R", ServoDrive::Analog, 50, 316.0f, 5, 5.0f, 0.6f},
+    {ServoModel::DIGITAL, "DIGITAL", ServoDrive::Digital, GIMBAL_PWM_MAX_FREQUENCY, 750.0f, 2, 15.0f, 0.8f},
+};
+
+constexpr size_t PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+static_assert(PROFILE_COUNT == static_cast<size_t>(ServoModel::DIGITAL) + 1, "one profile per ServoModel");
+
+} // namespace
+
+const ServoProfile& getServoProfile(ServoModel model) {
+    size_t index = static_cast<size_t>(model);
+    // Unknown values get the most conservative entry
+    return index < PROFILE_COUNT ? PROFILES[index] : PROFILES[0];
+}
+
+bool isFrameRateSupported(ServoModel model, uint32_t frequency_hz) {
+    return frequency_hz > 0 && frequency_hz <= getServoProfile(model).max_frequency_hz;
+}
@@ -0,0 +1,105 @@
+#include "Stabilizer.h"
+#include "Gimbal.h"
+#include <cmath>
+
+namespace {
+
+constexpr float DEG_TO_RAD = 0.017453292f;
+constexpr float RAD_TO_DEG = 57.29578f;
+
+/// Samples copied out of the source per read() (bounded stack use on the Pico)
+constexpr size_t READ_CHUNK = 16;
+
+bool clampAngle(float& angle) {
+    if (angle > Gimbal::Core::MAX_ANGLE) {
+        angle = Gimbal::Core::MAX_ANGLE;
+        return true;
+    }
+    if (angle < Gimbal::Core::MIN_ANGLE) {
+        angle = Gimbal::Core::MIN_ANGLE;
+        return true;
+    }
+    return false;
+}
+
+/// Clamp both axes to the servo range; true if either was out of range
+bool clampAngles(float& pan_angle, float& tilt_angle) {
+    bool pan_clamped = clampAngle(pan_angle);
+    bool tilt_clamped = clampAngle(tilt_angle);
+    return pan_clamped || tilt_clamped;
+}
+
+} // namespace
+
+Stabilizer::Stabilizer(ImuSource* source, const StabilizerConfig& config)
+    : source_(source), config_(config), filter_(config.attitude), stats_{} {
+}
+
+void Stabilizer::configure(const StabilizerConfig& config) {
+    config_ = config;
+    filter_.configure(config.attitude);
+    stats_ = StabilizerStats{};
+}
+
+void Stabilizer::reset() {
+    filter_.reset();
+    stats_ = StabilizerStats{};
+}
+
+size_t Stabilizer::update() {
+    if (!source_) {
+        return 0;
+    }
+    ImuSample samples[READ_CHUNK];
+    size_t total = 0;
+    size_t count;
+    do {
+        count = source_->read(samples, READ_CHUNK);
+        update(samples, count);
+        total += count;
+    } while (count == READ_CHUNK);
+    return total;
+}
+
+void Stabilizer::update(const ImuSample* samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (filter_.update(samples[i])) {
+            ++stats_.samples;
+            stats_.last_sample_ns = samples[i].timestamp_ns;
+        } else {
+            ++stats_.rejected;
+        }
+    }
+}
+
+bool Stabilizer::toServoAngles(float world_pan, float world_tilt, uint64_t time_ns, float& pan_angle,
+                               float& tilt_angle) {
+    if (!filter_.isInitialized()) {
+        pan_angle = world_pan;
+        tilt_angle = world_tilt;
+        if (clampAngles(pan_angle, tilt_angle)) {
+            ++stats_.saturated;
+        }
+        return false;
+    }
+
+    const Quaternion attitude = filter_.predict(time_ns + config_.lead_ns);
+    float pan = world_pan * DEG_TO_RAD;
+    if (!config_.hold_heading) {
+        // Targets relative to the mount's heading: rotating the target by
+        // the heading cancels the yaw part of the attitude
+        pan += filter_.getYaw();
+    }
+    const float tilt = world_tilt * DEG_TO_RAD;
+    const float cos_tilt = std::cos(tilt);
+    const float world[3] = {cos_tilt * std::cos(pan), cos_tilt * std::sin(pan), std::sin(tilt)};
+    float body[3];
+    attitude.rotateInverse(world, body);
+
+    pan_angle = std::atan2(body[1], body[0]) * RAD_TO_DEG;
+    tilt_angle = std::atan2(body[2], std::sqrt(body[0] * body[0] + body[1] * body[1])) * RAD_TO_DEG;
+    if (clampAngles(pan_angle, tilt_angle)) {
+        ++stats_.saturated;
+    }
+    return true;
+}
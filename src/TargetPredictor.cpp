@@ -0,0 +1,129 @@
+#include "TargetPredictor.h"
+
+namespace {
+
+constexpr float NANOS_TO_SECONDS = 1e-9f;
+
+} // namespace
+
+TargetPredictor::TargetPredictor(const PredictorConfig& config)
+    : config_(config), pan_{}, tilt_{}, last_ns_(0), samples_(0) {
+}
+
+void TargetPredictor::configure(const PredictorConfig& config) {
+    config_ = config;
+    reset();
+}
+
+void TargetPredictor::reset() {
+    pan_ = AxisState{};
+    tilt_ = AxisState{};
+    last_ns_ = 0;
+    samples_ = 0;
+}
+
+uint64_t TargetPredictor::getLeadTime() const {
+    float tau = config_.servo_time_constant_s > 0.0f ? config_.servo_time_constant_s : 0.0f;
+    return config_.fixed_latency_ns + static_cast<uint64_t>(tau * 1e9f);
+}
+
+float TargetPredictor::clampVelocity(float velocity) const {
+    const float limit = config_.max_velocity;
+    if (limit <= 0.0f) {
+        return velocity;
+    }
+    return velocity > limit ? limit : (velocity < -limit ? -limit : velocity);
+}
+
+void TargetPredictor::start(AxisState& axis, float angle) const {
+    axis.position = angle;
+    axis.velocity = 0.0f;
+    // Position known to measurement accuracy, velocity anywhere in range
+    axis.p00 = config_.measurement_noise;
+    axis.p01 = 0.0f;
+    axis.p11 = config_.max_velocity > 0.0f ? config_.max_velocity * config_.max_velocity : 1e6f;
+}
+
+void TargetPredictor::updateAxis(AxisState& axis, float angle, float dt) const {
+    float predicted = axis.position + axis.velocity * dt;
+    float residual = angle - predicted;
+
+    if (config_.model == PredictorModel::AlphaBeta) {
+        if (samples_ == 1) {
+            // Second sample: take the velocity from the two points instead
+            // of waiting for beta to pull it up from zero
+            axis.velocity = clampVelocity((angle - axis.position) / dt);
+            axis.position = angle;
+            return;
+        }
+        axis.position = predicted + config_.alpha * residual;
+        axis.velocity = clampVelocity(axis.velocity + config_.beta * residual / dt);
+        return;
+    }
+
+    // Predict: x' = F x, P' = F P F^T + Q for white-noise acceleration
+    const float q = config_.process_noise;
+    const float dt2 = dt * dt;
+    float p00 = axis.p00 + dt * (2.0f * axis.p01 + dt * axis.p11) + q * dt2 * dt / 3.0f;
+    float p01 = axis.p01 + dt * axis.p11 + q * dt2 / 2.0f;
+    float p11 = axis.p11 + q * dt;
+
+    // Update with a position measurement (H = [1 0])
+    float s = p00 + config_.measurement_noise;
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+    axis.position = predicted + k0 * residual;
+    axis.velocity = clampVelocity(axis.velocity + k1 * residual);
+    axis.p00 = (1.0f - k0) * p00;
+    axis.p01 = (1.0f - k0) * p01;
+    axis.p11 = p11 - k1 * p01;
+}
+
+bool TargetPredictor::update(float pan_angle, float tilt_angle, uint64_t timestamp_ns) {
+    // Negated comparison rejects NaN as well
+    if (!(pan_angle == pan_angle && tilt_angle == tilt_angle)) {
+        return false;
+    }
+    if (samples_ > 0 && timestamp_ns <= last_ns_) {
+        return false;
+    }
+
+    if (samples_ == 0 || timestamp_ns - last_ns_ >= config_.reset_gap_ns) {
+        start(pan_, pan_angle);
+        start(tilt_, tilt_angle);
+        last_ns_ = timestamp_ns;
+        samples_ = 1;
+        return true;
+    }
+
+    float dt = static_cast<float>(timestamp_ns - last_ns_) * NANOS_TO_SECONDS;
+    updateAxis(pan_, pan_angle, dt);
+    updateAxis(tilt_, tilt_angle, dt);
+    last_ns_ = timestamp_ns;
+    if (samples_ < UINT32_MAX) {
+        ++samples_;
+    }
+    return true;
+}
+
+bool TargetPredictor::predict(uint64_t command_ns, float& pan_angle, float& tilt_angle) const {
+    if (samples_ == 0) {
+        return false;
+    }
+
+    uint64_t target_ns = command_ns + getLeadTime();
+    float horizon = target_ns > last_ns_ ? static_cast<float>(target_ns - last_ns_) * NANOS_TO_SECONDS : 0.0f;
+    if (horizon > config_.max_extrapolation_s) {
+        horizon = config_.max_extrapolation_s;
+    }
+
+    pan_angle = pan_.position + pan_.velocity * horizon;
+    tilt_angle = tilt_.position + tilt_.velocity * horizon;
+    return true;
+}
+
+bool TargetPredictor::isHorizonExceeded(uint64_t command_ns) const {
+    uint64_t target_ns = command_ns + getLeadTime();
+    return target_ns > last_ns_ &&
+           static_cast<float>(target_ns - last_ns_) * NANOS_TO_SECONDS >= config_.max_extrapolation_s;
+}
@@ -0,0 +1,173 @@
+#include "TelemetryRing.h"
+#include "GimbalLog.h"
+#include "GimbalStatus.h"
+
+#ifdef PICO_BUILD
+#include "pico/time.h"
+#else
+#include <cstdio>
+#include <vector>
+#include <time.h>
+#endif
+
+TelemetryRing::TelemetryRing() : head_(0), anchor_ns_(now()), anchor_ticks_(ticks()) {
+    for (auto& slot : slots_) {
+        for (auto& word : slot.words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+double TelemetryRing::nanosPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+    // No architectural TSC frequency: measure it against the monotonic
+    // clock since construction
+    uint64_t elapsed_ticks = ticks() - anchor_ticks_;
+    uint64_t elapsed_ns = now() - anchor_ns_;
+    return elapsed_ticks > 0 ? static_cast<double>(elapsed_ns) / static_cast<double>(elapsed_ticks) : 1.0;
+#elif defined(__aarch64__)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency > 0 ? 1e9 / static_cast<double>(frequency) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+size_t TelemetryRing::snapshot(TelemetryRecord* out, size_t max) const {
+    if (!out) {
+        return 0;
+    }
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t count = head < CAPACITY ? head : CAPACITY;
+    if (count > max) {
+        count = max;
+    }
+    uint64_t first = head - count;
+
+    for (uint64_t i = 0; i < count; ++i) {
+        const std::atomic<uint64_t>* slot = slots_[(first + i) & (CAPACITY - 1)].words;
+        uint64_t words[WORDS];
+        for (size_t w = 0; w < WORDS; ++w) {
+            words[w] = slot[w].load(std::memory_order_relaxed);
+        }
+        std::memcpy(&out[i], words, sizeof(TelemetryRecord));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // The writer may have lapped the copy: record `after` is being written
+    // over the slot of record after - CAPACITY, so anything older is suspect
+    uint64_t after = head_.load(std::memory_order_relaxed);
+    uint64_t valid_from = after + 1 > CAPACITY ? after + 1 - CAPACITY : 0;
+    if (first < valid_from) {
+        uint64_t stale = valid_from - first;
+        if (stale >= count) {
+            return 0;
+        }
+        std::memmove(out, out + stale, static_cast<size_t>(count - stale) * sizeof(TelemetryRecord));
+        count -= stale;
+    }
+
+    double ns_per_tick = nanosPerTick();
+    for (uint64_t i = 0; i < count; ++i) {
+        int64_t since_anchor = static_cast<int64_t>(out[i].timestamp_ns - anchor_ticks_);
+        out[i].timestamp_ns = anchor_ns_ + static_cast<uint64_t>(static_cast<double>(since_anchor) * ns_per_tick);
+        double driver_ns = static_cast<double>(out[i].driver_ns) * ns_per_tick;
+        out[i].driver_ns = driver_ns < 4294967295.0 ? static_cast<uint32_t>(driver_ns) : UINT32_MAX;
+    }
+    return static_cast<size_t>(count);
+}
+
+void TelemetryRing::clear() {
+    head_.store(0, std::memory_order_release);
+}
+
+uint64_t TelemetryRing::now() {
+#ifdef PICO_BUILD
+    return time_us_64() * 1000;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+#ifndef PICO_BUILD
+namespace {
+
+constexpr char MAGIC[4] = {'G', 'T', 'E', 'L'};
+
+} // namespace
+
+bool TelemetryRing::writeChromeTrace(const char* path, const char* process_name) const {
+    std::vector<TelemetryRecord> records(CAPACITY);
+    size_t count = snapshot(records.data(), records.size());
+
+    FILE* file = std::fopen(path, "w");
+    if (!file) {
+        GIMBAL_LOG_ERROR("Telemetry: cannot create %s", path);
+        return false;
+    }
+
+    // Trace timestamps are microseconds; keep ns resolution in the fraction
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"%s\"}}",
+                 process_name ? process_name : "gimbal");
+    for (size_t i = 0; i < count; ++i) {
+        const TelemetryRecord& r = records[i];
+        double ts = static_cast<double>(r.timestamp_ns) / 1000.0;
+        std::fprintf(file, ",\n{\"name\":\"angle\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,"
+                     "\"args\":{\"pan\":%.3f,\"tilt\":%.3f}}",
+                     ts, r.pan_angle, r.tilt_angle);
+        std::fprintf(file, ",\n{\"name\":\"pulse_us\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,"
+                     "\"args\":{\"pan\":%u,\"tilt\":%u}}",
+                     ts, static_cast<unsigned>(r.pan_pulse_us), static_cast<unsigned>(r.tilt_pulse_us));
+        if (r.writes != 0) {
+            std::fprintf(file, ",\n{\"name\":\"setPulseWidths\",\"cat\":\"pwm\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                         "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"pan\":%s,\"tilt\":%s}}",
+                         ts, static_cast<double>(r.driver_ns) / 1000.0,
+                         (r.writes & WROTE_PAN) ? "true" : "false",
+                         (r.writes & WROTE_TILT) ? "true" : "false");
+        }
+        if (r.error != 0) {
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"error\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,"
+                         "\"ts\":%.3f}",
+                         gimbalErrorName(static_cast<GimbalError>(r.error)), ts);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool ok = std::ferror(file) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        GIMBAL_LOG_ERROR("Telemetry: failed to write %s", path);
+    }
+    return ok;
+}
+
+bool TelemetryRing::writeBinary(const char* path) const {
+    std::vector<TelemetryRecord> records(CAPACITY);
+    size_t count = snapshot(records.data(), records.size());
+    uint64_t total = head_.load(std::memory_order_acquire);
+
+    TelemetryFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.record_size = sizeof(TelemetryRecord);
+    header.count = count;
+    header.overwritten = total > count ? total - count : 0;
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        GIMBAL_LOG_ERROR("Telemetry: cannot create %s", path);
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (count == 0 || std::fwrite(records.data(), sizeof(TelemetryRecord), count, file) == count);
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        GIMBAL_LOG_ERROR("Telemetry: failed to write %s", path);
+    }
+    return ok;
+}
+#endif
@@ -0,0 +1,132 @@
+#include "TrajectoryFile.h"
+#include "GimbalLog.h"
+#include <cstring>
+
+#ifndef PICO_BUILD
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'G', 'T', 'R', 'J'};
+
+} // namespace
+
+TrajectoryFile::TrajectoryFile()
+    : records_(nullptr), count_(0), duration_us_(0), mapping_(nullptr), mapping_size_(0) {
+}
+
+TrajectoryFile::~TrajectoryFile() {
+    close();
+}
+
+bool TrajectoryFile::attach(const void* data, size_t size) {
+    close();
+
+    if (!data || size < sizeof(TrajectoryHeader) || reinterpret_cast<uintptr_t>(data) % alignof(TrajectoryRecord) != 0) {
+        return false;
+    }
+    const TrajectoryHeader* header = static_cast<const TrajectoryHeader*>(data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->record_size != sizeof(TrajectoryRecord) || header->count == 0) {
+        GIMBAL_LOG_ERROR("Trajectory: not a version %u trajectory image", static_cast<unsigned>(VERSION));
+        return false;
+    }
+    if (header->count > (size - sizeof(TrajectoryHeader)) / sizeof(TrajectoryRecord)) {
+        GIMBAL_LOG_ERROR("Trajectory: truncated (%llu records declared)",
+                         static_cast<unsigned long long>(header->count));
+        return false;
+    }
+
+    records_ = reinterpret_cast<const TrajectoryRecord*>(header + 1);
+    count_ = static_cast<size_t>(header->count);
+    duration_us_ = header->duration_us;
+    return true;
+}
+
+void TrajectoryFile::close() {
+#ifndef PICO_BUILD
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+#endif
+    records_ = nullptr;
+    count_ = 0;
+    duration_us_ = 0;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+}
+
+#ifndef PICO_BUILD
+bool TrajectoryFile::open(const char* path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        GIMBAL_LOG_ERROR("Trajectory: cannot open %s", path);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(TrajectoryHeader))) {
+        GIMBAL_LOG_ERROR("Trajectory: %s is too small", path);
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        GIMBAL_LOG_ERROR("Trajectory: cannot map %s", path);
+        return false;
+    }
+    // Playback walks the records in order; let the kernel read ahead
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    if (!attach(mapping, size)) {
+        munmap(mapping, size);
+        return false;
+    }
+    mapping_ = mapping;
+    mapping_size_ = size;
+    GIMBAL_LOG_INFO("Trajectory: mapped %s (%llu points, %.3f s)", path,
+                    static_cast<unsigned long long>(count_), static_cast<double>(duration_us_) / 1e6);
+    return true;
+}
+
+bool TrajectoryFile::write(const char* path, const TrajectoryRecord* records, size_t count) {
+    if (!records || count == 0) {
+        return false;
+    }
+    for (size_t i = 1; i < count; ++i) {
+        if (records[i].time_us < records[i - 1].time_us) {
+            GIMBAL_LOG_ERROR("Trajectory: point %u goes back in time", static_cast<unsigned>(i));
+            return false;
+        }
+    }
+
+    TrajectoryHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.record_size = sizeof(TrajectoryRecord);
+    header.count = count;
+    header.duration_us = records[count - 1].time_us - records[0].time_us;
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        GIMBAL_LOG_ERROR("Trajectory: cannot create %s", path);
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(records, sizeof(TrajectoryRecord), count, file) == count;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        GIMBAL_LOG_ERROR("Trajectory: failed to write %s", path);
+    }
+    return ok;
+}
+#endif
@@ -0,0 +1,189 @@
+#include "TrajectoryPlayer.h"
+#include "GimbalLog.h"
+
+#ifdef PICO_BUILD
+#include "pico/time.h"
+#else
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace {
+
+constexpr uint32_t SCALE_ONE_Q16 = 65536;
+
+/// Forward steps tried before falling back to a binary search
+constexpr size_t LINEAR_SCAN_LIMIT = 8;
+
+void sleepUntil(uint64_t deadline_ns) {
+#ifdef PICO_BUILD
+    sleep_until(from_us_since_boot(deadline_ns / 1000));
+#else
+    timespec wake;
+    wake.tv_sec = static_cast<time_t>(deadline_ns / 1000000000);
+    wake.tv_nsec = static_cast<long>(deadline_ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR) {
+    }
+#endif
+}
+
+} // namespace
+
+TrajectoryPlayer::TrajectoryPlayer(const TrajectoryFile& trajectory)
+    : trajectory_(trajectory), loop_(false), scale_q16_(SCALE_ONE_Q16), anchor_ns_(0), anchor_us_(0), cursor_(0) {
+}
+
+uint64_t TrajectoryPlayer::now() {
+#ifdef PICO_BUILD
+    return time_us_64() * 1000;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+bool TrajectoryPlayer::setTimeScale(float scale, uint64_t now_ns) {
+    // Negated comparison rejects NaN as well
+    if (!(scale > 0.0f && scale <= 1000.0f)) {
+        return false;
+    }
+    anchor_us_ = getPosition(now_ns);
+    anchor_ns_ = now_ns;
+    scale_q16_ = static_cast<uint32_t>(scale * static_cast<float>(SCALE_ONE_Q16) + 0.5f);
+    if (scale_q16_ == 0) {
+        scale_q16_ = 1;
+    }
+    return true;
+}
+
+float TrajectoryPlayer::getTimeScale() const {
+    return static_cast<float>(scale_q16_) / static_cast<float>(SCALE_ONE_Q16);
+}
+
+void TrajectoryPlayer::start(uint64_t now_ns) {
+    anchor_ns_ = now_ns;
+}
+
+void TrajectoryPlayer::seek(uint64_t position_us, uint64_t now_ns) {
+    uint64_t duration = trajectory_.getDuration();
+    anchor_us_ = position_us < duration ? position_us : duration;
+    anchor_ns_ = now_ns;
+}
+
+uint64_t TrajectoryPlayer::getPosition(uint64_t now_ns) const {
+    uint64_t position = anchor_us_;
+    if (now_ns > anchor_ns_) {
+        uint64_t elapsed_us = (now_ns - anchor_ns_) / 1000;
+        position += (elapsed_us * scale_q16_) >> 16;
+    }
+
+    uint64_t duration = trajectory_.getDuration();
+    if (position <= duration) {
+        return position;
+    }
+    return (loop_ && duration > 0) ? position % duration : duration;
+}
+
+size_t TrajectoryPlayer::locate(uint64_t time_us) {
+    const TrajectoryRecord* records = trajectory_.records();
+    const size_t count = trajectory_.size();
+    if (count == 0) {
+        cursor_ = 0;
+        return 0;
+    }
+    // The file may have been reopened with a shorter track
+    if (cursor_ >= count) {
+        cursor_ = 0;
+    }
+
+    // Sequential playback moves the cursor by a record or two per frame
+    if (records[cursor_].time_us <= time_us) {
+        for (size_t step = 0; step < LINEAR_SCAN_LIMIT; ++step) {
+            if (cursor_ + 1 >= count || records[cursor_ + 1].time_us > time_us) {
+                return cursor_;
+            }
+            ++cursor_;
+        }
+    }
+
+    // Seek or loop: last record at or before time_us
+    size_t low = 0;
+    size_t high = count;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (records[mid].time_us <= time_us) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    cursor_ = low;
+    return cursor_;
+}
+
+bool TrajectoryPlayer::sample(uint64_t now_ns, float& pan_angle, float& tilt_angle) {
+    if (!trajectory_.isOpen() || trajectory_.size() == 0) {
+        return false;
+    }
+
+    const TrajectoryRecord* records = trajectory_.records();
+    const size_t count = trajectory_.size();
+    uint64_t position = getPosition(now_ns);
+    uint64_t time_us = records[0].time_us + position;
+
+    size_t index = locate(time_us);
+    const TrajectoryRecord& a = records[index];
+    if (index + 1 >= count || records[index + 1].time_us <= a.time_us) {
+        pan_angle = a.pan_angle;
+        tilt_angle = a.tilt_angle;
+    } else {
+        const TrajectoryRecord& b = records[index + 1];
+        float f = static_cast<float>(time_us - a.time_us) / static_cast<float>(b.time_us - a.time_us);
+        pan_angle = a.pan_angle + (b.pan_angle - a.pan_angle) * f;
+        tilt_angle = a.tilt_angle + (b.tilt_angle - a.tilt_angle) * f;
+    }
+
+    return loop_ || position < trajectory_.getDuration();
+}
+
+bool TrajectoryPlayer::play(Gimbal& gimbal, uint32_t rate_hz, const std::atomic<bool>* stop) {
+    if (rate_hz == 0) {
+        rate_hz = gimbal.getFrameRate();
+    }
+    if (!trajectory_.isOpen() || trajectory_.size() == 0 || rate_hz == 0) {
+        return false;
+    }
+
+    const uint64_t period_ns = 1000000000ull / rate_hz;
+    uint64_t deadline = now();
+    start(deadline);
+
+    bool ok = true;
+    uint64_t skipped = 0;
+    while (!stop || !stop->load(std::memory_order_relaxed)) {
+        float pan_angle;
+        float tilt_angle;
+        // Sample at the deadline, not the wake-up time, so wake-up jitter
+        // does not show up in the commanded path
+        bool more = sample(deadline, pan_angle, tilt_angle);
+        ok = gimbal.setTipAngle(pan_angle, tilt_angle) && ok;
+        if (!more) {
+            break;
+        }
+
+        deadline += period_ns;
+        uint64_t current = now();
+        if (current > deadline) {
+            uint64_t missed = (current - deadline) / period_ns + 1;
+            skipped += missed;
+            deadline += missed * period_ns;
+        }
+        sleepUntil(deadline);
+    }
+
+    if (skipped > 0) {
+        GIMBAL_LOG_WARNING("Trajectory: skipped %llu overrun frames", static_cast<unsigned long long>(skipped));
+    }
+    return ok;
+}